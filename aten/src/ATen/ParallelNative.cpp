@@ -2,6 +2,7 @@
 #if AT_PARALLEL_NATIVE
 #include <ATen/Parallel.h>
 #include <ATen/PTThreadPool.h>
+#include <ATen/ThreadLocalState.h>
 
 #ifndef C10_MOBILE
 #include <c10/core/thread_pool.h>
@@ -136,12 +137,26 @@ void _parallel_run(
     std::condition_variable cv;
   } state;
 
-  auto task = [f, &state, begin, end, chunk_size]
+  // Pool threads don't inherit the caller's thread local state. It is only
+  // needed there by thread local RecordFunction callbacks (e.g. the profiler),
+  // so it is only propagated when there are some.
+  c10::optional<ThreadLocalState> thread_locals;
+  if (at::hasThreadLocalCallbacks()) {
+    thread_locals.emplace();
+  }
+
+  auto task = [f, &state, &thread_locals, begin, end, chunk_size]
       (int /* unused */, size_t task_id) {
     int64_t local_start = begin + task_id * chunk_size;
     if (local_start < end) {
       int64_t local_end = std::min(end, (int64_t)(chunk_size + local_start));
       try {
+        c10::optional<ThreadLocalStateGuard> tls_guard;
+        if (thread_locals) {
+          tls_guard.emplace(*thread_locals);
+        }
+        RECORD_FUNCTION_WITH_SCOPE(
+            at::RecordScope::INTRAOP_TASK, "at::parallel_for", {});
         ParallelRegionGuard guard(task_id);
         f(local_start, local_end, task_id);
       } catch (...) {
@@ -82,6 +82,8 @@ void launch(std::function<void()> func) {
   internal::launch_no_thread_state(std::bind([](
     std::function<void()> f, ThreadLocalState thread_locals) {
       ThreadLocalStateGuard guard(std::move(thread_locals));
+      RECORD_FUNCTION_WITH_SCOPE(
+          at::RecordScope::INTEROP_TASK, "at::launch", {});
       f();
     },
     std::move(func),
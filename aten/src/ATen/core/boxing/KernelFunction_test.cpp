@@ -169,6 +169,31 @@ TEST(KernelFunctionTest, givenBoxedFunction_withoutReturn_whenCallingUnboxed_the
   kernels::expectUnboxedCallingWithoutReturnWorks(func);
 }
 
+// Calls itself through the unboxed API until the first argument is 0, to
+// check that the stacks of nested unboxed calls to boxed kernels don't share
+// their buffers.
+void boxed_func_calling_itself(const OperatorHandle& opHandle, Stack* stack) {
+  EXPECT_EQ(2, stack->size());
+  int64_t depth = stack->at(0).toInt();
+  int64_t sum = stack->at(1).toInt();
+  if (depth > 0) {
+    KernelFunction self = KernelFunction::makeFromBoxedFunction<&boxed_func_calling_itself>();
+    sum = self.call<int64_t, int64_t, int64_t>(opHandle, depth - 1, sum + depth);
+    EXPECT_EQ(2, stack->size());
+    EXPECT_EQ(depth, stack->at(0).toInt());
+  }
+  stack->clear();
+  stack->push_back(sum);
+}
+
+TEST(KernelFunctionTest, givenBoxedFunction_whenCallingUnboxedRecursively_thenWorks) {
+  KernelFunction func = KernelFunction::makeFromBoxedFunction<&boxed_func_calling_itself>();
+  OperatorHandle dummy = kernels::makeDummyOperatorHandle();
+  // deeper than the number of stacks kept per thread
+  EXPECT_EQ(20 * 21 / 2, (func.call<int64_t, int64_t, int64_t>(dummy, 20, 0)));
+  EXPECT_EQ(3 * 4 / 2, (func.call<int64_t, int64_t, int64_t>(dummy, 3, 0)));
+}
+
 TEST(KernelFunctionTest, givenUnboxedFunctor_withReturn_whenCallingBoxed_thenWorks) {
   KernelFunction func = KernelFunction::makeFromUnboxedFunctor<false, kernels::unboxed_functor_with_return>(std::unique_ptr<OperatorKernel>(std::make_unique<kernels::unboxed_functor_with_return>()));
   kernels::expectBoxedCallingWithReturnWorks(func);
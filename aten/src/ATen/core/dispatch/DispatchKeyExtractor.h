@@ -17,6 +17,18 @@ namespace impl {
 // always_included to get inlined, constexpr not necessary)
 const DispatchKeySet always_included{DispatchKey::Autograd, DispatchKey::BackendSelect};
 
+// Apply the TLS included and excluded sets to the DispatchKeySet of the
+// arguments of a call.
+static inline DispatchKeySet computeDispatchKeySet(DispatchKeySet ks) {
+  c10::impl::LocalDispatchKeySet local = c10::impl::tls_local_dispatch_key_set();
+  // TODO: It's a bit irritating that we have to do logical ORs here, it would
+  // be nice to only do one.  Can always_included be folded into the TLS?  Well,
+  // it's a bit troublesome, because fastpath TLS access requires the type of
+  // the TLS in question to be zero-initialized, so you don't actually win
+  // anyting in that case.
+  return (ks | local.included_ | always_included) - local.excluded_;
+}
+
 // Take a DispatchKeySet for a Tensor and determine what the actual dispatch
 // DispatchKey should be, taking into account TLS, and skipping backends which
 // fall through.
@@ -40,13 +52,7 @@ static inline DispatchKey dispatchTypeId(
     // function (as opposed to just applying it to the input 'ks').
     DispatchKeySet key_mask
 ) {
-  c10::impl::LocalDispatchKeySet local = c10::impl::tls_local_dispatch_key_set();
-  // TODO: It's a bit irritating that we have to do logical ORs here, it would
-  // be nice to only do one.  Can always_included be folded into the TLS?  Well,
-  // it's a bit troublesome, because fastpath TLS access requires the type of
-  // the TLS in question to be zero-initialized, so you don't actually win
-  // anyting in that case.
-  return (((ks | local.included_ | always_included) - local.excluded_) & key_mask).highestPriorityTypeId();
+  return (computeDispatchKeySet(ks) & key_mask).highestPriorityTypeId();
 }
 
 }
@@ -120,6 +126,18 @@ public:
   }
 
   DispatchKey getDispatchKeyBoxed(DispatchKeySet backendsWithoutFallthrough, const torch::jit::Stack* stack) const {
+    return dispatchKeySetToDispatchKey_(backendsWithoutFallthrough, DispatchKeySet::FULL, getDispatchKeySetBoxed(stack));
+  }
+
+  template<class... Args>
+  DispatchKey getDispatchKeyUnboxed(DispatchKeySet backendsWithoutFallthrough, DispatchKeySet eligibleKeys, const Args&... args) const {
+    auto ks = detail::multi_dispatch_key_set(args...);
+    return dispatchKeySetToDispatchKey_(backendsWithoutFallthrough, eligibleKeys, ks);
+  }
+
+  // The DispatchKeySet of the arguments, before TLS is applied. Used by the
+  // dispatcher's cache, which is keyed on it (see Dispatcher::dispatchCached_).
+  DispatchKeySet getDispatchKeySetBoxed(const torch::jit::Stack* stack) const {
     DispatchKeySet ks;
     dispatch_arg_indices_reverse_.for_each_set_bit([&] (size_t reverse_arg_index) {
       const auto& ivalue = torch::jit::peek(*stack, 0, reverse_arg_index + 1);
@@ -133,13 +151,18 @@ public:
         }
       }
     });
-    return dispatchKeySetToDispatchKey_(backendsWithoutFallthrough, DispatchKeySet::FULL, ks);
+    return ks;
   }
 
   template<class... Args>
-  DispatchKey getDispatchKeyUnboxed(DispatchKeySet backendsWithoutFallthrough, DispatchKeySet eligibleKeys, const Args&... args) const {
-    auto ks = detail::multi_dispatch_key_set(args...);
-    return dispatchKeySetToDispatchKey_(backendsWithoutFallthrough, eligibleKeys, ks);
+  DispatchKeySet getDispatchKeySetUnboxed(const Args&... args) const {
+    return detail::multi_dispatch_key_set(args...);
+  }
+
+  // Resolves a DispatchKeySet impl::computeDispatchKeySet was already
+  // applied to.
+  DispatchKey getDispatchKeyFromComputedKeySet(DispatchKeySet backendsWithoutFallthrough, DispatchKeySet ks) const {
+    return (ks & dispatchKeyMask_(backendsWithoutFallthrough, DispatchKeySet::FULL)).highestPriorityTypeId();
   }
 
   // Used by DispatchTable to maintain the fallthrough invariant, see
@@ -171,7 +194,14 @@ private:
       DispatchKeySet eligibleKeys,
       DispatchKeySet ks
   ) const {
-    return impl::dispatchTypeId(ks,
+    return impl::dispatchTypeId(ks, dispatchKeyMask_(backendsWithoutFallthrough, eligibleKeys));
+  }
+
+  DispatchKeySet dispatchKeyMask_(
+      DispatchKeySet backendsWithoutFallthrough,
+      DispatchKeySet eligibleKeys
+  ) const {
+    return
       // We must NOT respect the passed in backendsWithoutFallthrough if an operator has
       // specifically overridden the backend, since that means we've opted to
       // not fallthrough and instead apply some specific behavior (which we
@@ -184,7 +214,7 @@ private:
         ((backendsWithoutFallthrough | operatorHasKernelForBackend_) - operatorHasFallthroughForBackend_)
       // Regardless of fallthrough behavior, only accept keys which are eligible
       // for dispatch, as requested by the user
-      & eligibleKeys);
+      & eligibleKeys;
   }
 
   explicit DispatchKeyExtractor(c10::utils::bitset dispatch_arg_indices_reverse)
@@ -5,6 +5,8 @@
 namespace c10 {
 
 namespace impl {
+  std::atomic<uint64_t> DispatchCache::epoch_{1};
+
   std::string KernelFunctionTable::dumpState() const {
     std::ostringstream oss;
     for (uint8_t i = 0; i < static_cast<uint8_t>(DispatchKey::NumDispatchKeys); i++) {
@@ -67,6 +67,95 @@ private:
   std::array<KernelFunction, static_cast<uint8_t>(DispatchKey::NumDispatchKeys)> kernels_;
   size_t kernelCount_;
 };
+
+/**
+ * A small inline cache in front of the dispatch key computation and the
+ * dispatch table lookup of an operator.
+ *
+ * It maps the dispatch key set of a call, after the TLS included and excluded
+ * sets were applied, to the KernelFunction that call resolved to. Everything
+ * else the resolution depends on (the kernels and fallthroughs registered for
+ * the operator, and the backend fallbacks) only changes on registration, so
+ * instead of tracking it per operator, any registration bumps a global epoch
+ * which invalidates all the caches.
+ *
+ * The cache is direct mapped with kNumEntries entries. Each entry is a seqlock,
+ * so that lookups don't take a lock or write to shared memory: a lookup that
+ * races with an update just misses. Updates that race with another update are
+ * dropped.
+ */
+class CAFFE2_API DispatchCache final {
+public:
+  static constexpr size_t kNumEntries = 2;
+
+  DispatchCache() = default;
+  DispatchCache(const DispatchCache&) = delete;
+  DispatchCache& operator=(const DispatchCache&) = delete;
+
+  // Returns the kernel a call with this (TLS applied) key set resolved to
+  // last time, or nullptr if it isn't cached.
+  const KernelFunction* lookup(DispatchKeySet ks) const {
+    const Entry& entry = entries_[index(ks)];
+    uint64_t seq = entry.seq.load(std::memory_order_acquire);
+    if (seq & 1) {
+      return nullptr;
+    }
+    uint64_t key = entry.key.load(std::memory_order_relaxed);
+    uint64_t epoch = entry.epoch.load(std::memory_order_relaxed);
+    const KernelFunction* kernel = entry.kernel.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (entry.seq.load(std::memory_order_relaxed) != seq ||
+        key != ks.raw_repr() ||
+        epoch != epoch_.load(std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return kernel;
+  }
+
+  // `epoch` must have been read (with epoch()) before `kernel` was resolved,
+  // so that a registration racing with the resolution leaves a stale entry.
+  void update(DispatchKeySet ks, const KernelFunction* kernel, uint64_t epoch) const {
+    Entry& entry = entries_[index(ks)];
+    uint64_t seq = entry.seq.load(std::memory_order_relaxed);
+    if ((seq & 1) || !entry.seq.compare_exchange_strong(seq, seq + 1, std::memory_order_acquire)) {
+      return;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    entry.key.store(ks.raw_repr(), std::memory_order_relaxed);
+    entry.epoch.store(epoch, std::memory_order_relaxed);
+    entry.kernel.store(kernel, std::memory_order_relaxed);
+    entry.seq.store(seq + 2, std::memory_order_release);
+  }
+
+  static uint64_t epoch() {
+    return epoch_.load(std::memory_order_acquire);
+  }
+
+  // Called whenever a kernel, catch-all kernel or backend fallback is
+  // registered or deregistered, once the kernel tables and the dispatch key
+  // extractor have been updated: a lookup that reads the new epoch must see
+  // the new state, or the kernel it resolves stays cached for good.
+  static void invalidateAll() {
+    epoch_.fetch_add(1, std::memory_order_acq_rel);
+  }
+
+private:
+  struct Entry final {
+    std::atomic<uint64_t> seq{0};
+    // epoch 0 is never current, so that empty entries never match
+    std::atomic<uint64_t> epoch{0};
+    std::atomic<uint64_t> key{0};
+    std::atomic<const KernelFunction*> kernel{nullptr};
+  };
+
+  static size_t index(DispatchKeySet ks) {
+    // Multiplicative hashing, so that every bit of the key set matters
+    return static_cast<size_t>((ks.raw_repr() * 0x9E3779B97F4A7C15ull) >> 32) % kNumEntries;
+  }
+
+  mutable std::array<Entry, kNumEntries> entries_;
+  static std::atomic<uint64_t> epoch_;
+};
 }
 
 /**
@@ -109,6 +198,7 @@ class DispatchTable final {
     if (kernel.isFallthrough()) {
       dispatchKeyExtractor_.setOperatorHasFallthroughForBackend(dispatchKey, true);
     }
+    impl::DispatchCache::invalidateAll();
   }
 
   /**
@@ -120,6 +210,7 @@ class DispatchTable final {
     kernels_.removeKernelIfExists(dispatchKey);
     dispatchKeyExtractor_.setOperatorHasKernelForBackend(dispatchKey, false);
     dispatchKeyExtractor_.setOperatorHasFallthroughForBackend(dispatchKey, false); // may be no op
+    impl::DispatchCache::invalidateAll();
   }
 
   /**
@@ -133,6 +224,7 @@ class DispatchTable final {
       kernel.setManuallyBoxedKernel_(*manuallyBoxedKernel_);
     }
     catchallKernel_ = std::move(kernel);
+    impl::DispatchCache::invalidateAll();
   }
 
   /**
@@ -140,6 +232,7 @@ class DispatchTable final {
    */
   void removeCatchallKernel() {
     catchallKernel_ = {};
+    impl::DispatchCache::invalidateAll();
   }
 
   bool isEmpty() const {
@@ -199,12 +292,19 @@ class DispatchTable final {
     return operatorName_;
   }
 
+  // See Dispatcher::dispatchCached_
+  const impl::DispatchCache& cache() const {
+    return cache_;
+  }
+
   void registerSchema(const FunctionSchema& schema) {
     dispatchKeyExtractor_.registerSchema(schema);
+    impl::DispatchCache::invalidateAll();
   }
 
   void deregisterSchema() {
     dispatchKeyExtractor_.deregisterSchema();
+    impl::DispatchCache::invalidateAll();
   }
 
   std::string dumpState() const;
@@ -236,6 +336,7 @@ private:
   KernelFunction catchallKernel_;
   DispatchKeyExtractor dispatchKeyExtractor_;
   OperatorName operatorName_;
+  impl::DispatchCache cache_;
 
   // This manuallyBoxedKernel_ member is a temporary hack that allows generated_unboxing_wrappers.cpp to register its codegen'ed
   // unboxing wrapper for aten operators. We still need those for some operators because not all work
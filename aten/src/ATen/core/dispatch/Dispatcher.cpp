@@ -267,6 +267,7 @@ RegistrationHandleRAII Dispatcher::registerFallback(DispatchKey dispatchKey, Ker
   if (kernel.isFallthrough()) {
     backendsWithoutFallthrough_ = backendsWithoutFallthrough_.remove(dispatchKey);
   }
+  impl::DispatchCache::invalidateAll();
 
   return RegistrationHandleRAII([this, dispatchKey] {
     deregisterFallback_(dispatchKey);
@@ -278,6 +279,17 @@ void Dispatcher::deregisterFallback_(DispatchKey dispatchKey) {
 
   backendFallbackKernels_.removeKernelIfExists(dispatchKey);
   backendsWithoutFallthrough_ = backendsWithoutFallthrough_.add(dispatchKey);
+  impl::DispatchCache::invalidateAll();
+}
+
+const KernelFunction& Dispatcher::dispatchAndCache_(const DispatchTable& dispatchTable, DispatchKeySet ks) const {
+  // Read the epoch first, so that if a registration happens while we resolve
+  // the kernel, the entry we add is already stale.
+  auto epoch = impl::DispatchCache::epoch();
+  auto dispatchKey = dispatchTable.dispatchKeyExtractor().getDispatchKeyFromComputedKeySet(backendsWithoutFallthrough_, ks);
+  const KernelFunction& kernel = dispatch_(dispatchTable, dispatchKey);
+  dispatchTable.cache().update(ks, &kernel, epoch);
+  return kernel;
 }
 
 
@@ -216,6 +216,12 @@ private:
   [[noreturn]] static void reportError(const DispatchTable& dispatchTable, DispatchKey dispatchKey);
 
   const KernelFunction& dispatch_(const DispatchTable& dispatchTable, DispatchKey dispatch_key) const;
+  // Like dispatch_, but for the DispatchKeySet of the arguments of a call, and
+  // going through the cache of the operator: while the TLS and the argument key
+  // sets of the calls stay the same, the dispatch key computation and the
+  // kernel lookup are skipped.
+  const KernelFunction& dispatchCached_(const DispatchTable& dispatchTable, DispatchKeySet ks) const;
+  const KernelFunction& dispatchAndCache_(const DispatchTable& dispatchTable, DispatchKeySet ks) const;
 
   std::list<OperatorDef> operators_;
   LeftRight<ska::flat_hash_map<OperatorName, OperatorHandle>> operatorLookupTable_;
@@ -333,8 +339,9 @@ template<class Return, class... Args>
 inline Return Dispatcher::call(const TypedOperatorHandle<Return(Args...)>& op, Args... args) const {
   detail::unused_arg_(args...);  // workaround for a false-positive warning about unused parameters in gcc 5
   const auto& dispatchTable = op.operatorIterator_->op.dispatch_table();
-  auto dispatchKey = dispatchTable.dispatchKeyExtractor().template getDispatchKeyUnboxed<Args...>(backendsWithoutFallthrough_, DispatchKeySet::FULL, args...);
-  return callWithDispatchKey<Return, Args...>(op, dispatchKey, args...);
+  auto ks = dispatchTable.dispatchKeyExtractor().template getDispatchKeySetUnboxed<Args...>(args...);
+  const KernelFunction& kernel = dispatchCached_(dispatchTable, ks);
+  return kernel.template call<Return, Args...>(op, std::forward<Args>(args)...);
 }
 
 template<class Return, class... Args>
@@ -352,11 +359,20 @@ inline Return Dispatcher::redispatch(const TypedOperatorHandle<Return (Args...)>
 inline void Dispatcher::callBoxed(const OperatorHandle& op, Stack* stack) const {
   // note: this doesn't need the mutex because write operations on the list keep iterators intact.
   const auto& dispatchTable = op.operatorIterator_->op.dispatch_table();
-  auto dispatchKey = dispatchTable.dispatchKeyExtractor().getDispatchKeyBoxed(backendsWithoutFallthrough_, stack);
-  const KernelFunction& kernel = dispatch_(dispatchTable, dispatchKey);
+  auto ks = dispatchTable.dispatchKeyExtractor().getDispatchKeySetBoxed(stack);
+  const KernelFunction& kernel = dispatchCached_(dispatchTable, ks);
   kernel.callBoxed(op, stack);
 }
 
+inline const KernelFunction& Dispatcher::dispatchCached_(const DispatchTable& dispatchTable, DispatchKeySet ks) const {
+  ks = impl::computeDispatchKeySet(ks);
+  const KernelFunction* cachedKernel = dispatchTable.cache().lookup(ks);
+  if (C10_LIKELY(nullptr != cachedKernel)) {
+    return *cachedKernel;
+  }
+  return dispatchAndCache_(dispatchTable, ks);
+}
+
 inline const KernelFunction& Dispatcher::dispatch_(const DispatchTable& dispatchTable, DispatchKey dispatchKey) const {
   const KernelFunction* backendKernel = dispatchTable.lookup(dispatchKey);
 
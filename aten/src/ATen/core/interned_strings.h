@@ -96,6 +96,9 @@ namespace c10 {
   _(prim, ConstantChunk)             \
   _(prim, MMTreeReduce)              \
   _(prim, MMBatchSide)               \
+  _(prim, MMBatchIndependent)        \
+  _(prim, MemoryPlanArena)           \
+  _(prim, MemoryPlanSlot)            \
   _(prim, min)                       \
   _(prim, max)                       \
   _(prim, abs)                       \
@@ -270,6 +273,7 @@ namespace c10 {
   _(attr, types)                     \
   _(attr, scope)                     \
   _(attr, keepdims)                  \
+  _(attr, scalar_type)               \
   _(attr, cache_id)                  \
   _(attr, new_axis)
 #else
@@ -229,6 +229,61 @@ TEST(OperatorRegistrationTest, givenOpWithCatchallKernelOutOfScope_whenRegisteri
   EXPECT_TRUE(called);
 }
 
+TEST(OperatorRegistrationTest, givenOpThatWasCalled_whenRegisteringAndDeregisteringKernel_thenCallsTheRightKernel) {
+  bool called_catchall = false;
+  bool called_cpu = false;
+  auto registrar1 = c10::RegisterOperators().op("_test::dummy(Tensor dummy) -> ()", c10::RegisterOperators::options().catchAllKernel<MockKernel>(&called_catchall));
+
+  auto op = Dispatcher::singleton().findSchema({"_test::dummy", ""});
+  ASSERT_TRUE(op.has_value());
+  // The first calls fill the dispatcher's cache for this operator
+  callOp(*op, dummyTensor(c10::DispatchKey::CPU));
+  callOpUnboxed<void, Tensor>(*op, dummyTensor(c10::DispatchKey::CPU));
+  EXPECT_TRUE(called_catchall);
+
+  {
+    auto registrar2 = c10::RegisterOperators().op("_test::dummy(Tensor dummy) -> ()", c10::RegisterOperators::options().kernel<MockKernel>(c10::DispatchKey::CPU, &called_cpu));
+    called_catchall = false;
+    callOp(*op, dummyTensor(c10::DispatchKey::CPU));
+    callOpUnboxed<void, Tensor>(*op, dummyTensor(c10::DispatchKey::CPU));
+    EXPECT_TRUE(called_cpu);
+    EXPECT_FALSE(called_catchall);
+  }
+
+  called_cpu = false;
+  callOp(*op, dummyTensor(c10::DispatchKey::CPU));
+  callOpUnboxed<void, Tensor>(*op, dummyTensor(c10::DispatchKey::CPU));
+  EXPECT_TRUE(called_catchall);
+  EXPECT_FALSE(called_cpu);
+}
+
+TEST(OperatorRegistrationTest, givenOpThatWasCalled_whenChangingLocalDispatchKeySet_thenCallsTheRightKernel) {
+  bool called_cpu = false;
+  bool called_cuda = false;
+  auto registrar = c10::RegisterOperators().op("_test::dummy(Tensor dummy) -> ()", c10::RegisterOperators::options()
+    .kernel<MockKernel>(c10::DispatchKey::CPU, &called_cpu)
+    .kernel<MockKernel>(c10::DispatchKey::CUDA, &called_cuda));
+
+  auto op = Dispatcher::singleton().findSchema({"_test::dummy", ""});
+  ASSERT_TRUE(op.has_value());
+  callOp(*op, dummyTensor(c10::DispatchKey::CPU));
+  EXPECT_TRUE(called_cpu);
+  EXPECT_FALSE(called_cuda);
+
+  called_cpu = false;
+  {
+    c10::impl::IncludeDispatchKeyGuard guard(c10::DispatchKey::CUDA);
+    callOp(*op, dummyTensor(c10::DispatchKey::CPU));
+    EXPECT_TRUE(called_cuda);
+    EXPECT_FALSE(called_cpu);
+  }
+
+  called_cuda = false;
+  callOp(*op, dummyTensor(c10::DispatchKey::CPU));
+  EXPECT_TRUE(called_cpu);
+  EXPECT_FALSE(called_cuda);
+}
+
 TEST(OperatorRegistrationTest, givenOpWithoutKernels_whenRegisteringWithSchema_thenOnlyRegistersSchema) {
   auto registrar = c10::RegisterOperators().op("_test::dummy(Tensor dummy) -> ()");
 
@@ -24,6 +24,66 @@ using Operation = std::function<int(Stack&)>;
 //   pc += 1 + offset
 // so a return value of 0 goes to the next instruction
 
+namespace detail {
+// The buffers of the PooledStacks that were destroyed on this thread.
+struct StackPool {
+  // Enough for the nesting of boxed calls (e.g. a fallback calling the op
+  // again) that is common in practice.
+  static constexpr size_t kMaxStacks = 8;
+  // Don't keep the buffers of unusually large stacks around.
+  static constexpr size_t kMaxCapacity = 64;
+  static constexpr size_t kInitialCapacity = 8;
+
+  std::vector<Stack> stacks;
+};
+
+static inline StackPool& local_stack_pool() {
+  thread_local StackPool pool;
+  return pool;
+}
+} // namespace detail
+
+// A Stack whose buffer comes from a per-thread pool, for the stacks that only
+// live for a single boxed call (e.g. to box the arguments of an unboxed call
+// to a boxed kernel). Creating a Stack for each call otherwise allocates and
+// frees a buffer, which is a good part of the cost of calling a small op.
+// Elements are destroyed when the PooledStack is, as for a regular Stack.
+class PooledStack final {
+ public:
+  PooledStack() {
+    auto& stacks = detail::local_stack_pool().stacks;
+    if (!stacks.empty()) {
+      stack_ = std::move(stacks.back());
+      stacks.pop_back();
+    } else {
+      stack_.reserve(detail::StackPool::kInitialCapacity);
+    }
+  }
+  ~PooledStack() {
+    stack_.clear();
+    auto& stacks = detail::local_stack_pool().stacks;
+    if (stack_.capacity() <= detail::StackPool::kMaxCapacity &&
+        stacks.size() < detail::StackPool::kMaxStacks) {
+      stacks.push_back(std::move(stack_));
+    }
+  }
+  PooledStack(const PooledStack&) = delete;
+  PooledStack& operator=(const PooledStack&) = delete;
+
+  Stack& operator*() {
+    return stack_;
+  }
+  Stack* operator->() {
+    return &stack_;
+  }
+  Stack* get() {
+    return &stack_;
+  }
+
+ private:
+  Stack stack_;
+};
+
 // treat the last N elements of the stack as a list, looking up
 // element i
 static inline IValue& peek(Stack& stack, size_t i, size_t N) {
@@ -52,6 +112,13 @@ static inline IValue pop(Stack& stack) {
   stack.pop_back();
   return r;
 }
+// Same as pop(stack).toTensor(), but moves the tensor straight out of the
+// stack instead of going through a temporary IValue.
+static inline at::Tensor pop_tensor(Stack& stack) {
+  auto r = std::move(stack.back()).toTensor();
+  stack.pop_back();
+  return r;
+}
 static inline std::vector<IValue> pop(Stack& stack, size_t n) {
   std::vector<IValue> result;
   result.reserve(n);
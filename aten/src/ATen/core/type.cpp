@@ -523,9 +523,48 @@ TensorTypePtr TensorType::merge(TensorTypePtr other, bool merge_sizes) const {
       undef);
 }
 
-template <typename T>
-bool is_null_or_equal(c10::optional<T> a, c10::IntArrayRef b) {
-  return !a.has_value() || a.value() == b;
+// The static dims of `sizes` must be equal to the tensor's, while its
+// symbolic dims match any size (their consistency is checked by the caller).
+static bool matchSizes(const SymbolicShape& sizes, c10::IntArrayRef actual) {
+  if (!sizes.rank()) {
+    return true;
+  }
+  if (*sizes.rank() != actual.size()) {
+    return false;
+  }
+  const auto& dims = *sizes.sizes();
+  for (size_t i = 0; i < dims.size(); i++) {
+    if (dims[i].is_static() && dims[i].static_size() != actual[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Only the stride properties that are known have to match, so that a type
+// can e.g. require a stride order and contiguity but not exact strides.
+static bool matchStrideProps(
+    const VaryingShape<Stride>& expected,
+    const VaryingShape<Stride>& actual) {
+  if (!expected.size()) {
+    return true;
+  }
+  if (expected.size() != actual.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < *expected.size(); i++) {
+    if (!expected[i]) {
+      continue;
+    }
+    const Stride& e = *expected[i];
+    const Stride& a = *actual[i];
+    if ((e.stride_index_ && e.stride_index_ != a.stride_index_) ||
+        (e.contiguous_ && e.contiguous_ != a.contiguous_) ||
+        (e.stride_ && e.stride_ != a.stride_)) {
+      return false;
+    }
+  }
+  return true;
 }
 
 bool TensorType::matchTensor(const at::Tensor& t) {
@@ -544,12 +583,12 @@ bool TensorType::matchTensor(const at::Tensor& t) {
   // Here we know t.defined() == true and compare all other properties.
   bool rg = at::GradMode::is_enabled() && t.requires_grad();
   bool matched_strides = (!t.has_storage() && !stride_properties().isComplete())
-    || stride_properties() == computeStrideProps(t.sizes(), t.strides(), t.is_contiguous());
+    || matchStrideProps(stride_properties(), computeStrideProps(t.sizes(), t.strides(), t.is_contiguous()));
   return scalarType().value_or(t.scalar_type()) == t.scalar_type()
     && device().value_or(t.device()) == t.device()
     && requiresGrad().value_or(rg) == rg
     && matched_strides
-    && is_null_or_equal(sizes().concrete_sizes(), t.sizes());
+    && matchSizes(symbolic_sizes(), t.sizes());
 }
 
 bool TensorType::operator==(const c10::Type& rhs) const {
@@ -0,0 +1,73 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <torch/custom_class.h>
+
+namespace at { namespace native {
+
+namespace {
+
+// Holds the probability and alias tables produced by `_multinomial_alias_setup`
+// so that a fixed distribution (e.g. the unigram distribution used for
+// negative sampling) is only preprocessed once. Every subsequent draw is O(1)
+// per sample through `_multinomial_alias_draw`.
+struct AliasMultinomialSampler : torch::CustomClassHolder {
+  explicit AliasMultinomialSampler(const Tensor& probs) {
+    std::tie(alias_table_, prob_table_) = at::_multinomial_alias_setup(probs);
+  }
+
+  AliasMultinomialSampler(Tensor alias_table, Tensor prob_table)
+      : alias_table_(std::move(alias_table)),
+        prob_table_(std::move(prob_table)) {}
+
+  Tensor sample(int64_t num_samples) const {
+    return at::_multinomial_alias_draw(prob_table_, alias_table_, num_samples);
+  }
+
+  int64_t num_categories() const {
+    return alias_table_.numel();
+  }
+
+  const Tensor& alias_table() const {
+    return alias_table_;
+  }
+
+  const Tensor& prob_table() const {
+    return prob_table_;
+  }
+
+ private:
+  Tensor alias_table_;
+  Tensor prob_table_;
+};
+
+using AliasMultinomialSamplerState = std::tuple<Tensor, Tensor>;
+
+static auto alias_multinomial_sampler_registry =
+    torch::class_<AliasMultinomialSampler>("distributions", "AliasMultinomialSampler")
+        .def(torch::init<Tensor>())
+        .def("sample",
+             [](const c10::intrusive_ptr<AliasMultinomialSampler>& self,
+                int64_t num_samples) { return self->sample(num_samples); })
+        .def("num_categories",
+             [](const c10::intrusive_ptr<AliasMultinomialSampler>& self) {
+               return self->num_categories();
+             })
+        .def("tables",
+             [](const c10::intrusive_ptr<AliasMultinomialSampler>& self)
+                 -> AliasMultinomialSamplerState {
+               return std::make_tuple(self->alias_table(), self->prob_table());
+             })
+        .def_pickle(
+            [](const c10::intrusive_ptr<AliasMultinomialSampler>& self)
+                -> AliasMultinomialSamplerState {
+              return std::make_tuple(self->alias_table(), self->prob_table());
+            },
+            [](AliasMultinomialSamplerState state)
+                -> c10::intrusive_ptr<AliasMultinomialSampler> {
+              return c10::make_intrusive<AliasMultinomialSampler>(
+                  std::move(std::get<0>(state)), std::move(std::get<1>(state)));
+            });
+
+} // namespace
+
+}} // namespace at::native
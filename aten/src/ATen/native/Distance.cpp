@@ -10,6 +10,7 @@ namespace at { namespace native {
 DEFINE_DISPATCH(pdist_forward_stub);
 DEFINE_DISPATCH(pdist_backward_stub);
 DEFINE_DISPATCH(cdist_stub);
+DEFINE_DISPATCH(cdist_topk_stub);
 DEFINE_DISPATCH(cdist_backward_stub);
 
 Tensor pairwise_distance(const Tensor& x1, const Tensor& x2, double p, double eps, bool keepdim) {
@@ -153,6 +154,97 @@ Tensor _cdist_backward(const Tensor& grad, const Tensor& x1, const Tensor& x2, c
   return grad_x1;
 }
 
+// Upper bound on the number of distances the chunked path of cdist_topk
+// materializes at once.
+static constexpr int64_t cdist_topk_chunk_numel = 1 << 22;
+
+std::tuple<Tensor, Tensor> cdist_topk(const Tensor& x1, const Tensor& x2, int64_t k, const double p) {
+  TORCH_CHECK(x1.dim() >= 2, "cdist_topk only supports at least 2D tensors, X1 got: ", x1.dim(), "D");
+  TORCH_CHECK(x2.dim() >= 2, "cdist_topk only supports at least 2D tensors, X2 got: ", x2.dim(), "D");
+  TORCH_CHECK(x1.size(-1) == x2.size(-1), "X1 and X2 must have the same number of columns. X1: ", x1.size(-1), " X2: ", x2.size(-1));
+  TORCH_CHECK(at::isFloatingType(x1.scalar_type()), "cdist_topk only supports floating-point dtypes, X1 got: ", x1.scalar_type());
+  TORCH_CHECK(x1.scalar_type() == x2.scalar_type(), "X1 and X2 must have the same dtype. X1: ", x1.scalar_type(), " X2: ", x2.scalar_type());
+  TORCH_CHECK(p >= 0, "cdist_topk only supports non-negative p values");
+  IntArrayRef batch_tensor1(x1.sizes().data(), x1.dim() - 2);
+  IntArrayRef batch_tensor2(x2.sizes().data(), x2.dim() - 2);
+  TORCH_CHECK(batch_tensor1.equals(batch_tensor2), "X1 and X2 must have the same batch dimensions. X1: ", batch_tensor1, " X2: ", batch_tensor2);
+  int64_t r1 = x1.size(-2);
+  int64_t r2 = x2.size(-2);
+  int64_t m = x1.size(-1);
+  TORCH_CHECK(k >= 0 && k <= r2, "cdist_topk: k (", k, ") must be between 0 and the number of rows of X2 (", r2, ")");
+
+  std::vector<int64_t> output_shape = x1.sizes().vec();
+  output_shape.back() = k;
+  int64_t batch_product = std::accumulate(batch_tensor1.begin(), batch_tensor1.end(), static_cast<int64_t>(1), std::multiplies<int64_t>());
+  if (batch_product == 0 || r1 == 0 || k == 0) {
+    return std::make_tuple(at::empty(output_shape, x1.options()), at::empty(output_shape, x1.options().dtype(kLong)));
+  }
+  if (m == 0) {
+    // All the distances are 0, so the first k rows of X2 are the nearest.
+    Tensor indices = at::arange(k, x1.options().dtype(kLong)).expand(output_shape).contiguous();
+    return std::make_tuple(at::zeros(output_shape, x1.options()), indices);
+  }
+  Tensor x1_ = x1.reshape({batch_product, r1, m});
+  Tensor x2_ = x2.reshape({batch_product, r2, m});
+
+  // The neighbours are selected without recording anything for autograd; if
+  // gradients are needed, only the k selected distances are recomputed below.
+  Tensor values, indices;
+  Tensor x1_detached = x1_.detach();
+  Tensor x2_detached = x2_.detach();
+  if (x1.device().type() == kCPU && !(p == 2 && m > 25)) {
+    // Fused tiled kernel: never materializes more than a cache tile of the
+    // distance matrix.
+    std::tie(values, indices) = at::_cdist_topk(x1_detached, x2_detached, k, p);
+  } else {
+    // For wide inputs with p = 2, and on other devices, cdist is computed in
+    // chunks of rows of X2 (through matrix multiplication where cdist would
+    // use it) and merged into the running top-k, so memory stays bounded by
+    // cdist_topk_chunk_numel.
+    int64_t chunk = std::max(k, cdist_topk_chunk_numel / (batch_product * r1));
+    for (int64_t start = 0; start < r2; start += chunk) {
+      int64_t len = std::min(chunk, r2 - start);
+      Tensor dist = at::cdist(x1_detached, x2_detached.narrow(-2, start, len), p);
+      Tensor chunk_values, chunk_indices;
+      std::tie(chunk_values, chunk_indices) = dist.topk(std::min(k, len), -1, /*largest=*/false);
+      chunk_indices.add_(start);
+      if (values.defined()) {
+        Tensor order;
+        std::tie(chunk_values, order) = at::cat({values, chunk_values}, -1).topk(k, -1, /*largest=*/false);
+        chunk_indices = at::cat({indices, chunk_indices}, -1).gather(-1, order);
+      }
+      values = chunk_values;
+      indices = chunk_indices;
+    }
+  }
+
+  if (x1.requires_grad() || x2.requires_grad()) {
+    Tensor neighbours = x2_.gather(-2, indices.reshape({batch_product, r1 * k, 1}).expand({batch_product, r1 * k, m}));
+    values = at::norm(x1_.unsqueeze(-2) - neighbours.view({batch_product, r1, k, m}), p, -1);
+  }
+  return std::make_tuple(values.reshape(output_shape), indices.reshape(output_shape));
+}
+
+std::tuple<Tensor, Tensor> _cdist_topk_cpu(const Tensor& x1, const Tensor& x2, int64_t k, const double p) {
+  TORCH_CHECK(x1.dim() == 3 && x2.dim() == 3 && x1.size(0) == x2.size(0),
+      "_cdist_topk expects 3D X1 and X2 with the same batch size, got: ", x1.sizes(), " and ", x2.sizes());
+  TORCH_CHECK(x1.size(-1) == x2.size(-1), "X1 and X2 must have the same number of columns. X1: ", x1.size(-1), " X2: ", x2.size(-1));
+  TORCH_CHECK(x1.scalar_type() == x2.scalar_type(), "X1 and X2 must have the same dtype. X1: ", x1.scalar_type(), " X2: ", x2.scalar_type());
+  TORCH_CHECK(k > 0 && k <= x2.size(1), "_cdist_topk: k (", k, ") must be between 1 and the number of rows of X2 (", x2.size(1), ")");
+  TORCH_CHECK(p >= 0, "cdist_topk only supports non-negative p values");
+  Tensor values = at::empty({x1.size(0), x1.size(1), k}, x1.options());
+  Tensor indices = at::empty({x1.size(0), x1.size(1), k}, x1.options().dtype(kLong));
+  if (x1.size(-1) == 0) {
+    // All the distances are 0, so the first k rows of X2 are the nearest.
+    // The kernel sizes its tiles by the row size, which can't be 0.
+    values.zero_();
+    indices.copy_(at::arange(k, indices.options()).expand_as(indices));
+    return std::make_tuple(values, indices);
+  }
+  cdist_topk_stub(kCPU, values, indices, x1.contiguous(), x2.contiguous(), p, k);
+  return std::make_tuple(values, indices);
+}
+
 Tensor _pdist_forward(const Tensor& self, const double p) {
   TORCH_CHECK(self.is_contiguous(), "_pdist_forward requires contiguous input");
   auto device = self.device().type();
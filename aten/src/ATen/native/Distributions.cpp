@@ -118,6 +118,8 @@ DEFINE_DISPATCH(bernoulli_scalar_stub);
 DEFINE_DISPATCH(cauchy_stub);
 DEFINE_DISPATCH(exponential_stub);
 DEFINE_DISPATCH(multinomial_stub);
+DEFINE_DISPATCH(multinomial_alias_setup_stub);
+DEFINE_DISPATCH(multinomial_alias_draw_stub);
 DEFINE_DISPATCH(geometric_stub);
 DEFINE_DISPATCH(log_normal_stub);
 DEFINE_DISPATCH(uniform_stub);
@@ -490,4 +492,34 @@ Tensor multinomial(const Tensor& self, int64_t n_sample, bool with_replacement,
   return result;
 }
 
+std::tuple<Tensor, Tensor> _multinomial_alias_setup_cpu(const Tensor& probs) {
+  TORCH_CHECK(probs.dim() == 1,
+      "expected 1-D probability tensor, got ", probs.dim(), "-D probability tensor instead");
+  TORCH_CHECK(at::isFloatingType(probs.scalar_type()),
+      "multinomial only supports floating-point dtypes for input, got: ", probs.scalar_type());
+  Tensor J = at::empty({probs.numel()}, probs.options().dtype(kLong));
+  Tensor q = at::empty({probs.numel()}, probs.options());
+  if (probs.numel() > 0) {
+    multinomial_alias_setup_stub(kCPU, probs, J, q);
+  }
+  return std::make_tuple(J, q);
+}
+
+Tensor _multinomial_alias_draw_cpu(const Tensor& q, const Tensor& J, int64_t n_sample, c10::optional<Generator> gen) {
+  TORCH_CHECK(q.dim() == 1,
+      "expected 1-D probability table, got ", q.dim(), "-D probability table instead");
+  TORCH_CHECK(J.dim() == 1,
+      "expected 1-D alias table, got ", J.dim(), "-D alias table instead");
+  TORCH_CHECK(J.scalar_type() == ScalarType::Long,
+      "expected Long alias table, got: ", J.scalar_type());
+  TORCH_CHECK(q.numel() == J.numel(),
+      "probability table and alias table must have the same number of entries, got ",
+      q.numel(), " and ", J.numel());
+  TORCH_CHECK(n_sample > 0, "cannot sample <= 0 samples");
+  TORCH_CHECK(J.numel() > 0, "cannot sample from an empty alias table");
+  Tensor result = at::empty({n_sample}, J.options());
+  multinomial_alias_draw_stub(kCPU, result, q, J, gen);
+  return result;
+}
+
 }} // namespace at::native
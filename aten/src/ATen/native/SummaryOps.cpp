@@ -1,15 +1,56 @@
 // Returns the frequency of elements of input non-negative integer tensor.
 
+#include <ATen/native/SummaryOps.h>
+
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
 
+#include <cmath>
 #include <tuple>
 
 namespace at { namespace native {
 
+DEFINE_DISPATCH(histogramdd_stub);
+
 ///////////////// bincount /////////////////
 namespace {
 
+template <typename input_t, typename output_t, typename weight_fn_t>
+void bincount_cpu_chunked(
+    output_t* output_p,
+    const input_t* self_p,
+    int64_t self_size,
+    int64_t nbins,
+    int64_t num_chunks,
+    int64_t chunk_size,
+    const weight_fn_t& weight_fn) {
+  if (num_chunks == 1) {
+    for (int64_t i = 0; i < self_size; i++) {
+      output_p[self_p[i]] += weight_fn(i);
+    }
+    return;
+  }
+  std::vector<output_t> local_bins(num_chunks * nbins, 0);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      output_t* local_p = local_bins.data() + c * nbins;
+      int64_t stop = std::min(self_size, (c + 1) * chunk_size);
+      for (int64_t i = c * chunk_size; i < stop; i++) {
+        local_p[self_p[i]] += weight_fn(i);
+      }
+    }
+  });
+  at::parallel_for(0, nbins, at::internal::GRAIN_SIZE / num_chunks + 1, [&](int64_t begin, int64_t end) {
+    for (int64_t j = begin; j < end; j++) {
+      for (int64_t c = 0; c < num_chunks; c++) {
+        output_p[j] += local_bins[c * nbins + j];
+      }
+    }
+  });
+}
+
 template <typename input_t, typename weights_t>
 Tensor _bincount_cpu_template(
     const Tensor& self,
@@ -35,20 +76,26 @@ Tensor _bincount_cpu_template(
   int64_t nbins = static_cast<int64_t>(*self.max().data_ptr<input_t>()) + 1L;
   nbins = std::max(nbins, minlength); // at least minlength # of bins
 
+  // Every chunk of the input is counted into a private copy of the bins, which
+  // are summed up at the end, so threads never write to the same bins. Chunks
+  // are kept large compared to the number of bins so that the reduction stays
+  // cheap.
+  const int64_t num_chunks = std::max<int64_t>(1, std::min<int64_t>(
+      at::get_num_threads(), self_size / std::max<int64_t>(nbins, at::internal::GRAIN_SIZE)));
+  const int64_t chunk_size = (self_size + num_chunks - 1) / num_chunks;
+
   const input_t* self_p = self.data_ptr<input_t>();
   if (has_weights) {
     output = native::zeros({nbins}, weights.options());
-    weights_t* output_p = output.data_ptr<weights_t>();
     const weights_t* weights_p = weights.data_ptr<weights_t>();
-    for (int64_t i = 0; i < self_size; i++) {
-      output_p[self_p[i]] += weights_p[i];
-    }
+    bincount_cpu_chunked<input_t, weights_t>(
+        output.data_ptr<weights_t>(), self_p, self_size, nbins, num_chunks, chunk_size,
+        [weights_p](int64_t i) { return weights_p[i]; });
   } else {
     output = native::zeros({nbins}, kLong);
-    int64_t* output_p = output.data_ptr<int64_t>();
-    for (int64_t i = 0; i < self_size; i++) {
-      output_p[self_p[i]] += 1L;
-    }
+    bincount_cpu_chunked<input_t, int64_t>(
+        output.data_ptr<int64_t>(), self_p, self_size, nbins, num_chunks, chunk_size,
+        [](int64_t /*i*/) { return 1L; });
   }
   return output;
 }
@@ -65,4 +112,98 @@ _bincount_cpu(const Tensor& self, const Tensor& weights, int64_t minlength) {
   });
 }
 
+///////////////// histc /////////////////
+Tensor& _histc_out_cpu(Tensor& result, const Tensor& self, int64_t bins, Scalar min, Scalar max) {
+  TORCH_CHECK(bins > 0, "bins must be > 0");
+  TORCH_CHECK(result.scalar_type() == self.scalar_type(),
+      "histc: expected result dtype to be ", self.scalar_type(), " but got ", result.scalar_type());
+  result.resize_({bins});
+  // The kernel accumulates into a contiguous histogram
+  Tensor hist = result.is_contiguous() ? result : at::empty({bins}, self.options());
+  hist.zero_();
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "histc_cpu", [&] {
+    scalar_t leftmost = min.to<scalar_t>();
+    scalar_t rightmost = max.to<scalar_t>();
+    if (leftmost == rightmost) {
+      leftmost = self.min().item<scalar_t>();
+      rightmost = self.max().item<scalar_t>();
+    }
+    if (leftmost == rightmost) {
+      leftmost = leftmost - 1;
+      rightmost = rightmost + 1;
+    }
+    TORCH_CHECK(!(std::isinf(leftmost) || std::isinf(rightmost) ||
+                  std::isnan(leftmost) || std::isnan(rightmost)),
+        "range of [", leftmost, ", ", rightmost, "] is not finite");
+    TORCH_CHECK(leftmost < rightmost, "max must be larger than min");
+
+    double leftmost_d = leftmost;
+    double rightmost_d = rightmost;
+    histogramdd_stub(kCPU, hist, self.contiguous().view({-1, 1}), Tensor(),
+        bins, leftmost_d, rightmost_d);
+  });
+  if (!hist.is_same(result)) {
+    result.copy_(hist);
+  }
+  return result;
+}
+
+Tensor _histc_cpu(const Tensor& self, int64_t bins, Scalar min, Scalar max) {
+  Tensor result = at::empty({0}, self.options());
+  return native::_histc_out_cpu(result, self, bins, min, max);
+}
+
+///////////////// histogramdd /////////////////
+Tensor _histogramdd_cpu(const Tensor& self, IntArrayRef bins, const Tensor& range, const Tensor& weight) {
+  TORCH_CHECK(self.dim() == 2, "histogramdd: expected a 2-D (N, D) input, but got ", self.dim(), "-D input");
+  const int64_t N = self.size(0);
+  const int64_t D = self.size(1);
+  TORCH_CHECK(D > 0, "histogramdd: expected the input to have at least one column");
+  TORCH_CHECK(static_cast<int64_t>(bins.size()) == D,
+      "histogramdd: expected ", D, " bin counts, one for every column of the input, but got ", bins.size());
+  for (auto b : bins) {
+    TORCH_CHECK(b > 0, "bins must be > 0");
+  }
+  if (weight.defined()) {
+    TORCH_CHECK(weight.dim() == 1 && weight.size(0) == N,
+        "histogramdd: expected weight of shape [", N, "], but got ", weight.sizes());
+    TORCH_CHECK(weight.scalar_type() == self.scalar_type(),
+        "histogramdd: expected weight dtype to be ", self.scalar_type(), " but got ", weight.scalar_type());
+  }
+
+  std::vector<double> leftmost(D);
+  std::vector<double> rightmost(D);
+  if (range.defined()) {
+    TORCH_CHECK(range.dim() == 2 && range.size(0) == D && range.size(1) == 2,
+        "histogramdd: expected range of shape [", D, ", 2], but got ", range.sizes());
+    auto range_d = range.to(kCPU, kDouble).contiguous();
+    const double* range_p = range_d.data_ptr<double>();
+    for (int64_t d = 0; d < D; d++) {
+      leftmost[d] = range_p[2 * d];
+      rightmost[d] = range_p[2 * d + 1];
+    }
+  } else if (N > 0) {
+    auto mins = std::get<0>(self.min(0)).to(kDouble);
+    auto maxs = std::get<0>(self.max(0)).to(kDouble);
+    for (int64_t d = 0; d < D; d++) {
+      leftmost[d] = mins[d].item<double>();
+      rightmost[d] = maxs[d].item<double>();
+    }
+  }
+  for (int64_t d = 0; d < D; d++) {
+    if (leftmost[d] == rightmost[d]) {
+      leftmost[d] -= 1;
+      rightmost[d] += 1;
+    }
+    TORCH_CHECK(std::isfinite(leftmost[d]) && std::isfinite(rightmost[d]),
+        "range of [", leftmost[d], ", ", rightmost[d], "] is not finite");
+    TORCH_CHECK(leftmost[d] < rightmost[d], "max must be larger than min");
+  }
+
+  Tensor hist = at::zeros(bins, self.options());
+  histogramdd_stub(kCPU, hist, self.contiguous(),
+      weight.defined() ? weight.contiguous() : weight, bins, leftmost, rightmost);
+  return hist;
+}
+
 }} // namespace at::native
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// Adds the (optionally weighted) number of rows of the contiguous (N, D)
+// tensor `self` falling into each bin to `hist`, a contiguous tensor of shape
+// `bins`. Along dim d the bins evenly split [leftmost[d], rightmost[d]], the
+// last bin being closed on the right; out of range and NaN values are ignored.
+using histogramdd_fn = void(*)(Tensor& hist, const Tensor& self, const Tensor& weight,
+                               IntArrayRef bins, ArrayRef<double> leftmost, ArrayRef<double> rightmost);
+
+DECLARE_DISPATCH(histogramdd_fn, histogramdd_stub);
+
+}} // namespace at::native
@@ -404,6 +404,95 @@ Tensor index_add(const Tensor & self, int64_t dim, const Tensor & index, const T
   return self.clone(at::MemoryFormat::Preserve).index_add_(dim, index, source);
 }
 
+// Number of rows ahead of the current one whose first cache line is
+// prefetched by the row gather loop below. The rows are picked by the index
+// and hence are generally not adjacent, so the hardware prefetcher can't
+// predict them.
+constexpr int64_t INDEX_SELECT_PREFETCH_DISTANCE = 4;
+
+static inline void index_select_prefetch(const char* ptr) {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(ptr, /*rw=*/0, /*locality=*/0);
+#endif
+}
+
+// row_bytes is a compile time constant for small rows (so the memcpy is
+// lowered to a single load/store), and 0 for the generic case.
+template <int64_t static_row_bytes>
+static void index_select_rows_loop(
+    char* result_data,
+    const char* self_data,
+    const int64_t* index_data,
+    int64_t num_rows,
+    int64_t numel,
+    int64_t self_dim_size,
+    int64_t row_bytes,
+    int64_t grain_size) {
+  at::parallel_for(0, num_rows, grain_size, [&](int64_t start, int64_t end) {
+    auto src_row = [&](int64_t r) {
+      int64_t outer = r / numel;
+      return self_data + (outer * self_dim_size + index_data[r - outer * numel]) * row_bytes;
+    };
+    for (int64_t r = start; r < end; r++) {
+      if (r + INDEX_SELECT_PREFETCH_DISTANCE < end) {
+        index_select_prefetch(src_row(r + INDEX_SELECT_PREFETCH_DISTANCE));
+      }
+      if (static_row_bytes > 0) {
+        memcpy(result_data + r * static_row_bytes, src_row(r), static_row_bytes);
+      } else {
+        memcpy(result_data + r * row_bytes, src_row(r), row_bytes);
+      }
+    }
+  });
+}
+
+// Fast path of index_select for the common case of gathering whole slices
+// (e.g. assembling a batch from rows of a dataset tensor). When both self and
+// result are contiguous, every selected slice is a contiguous run of bytes in
+// both, so index_select boils down to a parallel loop of memcpys that works
+// the same for every dtype. Returns false if the layouts don't allow it.
+static bool index_select_rows_cpu_(Tensor & result, const Tensor & self, int64_t dim, const int64_t* index_data, int64_t numel) {
+  if (self.dim() == 0 || !self.is_contiguous() || !result.is_contiguous()) {
+    return false;
+  }
+  auto sizes = self.sizes();
+  int64_t outer_size = std::accumulate(sizes.begin(), sizes.begin() + dim, static_cast<int64_t>(1), std::multiplies<int64_t>());
+  int64_t inner_size = std::accumulate(sizes.begin() + dim + 1, sizes.end(), static_cast<int64_t>(1), std::multiplies<int64_t>());
+  int64_t self_dim_size = self.size(dim);
+
+  for (int64_t i = 0; i < numel; i++) {
+    auto self_i = index_data[i];
+    TORCH_CHECK_INDEX((self_i >= 0) && (self_i < self_dim_size), "index out of range in self");
+  }
+
+  auto row_bytes = inner_size * static_cast<int64_t>(elementSize(self.scalar_type()));
+  auto num_rows = outer_size * numel;
+  auto grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / inner_size);
+  auto result_data = static_cast<char*>(result.data_ptr());
+  auto self_data = static_cast<const char*>(self.data_ptr());
+
+  switch (row_bytes) {
+    case 1:
+      index_select_rows_loop<1>(result_data, self_data, index_data, num_rows, numel, self_dim_size, row_bytes, grain_size);
+      break;
+    case 2:
+      index_select_rows_loop<2>(result_data, self_data, index_data, num_rows, numel, self_dim_size, row_bytes, grain_size);
+      break;
+    case 4:
+      index_select_rows_loop<4>(result_data, self_data, index_data, num_rows, numel, self_dim_size, row_bytes, grain_size);
+      break;
+    case 8:
+      index_select_rows_loop<8>(result_data, self_data, index_data, num_rows, numel, self_dim_size, row_bytes, grain_size);
+      break;
+    case 16:
+      index_select_rows_loop<16>(result_data, self_data, index_data, num_rows, numel, self_dim_size, row_bytes, grain_size);
+      break;
+    default:
+      index_select_rows_loop<0>(result_data, self_data, index_data, num_rows, numel, self_dim_size, row_bytes, grain_size);
+  }
+  return true;
+}
+
 Tensor & index_select_out_cpu_(Tensor & result, const Tensor & self, int64_t dim, const Tensor & index) {
   dim = maybe_wrap_dim(dim, self.dim());
 
@@ -429,6 +518,10 @@ Tensor & index_select_out_cpu_(Tensor & result, const Tensor & self, int64_t dim
       return result;
     }
 
+    if (index_select_rows_cpu_(result, self, dim, index_data, numel)) {
+      return result;
+    }
+
     auto selfSlice = self.select(dim, 0);
     auto resultSlice = result.select(dim, 0);
     auto selfSlice_data = selfSlice.data_ptr();
@@ -483,7 +576,12 @@ Tensor & index_select_out_cpu_(Tensor & result, const Tensor & self, int64_t dim
   } else {
     TORCH_CHECK(result.dim() <= 1, "result.dim() (", result.dim(), ") must one or zero for given self.dim() (", self.dim(), ")");
 
-    AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool, self.scalar_type(), "index_select", [&] {
+    if (numel == 0 || index_select_rows_cpu_(result, self, dim, index_data, numel)) {
+      return result;
+    }
+
+    AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(at::ScalarType::Half, at::ScalarType::Bool, at::ScalarType::BFloat16,
+                                           self.scalar_type(), "index_select", [&] {
       auto self_stride = self.dim() == 0 ? 1 : self.stride(dim);
       auto result_stride = result.dim() == 0 ? 1 : result.stride(dim);
 
@@ -521,8 +619,32 @@ Tensor index_fill(const Tensor & self, int64_t dim, const Tensor & index, const
   return self.clone(at::MemoryFormat::Preserve).index_fill_(dim, index, source);
 }
 
+// gather along dim 0 with an index that is expanded over all the other dims,
+// i.e. `self.gather(0, rows.unsqueeze(1).expand(-1, n))`, selects whole rows
+// and is sent to the much faster row copy path of index_select.
+static bool is_row_gather(const Tensor & result, const Tensor & self, int64_t dim, const Tensor & index) {
+  if (!result.device().is_cpu() || self.dim() == 0 || index.dim() != self.dim() ||
+      maybe_wrap_dim(dim, self.dim()) != 0 || index.scalar_type() != ScalarType::Long ||
+      result.scalar_type() != self.scalar_type()) {
+    return false;
+  }
+  for (int64_t d = 1; d < self.dim(); d++) {
+    if (index.size(d) != self.size(d) || (index.stride(d) != 0 && index.size(d) != 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 Tensor & gather_out_cpu_cuda(Tensor & result, const Tensor & self, int64_t dim, const Tensor & index, bool sparse_grad) {
   result.resize_(index.sizes());
+  if (is_row_gather(result, self, dim, index)) {
+    auto rows = index;
+    for (int64_t d = index.dim() - 1; d > 0; d--) {
+      rows = rows.select(d, 0);
+    }
+    return index_select_out_cpu_(result, self, 0, rows);
+  }
   gather_stub(result.device().type(), result, self, dim, index);
   return result;
 }
@@ -72,6 +72,8 @@ DECLARE_DISPATCH(void(*)(TensorIterator&, c10::optional<Generator>), random_stub
 DECLARE_DISPATCH(void(*)(TensorIterator&, const int64_t), polygamma_stub);
 DECLARE_DISPATCH(void(*)(TensorIterator&, Scalar a, Scalar b), clamp_stub);
 DECLARE_DISPATCH(void(*)(Tensor&, const Tensor&, int64_t, bool, c10::optional<Generator>), multinomial_stub);
+DECLARE_DISPATCH(void(*)(const Tensor&, Tensor&, Tensor&), multinomial_alias_setup_stub);
+DECLARE_DISPATCH(void(*)(Tensor&, const Tensor&, const Tensor&, c10::optional<Generator>), multinomial_alias_draw_stub);
 
 // Missing unary functions
 // digamma
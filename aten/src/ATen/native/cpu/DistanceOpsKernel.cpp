@@ -3,6 +3,8 @@
 #include <numeric>
 #include <iterator>
 #include <algorithm>
+#include <utility>
+#include <vector>
 
 #include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
@@ -193,67 +195,169 @@ struct Dist {
     }
   }
 
+  // cdist is computed in tiles of (rows of x1) x (rows of x2). A tile of x2
+  // rows is sized to stay in L1 while every row of the x1 tile is compared
+  // against it, and each pair is reduced over the feature dimension with
+  // Vec256. Tiles are independent, so we parallelize over all of them, which
+  // keeps every thread busy even when one of r1 and r2 is small.
+  static constexpr int64_t cdist_tile_x1_rows = 16;
+  static constexpr int64_t cdist_tile_bytes = 16 * 1024;
+
+  static inline int64_t cdist_tile_x2_rows(int64_t m) {
+    return std::max<int64_t>(1, cdist_tile_bytes / (m * static_cast<int64_t>(sizeof(scalar_t))));
+  }
+
+  template <typename F>
+  static inline scalar_t cdist_reduce(const scalar_t * a, const scalar_t * b, const Vec& pvec, int64_t m) {
+    return vec256::map2_reduce_all<scalar_t>(
+      [&pvec](Vec x, Vec y) { return F::map((x - y).abs(), pvec); },
+      F::red, a, b, m);
+  }
+
   template <typename F>
   static void run_parallel_cdist(Tensor& result, const Tensor& t1, const Tensor& t2, const scalar_t p) {
     const scalar_t * const t1_start = t1.data_ptr<scalar_t>();
     const scalar_t * const t2_start = t2.data_ptr<scalar_t>();
-    int64_t d = t1.size(0);
-    int64_t r1 = t1.size(-2);
-    int64_t r2 = t2.size(-2);
-    int64_t m = t1.size(-1);
+    const int64_t d = t1.size(0);
+    const int64_t r1 = t1.size(-2);
+    const int64_t r2 = t2.size(-2);
+    const int64_t m = t1.size(-1);
 
     scalar_t * const res_start = result.data_ptr<scalar_t>();
-    int64_t combs = r1 * r2;
-    int64_t size1 = r1 * m;
-    int64_t size2 = r2 * m;
+    const int64_t tile1 = cdist_tile_x1_rows;
+    const int64_t tile2 = cdist_tile_x2_rows(m);
+    const int64_t tiles1 = (r1 + tile1 - 1) / tile1;
+    const int64_t tiles2 = (r2 + tile2 - 1) / tile2;
+    const int64_t grain = std::max<int64_t>(1, internal::GRAIN_SIZE / (tile1 * tile2 * m));
 
-    parallel_for(0, combs * d, internal::GRAIN_SIZE / (16 * m), [=](int64_t start, int64_t end) {
-      scalar_t * res = res_start + start;
-      const scalar_t * const res_end = res_start + end;
-      int64_t l = start / combs;
-      int64_t k = start % combs;
-      int64_t i = k / r2;
-      int64_t j = k % r2;
-      i = i * m;
-      j = j * m;
+    parallel_for(0, d * tiles1 * tiles2, grain, [=](int64_t start, int64_t end) {
+      const Vec pvec(p);
+      for (int64_t tile = start; tile < end; tile++) {
+        const int64_t l = tile / (tiles1 * tiles2);
+        const int64_t i_begin = (tile / tiles2 % tiles1) * tile1;
+        const int64_t j_begin = (tile % tiles2) * tile2;
+        const int64_t i_end = std::min(i_begin + tile1, r1);
+        const int64_t j_end = std::min(j_begin + tile2, r2);
+
+        const scalar_t * const x1 = t1_start + l * r1 * m;
+        const scalar_t * const x2 = t2_start + l * r2 * m;
+        scalar_t * const res = res_start + l * r1 * r2;
+        for (int64_t i = i_begin; i < i_end; i++) {
+          for (int64_t j = j_begin; j < j_end; j++) {
+            res[i * r2 + j] = F::finish(cdist_reduce<F>(x1 + i * m, x2 + j * m, pvec, m), p);
+          }
+        }
+      }
+    });
+  }
 
-      while (res != res_end) {
-        const scalar_t * self_i = t1_start + size1 * l + i;
-        const scalar_t * self_j = t2_start + size2 * l + j;
-
-        scalar_t agg = 0;
-        for (int x = 0; x < m; x++) {
-          scalar_t a = *(self_i + x);
-          scalar_t b = *(self_j + x);
-          agg = F::red(agg, F::map(std::abs(a-b), p));
+  static void apply_cdist(Tensor& result, const Tensor& x1, const Tensor& x2, const scalar_t p) {
+    if (p == 0.0) {
+      run_parallel_cdist<zdist_calc<Vec>>(result, x1, x2, p);
+    } else if (p == 1.0) {
+      run_parallel_cdist<odist_calc<Vec>>(result, x1, x2, p);
+    } else if (p == 2.0) {
+      run_parallel_cdist<tdist_calc<Vec>>(result, x1, x2, p);
+    } else if (std::isinf(p)) {
+      run_parallel_cdist<idist_calc<Vec>>(result, x1, x2, p);
+    } else {
+      run_parallel_cdist<pdist_calc<Vec>>(result, x1, x2, p);
+    }
+  }
+
+  // Orders (distance, index) candidates by distance, with NaNs after every
+  // number, and breaks ties on the index so that results are deterministic.
+  static inline bool cdist_nearer(const std::pair<scalar_t, int64_t>& a, const std::pair<scalar_t, int64_t>& b) {
+    if (std::isnan(a.first) || std::isnan(b.first)) {
+      return std::isnan(a.first) == std::isnan(b.first) ? a.second < b.second : std::isnan(b.first);
+    }
+    return a.first < b.first || (a.first == b.first && a.second < b.second);
+  }
+
+  // Computes the k nearest rows of x2 for every row of x1 with the same tiling
+  // as run_parallel_cdist, but instead of writing each tile out, it is folded
+  // into a bounded max-heap per row of x1. The distance matrix is never
+  // materialized, so memory stays at O(r1 * k). Every finish function is
+  // monotonic, so candidates are compared on the reduced value and only the
+  // k survivors are finished.
+  template <typename F>
+  static void run_parallel_cdist_topk(Tensor& values, Tensor& indices, const Tensor& t1, const Tensor& t2, const scalar_t p, const int64_t k) {
+    const scalar_t * const t1_start = t1.data_ptr<scalar_t>();
+    const scalar_t * const t2_start = t2.data_ptr<scalar_t>();
+    const int64_t d = t1.size(0);
+    const int64_t r1 = t1.size(-2);
+    const int64_t r2 = t2.size(-2);
+    const int64_t m = t1.size(-1);
+
+    scalar_t * const values_start = values.data_ptr<scalar_t>();
+    int64_t * const indices_start = indices.data_ptr<int64_t>();
+    const int64_t tile1 = cdist_tile_x1_rows;
+    const int64_t tile2 = cdist_tile_x2_rows(m);
+    const int64_t tiles1 = (r1 + tile1 - 1) / tile1;
+    const int64_t grain = std::max<int64_t>(1, internal::GRAIN_SIZE / (tile1 * r2 * m));
+
+    parallel_for(0, d * tiles1, grain, [=](int64_t start, int64_t end) {
+      const Vec pvec(p);
+      std::vector<std::vector<std::pair<scalar_t, int64_t>>> heaps(tile1);
+      for (auto& heap : heaps) {
+        heap.reserve(k);
+      }
+
+      for (int64_t tile = start; tile < end; tile++) {
+        const int64_t l = tile / tiles1;
+        const int64_t i_begin = (tile % tiles1) * tile1;
+        const int64_t i_end = std::min(i_begin + tile1, r1);
+        const scalar_t * const x1 = t1_start + l * r1 * m;
+        const scalar_t * const x2 = t2_start + l * r2 * m;
+
+        for (auto& heap : heaps) {
+          heap.clear();
+        }
+        for (int64_t j_begin = 0; j_begin < r2; j_begin += tile2) {
+          const int64_t j_end = std::min(j_begin + tile2, r2);
+          for (int64_t i = i_begin; i < i_end; i++) {
+            auto& heap = heaps[i - i_begin];
+            for (int64_t j = j_begin; j < j_end; j++) {
+              std::pair<scalar_t, int64_t> candidate(cdist_reduce<F>(x1 + i * m, x2 + j * m, pvec, m), j);
+              if (static_cast<int64_t>(heap.size()) < k) {
+                heap.push_back(candidate);
+                std::push_heap(heap.begin(), heap.end(), cdist_nearer);
+              } else if (cdist_nearer(candidate, heap.front())) {
+                std::pop_heap(heap.begin(), heap.end(), cdist_nearer);
+                heap.back() = candidate;
+                std::push_heap(heap.begin(), heap.end(), cdist_nearer);
+              }
+            }
+          }
         }
-        *res = F::finish(agg, p);
 
-        res += 1;
-        j += m;
-        if (j == size2) {
-          j = 0;
-          i += m;
-          if (i == size1) {
-            i = 0;
-            l += 1;
+        for (int64_t i = i_begin; i < i_end; i++) {
+          auto& heap = heaps[i - i_begin];
+          std::sort_heap(heap.begin(), heap.end(), cdist_nearer);
+          scalar_t * const values_i = values_start + (l * r1 + i) * k;
+          int64_t * const indices_i = indices_start + (l * r1 + i) * k;
+          for (int64_t n = 0; n < k; n++) {
+            values_i[n] = F::finish(heap[n].first, p);
+            indices_i[n] = heap[n].second;
           }
         }
       }
     });
   }
 
-  static void apply_cdist(Tensor& result, const Tensor& x1, const Tensor& x2, const scalar_t p) {
+  // Assumes x1 and x2 are contiguous 3D tensors with the same batch size and
+  // that 0 < k <= x2.size(-2)
+  static void apply_cdist_topk(Tensor& values, Tensor& indices, const Tensor& x1, const Tensor& x2, const scalar_t p, const int64_t k) {
     if (p == 0.0) {
-      run_parallel_cdist<zdist_calc<scalar_t>>(result, x1, x2, p);
+      run_parallel_cdist_topk<zdist_calc<Vec>>(values, indices, x1, x2, p, k);
     } else if (p == 1.0) {
-      run_parallel_cdist<odist_calc<scalar_t>>(result, x1, x2, p);
+      run_parallel_cdist_topk<odist_calc<Vec>>(values, indices, x1, x2, p, k);
     } else if (p == 2.0) {
-      run_parallel_cdist<tdist_calc<scalar_t>>(result, x1, x2, p);
+      run_parallel_cdist_topk<tdist_calc<Vec>>(values, indices, x1, x2, p, k);
     } else if (std::isinf(p)) {
-      run_parallel_cdist<idist_calc<scalar_t>>(result, x1, x2, p);
+      run_parallel_cdist_topk<idist_calc<Vec>>(values, indices, x1, x2, p, k);
     } else {
-      run_parallel_cdist<pdist_calc<scalar_t>>(result, x1, x2, p);
+      run_parallel_cdist_topk<pdist_calc<Vec>>(values, indices, x1, x2, p, k);
     }
   }
 
@@ -352,12 +456,9 @@ struct Dist {
     const int64_t r2 = t2.size(-2);
     const int64_t m = t1.size(-1);
     const int64_t d = result.size(0);
-    const int64_t l1_size = r1 * m;
-    const int64_t l2_size = r2 * m;
     //current implementation supports only tensor that can be collapsed to 1D. However, to avoid checking if grad satisfies this assumption,
     //we call .contiguous() on grad before backward, thus stride is guaranteed to be 1
     //don't use grad.stride(-1), because if last dimension is 1, stride can be bogus.
-    const int64_t gs = 1;
 
     const scalar_t * const grad_start = grad.data_ptr<scalar_t>();
     const scalar_t * const dist_start = dist.data_ptr<scalar_t>();
@@ -365,45 +466,44 @@ struct Dist {
     const scalar_t * const t2_start = t2.data_ptr<scalar_t>();
     scalar_t * const res_start = result.data_ptr<scalar_t>();
 
-    at::parallel_for(0, m / Vec::size(), internal::GRAIN_SIZE / (16 * r1), [=](int64_t l, int64_t end) {
+    // The gradient of a row of x1 only depends on that row, all of x2 and the
+    // matching row of grad and dist, so rows can be computed independently
+    // without any locking. This parallelizes over all d * r1 rows rather than
+    // over the m / Vec::size() columns, which leaves most threads idle for
+    // the narrow embeddings cdist is typically used with.
+    at::parallel_for(0, d * r1, std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(1, r2 * m)), [=](int64_t start, int64_t end) {
       const Vec pvec(p);
-
-      const scalar_t * i = t1_start + l * Vec::size();
-      const scalar_t * j = t2_start + l * Vec::size();
-      scalar_t * res_l = res_start + l * Vec::size();
-
-      for (const scalar_t * const res_end = res_start + end * Vec::size(); res_l != res_end; i += Vec::size(), j += Vec::size(), res_l += Vec::size()) {
-        backward_down_column_cdist<F>(i, j, res_l, grad_start, dist_start, pvec, r1, r2, m, d, gs, l1_size, l2_size);
+      for (int64_t row = start; row < end; row++) {
+        const int64_t l = row / r1;
+        const scalar_t * const t1_row = t1_start + row * m;
+        const scalar_t * const t2_batch = t2_start + l * r2 * m;
+        const scalar_t * const grad_row = grad_start + row * r2;
+        const scalar_t * const dist_row = dist_start + row * r2;
+        scalar_t * const res_row = res_start + row * m;
+
+        int64_t c = 0;
+        for (; c + Vec::size() <= m; c += Vec::size()) {
+          backward_row_cdist<F>(t1_row + c, t2_batch + c, res_row + c, grad_row, dist_row, pvec, r2, m);
+        }
+        if (c < m) {
+          backward_row_cdist<F>(t1_row + c, t2_batch + c, res_row + c, grad_row, dist_row, pvec, r2, m, m - c);
+        }
       }
     });
-    const int64_t remainder = m % Vec::size();
-    if (remainder) {
-      backward_down_column_cdist<F>(t1_start + (m - remainder), t2_start + (m - remainder), res_start + (m - remainder), grad_start, dist_start, Vec(p), r1, r2, m, d, gs, l1_size, l2_size, remainder);
-    }
   }
 
+  // This does a backward pass for one Vec of a row of x1 against every row of x2
   template <typename F>
-  inline static void backward_down_column_cdist(const scalar_t * t1, const scalar_t * t2, scalar_t * res, const scalar_t * grad_k, const scalar_t * dist_k, const Vec& pvec, int64_t r1, int64_t r2, int64_t m, int64_t d, int64_t gs, int64_t l1_size, int64_t l2_size, int64_t count = Vec::size()) {
-    const scalar_t * t1_end = t1 + l1_size;
-    const scalar_t * t2_end = t2 + l2_size;
-
-    for (int64_t l = 0; l < d; l++) {
-      for (; t1 != t1_end; t1 += m, res += m) {
-        const Vec vec_t1 = Vec::loadu(t1, count);
-        Vec res_vec = Vec::loadu(res, count);
-
-        for (const scalar_t * t2_curr = t2; t2_curr != t2_end; t2_curr += m, grad_k += gs, dist_k += 1) {
-          const Vec vec_t2 = Vec::loadu(t2_curr, count);
-          Vec res = F::backward(vec_t1 - vec_t2, *grad_k, *dist_k, pvec);
-          res_vec = res_vec + res;
-        }
+  inline static void backward_row_cdist(const scalar_t * t1, const scalar_t * t2, scalar_t * res, const scalar_t * grad_k, const scalar_t * dist_k, const Vec& pvec, int64_t r2, int64_t m, int64_t count = Vec::size()) {
+    const Vec vec_t1 = Vec::loadu(t1, count);
+    Vec res_vec = Vec::loadu(res, count);
 
-        res_vec.store(res, count);
-      }
-      t1_end += l1_size;
-      t2_end += l2_size;
-      t2 += l2_size;
+    for (int64_t j = 0; j < r2; j++, t2 += m) {
+      const Vec vec_t2 = Vec::loadu(t2, count);
+      res_vec = res_vec + F::backward(vec_t1 - vec_t2, grad_k[j], dist_k[j], pvec);
     }
+
+    res_vec.store(res, count);
   }
 
 };
@@ -426,6 +526,12 @@ static void cdist_kernel_impl(Tensor& result, const Tensor& x1, const Tensor& x2
   });
 }
 
+static void cdist_topk_kernel_impl(Tensor& values, Tensor& indices, const Tensor& x1, const Tensor& x2, const double p, const int64_t k) {
+  AT_DISPATCH_FLOATING_TYPES(values.scalar_type(), "cdist_topk", [&] {
+    Dist<scalar_t>::apply_cdist_topk(values, indices, x1, x2, p, k);
+  });
+}
+
 static void cdist_backward_kernel_impl(Tensor& result, const Tensor& grad, const Tensor& x1, const Tensor& x2, const double p, const Tensor& dist) {
   AT_DISPATCH_FLOATING_TYPES(result.scalar_type(), "cdist_backward", [&] {
     Dist<scalar_t>::apply_backward_cdist(result, grad, x1, x2, p, dist);
@@ -438,6 +544,7 @@ static void cdist_backward_kernel_impl(Tensor& result, const Tensor& grad, const
 REGISTER_DISPATCH(pdist_forward_stub, &pdist_forward_kernel_impl);
 REGISTER_DISPATCH(pdist_backward_stub, &pdist_backward_kernel_impl);
 REGISTER_DISPATCH(cdist_stub, &cdist_kernel_impl);
+REGISTER_DISPATCH(cdist_topk_stub, &cdist_topk_kernel_impl);
 REGISTER_DISPATCH(cdist_backward_stub, &cdist_backward_kernel_impl);
 
 }}  // namespace at::native
@@ -0,0 +1,160 @@
+#include <ATen/native/SummaryOps.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+namespace at { namespace native { namespace {
+
+// The positions of 1-D inputs are computed for a block of elements at a time
+// with vector instructions; only the data dependent increments of the bins
+// are left to the scalar loop.
+constexpr int64_t HISTOGRAM_BLOCK_SIZE = 256;
+
+template <typename scalar_t>
+void histogram_1d_chunk(
+    double* local_hist,
+    const scalar_t* self_data,
+    const scalar_t* weight_data,
+    int64_t start,
+    int64_t end,
+    int64_t nbins,
+    scalar_t leftmost,
+    scalar_t rightmost) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const Vec vec_leftmost(leftmost);
+  const Vec vec_range(rightmost - leftmost);
+  const Vec vec_nbins(static_cast<scalar_t>(nbins));
+  scalar_t pos[HISTOGRAM_BLOCK_SIZE];
+
+  for (int64_t block = start; block < end; block += HISTOGRAM_BLOCK_SIZE) {
+    int64_t block_size = std::min(HISTOGRAM_BLOCK_SIZE, end - block);
+    const scalar_t* data = self_data + block;
+    // Same expression (and rounding) as the scalar and CUDA implementations,
+    // so that values on bin edges end up in the same bin.
+    int64_t k = 0;
+    for (; k + Vec::size() <= block_size; k += Vec::size()) {
+      ((Vec::loadu(data + k) - vec_leftmost) / vec_range * vec_nbins).store(pos + k);
+    }
+    if (k < block_size) {
+      ((Vec::loadu(data + k, block_size - k) - vec_leftmost) / vec_range * vec_nbins)
+          .store(pos + k, block_size - k);
+    }
+    for (k = 0; k < block_size; k++) {
+      scalar_t x = data[k];
+      if (x >= leftmost && x <= rightmost) {
+        int64_t bin = std::min(static_cast<int64_t>(pos[k]), nbins - 1);
+        local_hist[bin] += weight_data ? static_cast<double>(weight_data[block + k]) : 1.;
+      }
+    }
+  }
+}
+
+template <typename scalar_t>
+void histogram_nd_chunk(
+    double* local_hist,
+    const scalar_t* self_data,
+    const scalar_t* weight_data,
+    int64_t start,
+    int64_t end,
+    IntArrayRef bins,
+    const std::vector<scalar_t>& leftmost,
+    const std::vector<scalar_t>& rightmost) {
+  const int64_t D = bins.size();
+  for (int64_t i = start; i < end; i++) {
+    const scalar_t* row = self_data + i * D;
+    int64_t flat_bin = 0;
+    int64_t d = 0;
+    for (; d < D; d++) {
+      scalar_t x = row[d];
+      if (!(x >= leftmost[d] && x <= rightmost[d])) {
+        break;
+      }
+      int64_t bin = static_cast<int64_t>((x - leftmost[d]) / (rightmost[d] - leftmost[d]) * bins[d]);
+      flat_bin = flat_bin * bins[d] + std::min(bin, bins[d] - 1);
+    }
+    if (d == D) {
+      local_hist[flat_bin] += weight_data ? static_cast<double>(weight_data[i]) : 1.;
+    }
+  }
+}
+
+template <typename scalar_t>
+void histogramdd_cpu_contiguous(
+    Tensor& hist,
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef bins,
+    ArrayRef<double> leftmost,
+    ArrayRef<double> rightmost) {
+  const int64_t N = self.size(0);
+  const int64_t D = self.size(1);
+  const int64_t num_bins = hist.numel();
+  if (N == 0 || num_bins == 0) {
+    return;
+  }
+
+  // Every chunk of the input is binned into a private histogram, so threads
+  // never contend on (or false share) the same bins; the private histograms
+  // are summed up at the end. Chunks are kept large compared to the number of
+  // bins so that the reduction stays cheap.
+  const int64_t num_chunks = std::max<int64_t>(1, std::min<int64_t>(
+      at::get_num_threads(), N / std::max<int64_t>(num_bins, at::internal::GRAIN_SIZE)));
+  const int64_t chunk_size = (N + num_chunks - 1) / num_chunks;
+  // Counts are accumulated in double, which is exact up to 2^53, so float
+  // histograms of large inputs don't saturate at 2^24.
+  std::vector<double> local_hists(num_chunks * num_bins, 0.);
+
+  const scalar_t* self_data = self.data_ptr<scalar_t>();
+  const scalar_t* weight_data = weight.defined() ? weight.data_ptr<scalar_t>() : nullptr;
+  std::vector<scalar_t> lo(D), hi(D);
+  for (int64_t d = 0; d < D; d++) {
+    lo[d] = static_cast<scalar_t>(leftmost[d]);
+    hi[d] = static_cast<scalar_t>(rightmost[d]);
+  }
+
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      double* local_hist = local_hists.data() + c * num_bins;
+      int64_t start = c * chunk_size;
+      int64_t stop = std::min(start + chunk_size, N);
+      if (D == 1) {
+        histogram_1d_chunk<scalar_t>(local_hist, self_data, weight_data, start, stop, bins[0], lo[0], hi[0]);
+      } else {
+        histogram_nd_chunk<scalar_t>(local_hist, self_data, weight_data, start, stop, bins, lo, hi);
+      }
+    }
+  });
+
+  scalar_t* hist_data = hist.data_ptr<scalar_t>();
+  at::parallel_for(0, num_bins, at::internal::GRAIN_SIZE / num_chunks + 1, [&](int64_t begin, int64_t end) {
+    for (int64_t j = begin; j < end; j++) {
+      double sum = 0;
+      for (int64_t c = 0; c < num_chunks; c++) {
+        sum += local_hists[c * num_bins + j];
+      }
+      hist_data[j] += static_cast<scalar_t>(sum);
+    }
+  });
+}
+
+static void histogramdd_kernel_impl(
+    Tensor& hist,
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef bins,
+    ArrayRef<double> leftmost,
+    ArrayRef<double> rightmost) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "histogramdd_cpu", [&] {
+    histogramdd_cpu_contiguous<scalar_t>(hist, self, weight, bins, leftmost, rightmost);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(histogramdd_stub, &histogramdd_kernel_impl);
+
+}} // namespace at::native
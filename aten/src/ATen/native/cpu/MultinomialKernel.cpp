@@ -1,6 +1,8 @@
 #include <ATen/ATen.h>
 
+#include <ATen/CPUGeneratorImpl.h>
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 #include <ATen/native/Copy.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
@@ -136,9 +138,136 @@ static void multinomial_kernel_impl(Tensor& result, const Tensor& self, const in
   });
 }
 
+// Builds the tables for Walker's alias method (using Vose's O(n) construction).
+// Category i is drawn with probability q[i] / n, and otherwise its alias J[i]
+// is drawn, so that a draw only needs a single uniform number and two loads.
+template<typename scalar_t>
+void multinomial_alias_setup_apply(const Tensor& probs, Tensor& J, Tensor& q) {
+  int64_t n_categories = probs.numel();
+  auto probs_contig = probs.contiguous();
+  const scalar_t * const probs_ptr = probs_contig.data_ptr<scalar_t>();
+  int64_t * const J_ptr = J.data_ptr<int64_t>();
+  scalar_t * const q_ptr = q.data_ptr<scalar_t>();
+
+  // Accumulate in double so that tables built from large, unnormalized
+  // weight vectors (e.g. unigram counts) keep their precision.
+  double sum = 0;
+  for (int64_t i = 0; i < n_categories; i++) {
+    double val = static_cast<double>(probs_ptr[i]);
+    TORCH_CHECK(val >= 0, "invalid multinomial distribution (encountering probability entry < 0)");
+    TORCH_CHECK(std::isfinite(val),
+                "invalid multinomial distribution (encountering probability entry = infinity or NaN)");
+    sum += val;
+  }
+  TORCH_CHECK(sum > 0, "invalid multinomial distribution (sum of probabilities <= 0)");
+
+  std::vector<double> scaled(n_categories);
+  std::vector<int64_t> smaller;
+  std::vector<int64_t> larger;
+  smaller.reserve(n_categories);
+  larger.reserve(n_categories);
+  for (int64_t i = 0; i < n_categories; i++) {
+    scaled[i] = static_cast<double>(probs_ptr[i]) * n_categories / sum;
+    J_ptr[i] = i;
+    if (scaled[i] < 1.0) {
+      smaller.push_back(i);
+    } else {
+      larger.push_back(i);
+    }
+  }
+
+  // Pair every under-full category with an over-full one, moving the excess
+  // mass of the larger category into the leftover of the smaller one.
+  while (!smaller.empty() && !larger.empty()) {
+    int64_t small = smaller.back();
+    int64_t large = larger.back();
+    smaller.pop_back();
+
+    J_ptr[small] = large;
+    scaled[large] -= 1.0 - scaled[small];
+    if (scaled[large] < 1.0) {
+      larger.pop_back();
+      smaller.push_back(large);
+    }
+  }
+
+  // Whatever is left over is full up to rounding error.
+  for (int64_t i : larger) {
+    scaled[i] = 1.0;
+  }
+  for (int64_t i : smaller) {
+    scaled[i] = 1.0;
+  }
+
+  for (int64_t i = 0; i < n_categories; i++) {
+    q_ptr[i] = static_cast<scalar_t>(std::min(std::max(scaled[i], 0.0), 1.0));
+  }
+}
+
+static void multinomial_alias_setup_kernel_impl(const Tensor& probs, Tensor& J, Tensor& q) {
+  AT_DISPATCH_FLOATING_TYPES(probs.scalar_type(), "multinomial_alias_setup", [&] {
+    multinomial_alias_setup_apply<scalar_t>(probs, J, q);
+  });
+}
+
+// Number of samples drawn from a single sub-generator. The split of the output
+// only depends on this constant, so results for a given seed are the same
+// regardless of how many threads are used.
+constexpr int64_t ALIAS_DRAW_GRAIN_SIZE = 32768;
+
+template<typename scalar_t>
+void multinomial_alias_draw_apply(Tensor& result, const Tensor& q, const Tensor& J, c10::optional<Generator> generator) {
+  int64_t n_categories = J.numel();
+  int64_t n_sample = result.numel();
+  int64_t n_chunks = (n_sample + ALIAS_DRAW_GRAIN_SIZE - 1) / ALIAS_DRAW_GRAIN_SIZE;
+
+  auto q_contig = q.contiguous();
+  auto J_contig = J.contiguous();
+  const scalar_t * const q_ptr = q_contig.data_ptr<scalar_t>();
+  const int64_t * const J_ptr = J_contig.data_ptr<int64_t>();
+  int64_t * const result_ptr = result.data_ptr<int64_t>();
+
+  // Seed one sub-generator per chunk while holding the lock, so that the
+  // draws themselves can run in parallel without touching the shared state.
+  std::vector<uint64_t> seeds(n_chunks);
+  {
+    auto gen = get_generator_or_default<CPUGeneratorImpl>(generator, detail::getDefaultCPUGenerator());
+    // See Note [Acquire lock when using random generators]
+    std::lock_guard<std::mutex> lock(gen->mutex_);
+    for (int64_t c = 0; c < n_chunks; c++) {
+      seeds[c] = gen->random64();
+    }
+  }
+
+  at::parallel_for(0, n_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      CPUGeneratorImpl chunk_gen(seeds[c]);
+      at::uniform_real_distribution<double> uniform(0, n_categories);
+      int64_t start = c * ALIAS_DRAW_GRAIN_SIZE;
+      int64_t stop = std::min(start + ALIAS_DRAW_GRAIN_SIZE, n_sample);
+      for (int64_t i = start; i < stop; i++) {
+        // The integral part picks the column, the fractional part decides
+        // between the column and its alias.
+        double u = uniform(&chunk_gen);
+        int64_t idx = std::min(static_cast<int64_t>(u), n_categories - 1);
+        double frac = u - idx;
+        result_ptr[i] = frac < static_cast<double>(q_ptr[idx]) ? idx : J_ptr[idx];
+      }
+    }
+  });
+}
+
+static void multinomial_alias_draw_kernel_impl(Tensor& result, const Tensor& q, const Tensor& J, c10::optional<Generator> gen) {
+  AT_DISPATCH_FLOATING_TYPES(q.scalar_type(), "multinomial_alias_draw", [&] {
+    multinomial_alias_draw_apply<scalar_t>(result, q, J, gen);
+  });
+}
+
 }
 
 REGISTER_DISPATCH(multinomial_stub, &multinomial_kernel_impl);
+REGISTER_DISPATCH(multinomial_alias_setup_stub, &multinomial_alias_setup_kernel_impl);
+REGISTER_DISPATCH(multinomial_alias_draw_stub, &multinomial_alias_draw_kernel_impl);
 
 }
 }
@@ -16,12 +16,18 @@ namespace at {
 #  pragma GCC diagnostic ignored "-Wattributes"
 #endif
 enum class TORCH_API RecordScope : uint8_t {
-  // c10/ATen ops, autograd nodes
+  // c10/ATen ops
   FUNCTION = 0,
   // TorchScript functions, methods
   TORCHSCRIPT_FUNCTION,
   // User defined scope (e.g. with record_function())
   USER_SCOPE,
+  // Autograd nodes run by the engine during backward
+  BACKWARD_FUNCTION,
+  // Chunks of at::parallel_for run by the intra-op thread pool
+  INTRAOP_TASK,
+  // Tasks run by the inter-op thread pool (at::launch)
+  INTEROP_TASK,
   NUM_SCOPES, // must be the last in the list
 };
 #ifndef _MSC_VER
@@ -116,6 +122,12 @@ struct TORCH_API RecordFunction {
   // Current returns the currently active RecordFunction in this thread.
   static RecordFunction* current();
 
+  // The RecordFunction that was current() when this one was made current
+  // (see _setCurrent), if any.
+  inline RecordFunction* parent() const {
+    return parent_;
+  }
+
   // Returns logical thread_id for the current thread
   static uint64_t currentThreadId();
 
@@ -8,6 +8,13 @@ def add_tensors_loop(x, y):
         z = torch.add(z, x)
     return z
 
+def add_tensors_loop_boxed(x, y):
+    # torch.ops calls go through the boxed dispatcher API even in eager mode
+    z = torch.ops.aten.add(x, y)
+    for i in range(NUM_LOOP_ITERS):
+        z = torch.ops.aten.add(z, x)
+    return z
+
 class SimpleAddModule(torch.nn.Module):
     def __init__(self, add_op):
         super(SimpleAddModule, self).__init__()
@@ -1,15 +1,17 @@
 from __future__ import absolute_import, division, print_function, unicode_literals
-from utils import ms_to_us, benchmark_module, BenchmarkConfig, ModuleConfig
+from utils import ms_to_us, ms_to_ns, benchmark_module, BenchmarkConfig, ModuleConfig
 import argparse
 from C2Module import C2SimpleNet
 
-from SimpleAddModule import SimpleAddModule, add_tensors_loop
+from SimpleAddModule import SimpleAddModule, add_tensors_loop, add_tensors_loop_boxed
 from pt_wrapper_module import WrapperModule
 
 """ Framework overhead benchmark script.
 Benchmark framework overhead.
-Currently supported ops: add.
+Currently supported ops: add, and add called through torch.ops (dispatch_op).
 As of now runs only forward pass.
+Inputs are single element tensors, so the latency per op is mostly the cost of
+dispatching the op (argument parsing, dispatcher, kernel call).
 Supports both graph mode and eager mode. In graph mode the module is traced via JIT tracing.
 Debug option prints the traced graph is graph_mode is enabled.
 Graph can be saved via save option. Saved in the directory where benchmark is run.
@@ -22,9 +24,12 @@ buck run @mode/opt <path-to-framework_overhead_benchmark>:framework_overhead_ben
 To run C2 benchmark:
 buck run @mode/opt <path-to-framework_overhead_benchmark>:framework_overhead_benchmark --
  --add_op --benchmark_c2_net
+To benchmark the boxed dispatcher path in eager mode:
+buck run @mode/opt <path-to-framework_overhead_benchmark>:framework_overhead_benchmark --
+ --op dispatch_op --eager_mode
 """
 
-SUPPORTED_OPS = {"add_op"}
+SUPPORTED_OPS = {"add_op", "dispatch_op"}
 
 def parse_op_args(op):
     op_list = ops.split(",")
@@ -32,7 +37,7 @@ def parse_op_args(op):
 def print_results(result):
     print("===================================")
     for key, value in result.items():
-        print("{}, latency per iter (us):{}".format(key, ms_to_us(value)))
+        print("{}, latency per iter (us):{}, latency per op (ns):{:.1f}".format(key, ms_to_us(value), ms_to_ns(value)))
     print("===================================")
 
 def benchmark_simple_fn(args, config, module_config, module_type, result):
@@ -94,6 +99,10 @@ def main():
         else:
             module_config = ModuleConfig(add_tensors_loop, None, num_params, graph_mode)
         benchmark_simple_fn(args, config, module_config, SimpleAddModule, result)
+    elif args.op == "dispatch_op":
+        assert not args.benchmark_c2_net, "dispatch_op has no C2 equivalent"
+        module_config = ModuleConfig(add_tensors_loop_boxed, None, 2, graph_mode)
+        benchmark_simple_fn(args, config, module_config, SimpleAddModule, result)
     print_results(result)
 
 if __name__ == "__main__":
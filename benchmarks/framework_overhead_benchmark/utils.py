@@ -10,6 +10,9 @@ ModuleConfig = namedtuple('ModuleConfig', 'pt_fn c2_op num_params graph_mode')
 def ms_to_us(time_ms):
     return (time_ms * 1e3)
 
+def ms_to_ns(time_ms):
+    return (time_ms * 1e6)
+
 def secs_to_us(time_s):
     return (time_s * 1e6)
 
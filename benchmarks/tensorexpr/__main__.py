@@ -7,6 +7,7 @@ from . import tensor_engine
 from . import attention      # noqa: F401
 from . import broadcast      # noqa: F401
 # from . import conv           # noqa: F401
+from . import cpu_schedule   # noqa: F401
 from . import elementwise    # noqa: F401
 from . import matmul         # noqa: F401
 # from . import normalization  # noqa: F401
@@ -0,0 +1,55 @@
+from . import benchmark
+
+
+# Pointwise kernels in the shapes the CPU schedule of the fuser distinguishes:
+# one long row, fewer rows than threads, many rows, and short rows with tails
+# for vectorization. Compare the fused kernels with the eager TensorIterator
+# loops by running it with `--jit_mode trace` and `--jit_mode none`.
+class CpuScheduleBench(benchmark.Benchmark):
+    def __init__(self, mode, device, M, N):
+        super().__init__(mode, device)
+        self.M = M
+        self.N = N
+        self.x = self.rand([M, N], device=device, requires_grad=self.requires_grad)
+        self.y = self.rand([N], device=device, requires_grad=self.requires_grad)
+        self.z = self.rand([M, N], device=device, requires_grad=self.requires_grad)
+        self.inputs = [self.x, self.y, self.z]
+        self.deterministic = True
+
+    def forward(self, x, y, z):
+        return (x * y + z).relu() * 0.5
+
+    def reference(self):
+        x, y, z = [self.numpy(t) for t in self.inputs]
+        return (x * y + z).clip(min=0) * 0.5
+
+    def config(self):
+        return [self.M, self.N]
+
+    @staticmethod
+    def module():
+        return "cpu_schedule"
+
+    def is_supported(self):
+        return self.device == "cpu" and self.mode == "fwd"
+
+    def memory_workload(self):
+        buffer_size = self.M * self.N * 4
+        # Eager writes a temporary between each of the 4 ops, and reads it
+        # back.
+        return {
+            "sol": buffer_size * 3 + self.N * 4,
+            "algorithmic": buffer_size * (3 + 3 * 2) + self.N * 4,
+        }
+
+    @staticmethod
+    def default_configs():
+        return [
+            [1, 1 << 22],
+            [4, 1 << 20],
+            [1024, 1024],
+            [1 << 16, 37],
+        ]
+
+
+benchmark.register_benchmark_class(CpuScheduleBench)
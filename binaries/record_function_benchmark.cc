@@ -1,5 +1,7 @@
 #include <torch/torch.h>
 #include <ATen/record_function.h>
+#include <torch/csrc/autograd/profiler.h>
+#include <torch/csrc/autograd/profiler_sampled.h>
 
 #include "c10/util/Flags.h"
 
@@ -9,6 +11,10 @@
 
 C10_DEFINE_int(iter, 100, "Number of iterations");
 C10_DEFINE_int(warmup_iter, 10, "Number of warmup iterations")
+C10_DEFINE_double(
+    profiler_sampling_prob,
+    0.01,
+    "Sampling probability used for the sampled profiler runs");
 
 namespace {
 const int kInnerIter = 100;
@@ -55,25 +61,53 @@ float runBench(int tensor_size, int outer_iter) {
   return duration;
 }
 
+void runBenchmarks(const std::string& name) {
+  for (auto tensor_size : std::set<int>({kSmallTensorSize, kTensorSize})) {
+    auto duration = runBench(tensor_size, FLAGS_iter);
+    std::cout << name
+              << ", time per iteration ("
+              << tensor_size
+              << "x"
+              << tensor_size
+              << "): " << (duration/FLAGS_iter)
+              << " us." << std::endl;
+  }
+}
+
 int main(int argc, char** argv) {
   if (!c10::ParseCommandLineFlags(&argc, &argv)) {
     std::cout << "Failed to parse command line flags" << std::endl;
     return -1;
   }
 
-  setupCallbacks();
-
   auto duration = runBench(kSmallTensorSize, FLAGS_warmup_iter);
   std::cout << "Warmup time: " << duration << " us." << std::endl;
 
-  for (auto tensor_size : std::set<int>({kSmallTensorSize, kTensorSize})) {
-    duration = runBench(tensor_size, FLAGS_iter);
-    std::cout << "Time per iteration ("
-              << tensor_size
-              << "x"
-              << tensor_size
-              << "): " << (duration/FLAGS_iter)
-              << " us." << std::endl;
+  runBenchmarks("No callbacks");
+
+  setupCallbacks();
+  runBenchmarks("Empty callbacks");
+  at::clearCallbacks();
+
+  // Overhead of the profilers, relative to "No callbacks"
+  {
+    using namespace torch::autograd::profiler;
+    enableProfiler(ProfilerConfig(
+        ProfilerState::CPU,
+        /* report_input_shapes */ false,
+        /* profile_memory */ false));
+    runBenchmarks("Autograd profiler");
+    disableProfiler();
+
+    for (double prob : {1.0, FLAGS_profiler_sampling_prob}) {
+      SampledProfilerConfig config;
+      config.sampling_prob = prob;
+      enableSampledProfiler(std::move(config));
+      runBenchmarks("Sampled profiler (p = " + std::to_string(prob) + ")");
+      disableSampledProfiler();
+      std::cout << "Dropped events: " << sampledProfilerDroppedEvents()
+                << std::endl;
+    }
   }
 
   return 0;
@@ -1,5 +1,6 @@
 #include <c10/core/CPUAllocator.h>
 #include <c10/core/DeviceType.h>
+#include <c10/util/FreeList.h>
 
 // TODO: rename flags to C10
 C10_DEFINE_bool(
@@ -36,6 +37,10 @@ void memset_junk(void* data, size_t num) {
   }
 }
 
+// Moves newly allocated memory to the NUMA node of the thread, and zero or
+// junk fills it if requested
+static void fill_cpu_allocation(void* data, size_t nbytes);
+
 void* alloc_cpu(size_t nbytes) {
   if (nbytes == 0) {
     return nullptr;
@@ -71,6 +76,11 @@ void* alloc_cpu(size_t nbytes) {
       nbytes,
       " bytes. Buy new RAM!");
 
+  fill_cpu_allocation(data, nbytes);
+  return data;
+}
+
+void fill_cpu_allocation(void* data, size_t nbytes) {
   // move data to a thread's NUMA node
   NUMAMove(data, nbytes, GetCurrentNUMANode());
   CHECK(
@@ -82,8 +92,6 @@ void* alloc_cpu(size_t nbytes) {
   } else if (FLAGS_caffe2_cpu_allocator_do_junk_fill) {
     memset_junk(data, nbytes);
   }
-
-  return data;
 }
 
 void free_cpu(void* data) {
@@ -94,15 +102,48 @@ void free_cpu(void* data) {
 #endif
 }
 
+namespace {
+// The data of tensors with a few elements (scalars, in particular) is
+// allocated as blocks of kSmallAllocationSize bytes, which are recycled
+// through a per-thread free list.
+constexpr size_t kSmallAllocationSize = gAlignment;
+
+struct SmallCPUAllocationFreeListTraits {
+  static constexpr size_t kMaxCached = 1024;
+  static void release(void* block) {
+    free_cpu(block);
+  }
+};
+using SmallCPUAllocationFreeList =
+    ThreadLocalFreeList<SmallCPUAllocationFreeListTraits>;
+} // namespace
+
 struct C10_API DefaultCPUAllocator final : at::Allocator {
   DefaultCPUAllocator() {}
   ~DefaultCPUAllocator() override {}
   at::DataPtr allocate(size_t nbytes) const override {
+    if (nbytes > 0 && nbytes <= kSmallAllocationSize) {
+      void* data = SmallCPUAllocationFreeList::pop();
+      if (data) {
+        fill_cpu_allocation(data, kSmallAllocationSize);
+      } else {
+        data = alloc_cpu(kSmallAllocationSize);
+      }
+      profiledCPUMemoryReporter().New(data, nbytes);
+      return {data, data, &ReportAndRecycle, at::Device(at::DeviceType::CPU)};
+    }
     void* data = alloc_cpu(nbytes);
     profiledCPUMemoryReporter().New(data, nbytes);
     return {data, data, &ReportAndDelete, at::Device(at::DeviceType::CPU)};
   }
 
+  // Small allocations come from alloc_cpu too, so they can also be freed
+  // with ReportAndDelete (e.g. by raw_deallocate); they just aren't recycled.
+  static void ReportAndRecycle(void* ptr) {
+    profiledCPUMemoryReporter().Delete(ptr);
+    SmallCPUAllocationFreeList::push(ptr);
+  }
+
   static void ReportAndDelete(void* ptr) {
     if (!ptr) {
       return;
@@ -225,6 +225,11 @@ enum class DispatchKey : uint8_t {
   // batching rules for vmap.
   Batched,
 
+  // This is the dispatch key of the lazy eager mode (see
+  // torch/csrc/jit/runtime/lazy_eager.h), which defers pointwise ops to fuse
+  // them. It is only ever set in the TLS included set, not on tensors.
+  Lazy,
+
   // TESTING: This is intended to be a generic testing tensor type id.
   // Don't use it for anything real; its only acceptable use is within a single
   // process test.  Use it by creating a TensorImpl with this DispatchKey, and
@@ -1 +1,26 @@
 #include <c10/core/StorageImpl.h>
+
+#include <c10/util/FreeList.h>
+
+namespace c10 {
+
+namespace {
+struct StorageImplFreeListTraits {
+  static constexpr size_t kMaxCached = 1024;
+  static void release(void* block) {
+    ::operator delete(block);
+  }
+};
+using StorageImplFreeList = ThreadLocalFreeList<StorageImplFreeListTraits>;
+} // namespace
+
+void* StorageImpl::operator new(size_t size) {
+  void* block = StorageImplFreeList::pop();
+  return block ? block : ::operator new(size);
+}
+
+void StorageImpl::operator delete(void* ptr, size_t /*size*/) {
+  StorageImplFreeList::push(ptr);
+}
+
+} // namespace c10
@@ -47,6 +47,11 @@ struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
   StorageImpl(const StorageImpl&) = delete;
   ~StorageImpl() = default;
 
+  // StorageImpls are recycled through a per-thread free list, since creating
+  // a small tensor otherwise mallocs a StorageImpl, a TensorImpl and the data.
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr, size_t size);
+
   void reset() {
     data_ptr_.clear();
     size_bytes_ = 0;
@@ -3,6 +3,7 @@
 #include <c10/core/Backend.h>
 #include <c10/core/WrapDimMinimal.h>
 #include <c10/core/impl/LocalDispatchKeySet.h>
+#include <c10/util/FreeList.h>
 #include <c10/util/Optional.h>
 
 C10_DEFINE_bool(
@@ -28,6 +29,35 @@ const char * const TensorImpl::err_msg_tensor_metadata_change_not_allowed =
     "    with torch.no_grad():\n"
     "        x.set_(y)";
 
+namespace {
+struct TensorImplFreeListTraits {
+  static constexpr size_t kMaxCached = 1024;
+  static void release(void* block) {
+    ::operator delete(block);
+  }
+};
+using TensorImplFreeList = ThreadLocalFreeList<TensorImplFreeListTraits>;
+} // namespace
+
+void* TensorImpl::operator new(size_t size) {
+  if (size == sizeof(TensorImpl)) {
+    void* block = TensorImplFreeList::pop();
+    if (block) {
+      return block;
+    }
+  }
+  return ::operator new(size);
+}
+
+void TensorImpl::operator delete(void* ptr, size_t size) {
+  // Thanks to the virtual destructor, size is the one of the dynamic type
+  if (size == sizeof(TensorImpl)) {
+    TensorImplFreeList::push(ptr);
+  } else {
+    ::operator delete(ptr);
+  }
+}
+
 at::Tensor& TensorImpl::grad() {
   if (!autograd_meta_) autograd_meta_ = impl::GetAutogradMetaFactory()->make();
   return autograd_meta_->grad();
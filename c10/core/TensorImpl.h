@@ -355,6 +355,12 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
   TensorImpl(TensorImpl&&) = default;
   TensorImpl& operator=(TensorImpl&&) = default;
 
+  // TensorImpls (but not the bigger ones of subclasses) are recycled through
+  // a per-thread free list, since creating a small tensor otherwise mallocs a
+  // TensorImpl, a StorageImpl and the data.
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr, size_t size);
+
   /**
    * Release (decref) storage, and any other external allocations.  This
    * override is for `intrusive_ptr_target` and is used to implement weak
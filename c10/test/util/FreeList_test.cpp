@@ -0,0 +1,66 @@
+#include <c10/util/FreeList.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace {
+
+int num_released = 0;
+
+struct TestFreeListTraits {
+  static constexpr size_t kMaxCached = 2;
+  static void release(void* block) {
+    ++num_released;
+    ::operator delete(block);
+  }
+};
+using TestFreeList = c10::ThreadLocalFreeList<TestFreeListTraits>;
+
+} // namespace
+
+#ifndef C10_FREE_LIST_DISABLED
+
+TEST(ThreadLocalFreeListTest, givenEmptyFreeList_whenPopping_thenReturnsNull) {
+  EXPECT_EQ(nullptr, TestFreeList::pop());
+}
+
+TEST(ThreadLocalFreeListTest, givenPushedBlocks_whenPopping_thenReturnsThemLastInFirstOut) {
+  void* a = ::operator new(16);
+  void* b = ::operator new(16);
+  TestFreeList::push(a);
+  TestFreeList::push(b);
+  EXPECT_EQ(b, TestFreeList::pop());
+  EXPECT_EQ(a, TestFreeList::pop());
+  EXPECT_EQ(nullptr, TestFreeList::pop());
+  ::operator delete(a);
+  ::operator delete(b);
+}
+
+TEST(ThreadLocalFreeListTest, givenFullFreeList_whenPushing_thenReleasesBlock) {
+  num_released = 0;
+  void* blocks[3] = {::operator new(16), ::operator new(16), ::operator new(16)};
+  for (void* block : blocks) {
+    TestFreeList::push(block);
+  }
+  EXPECT_EQ(1, num_released);
+  for (int i = 0; i < 2; ++i) {
+    void* block = TestFreeList::pop();
+    EXPECT_NE(nullptr, block);
+    ::operator delete(block);
+  }
+  EXPECT_EQ(nullptr, TestFreeList::pop());
+}
+
+TEST(ThreadLocalFreeListTest, givenBlocksCachedByThread_whenThreadExits_thenReleasesThem) {
+  num_released = 0;
+  std::thread t([] {
+    TestFreeList::push(::operator new(16));
+    TestFreeList::push(::operator new(16));
+  });
+  t.join();
+  EXPECT_EQ(2, num_released);
+  // blocks are cached per thread
+  EXPECT_EQ(nullptr, TestFreeList::pop());
+}
+
+#endif
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <c10/macros/Macros.h>
+
+#include <cstddef>
+#include <vector>
+
+#if defined(__SANITIZE_ADDRESS__)
+#define C10_FREE_LIST_DISABLED
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define C10_FREE_LIST_DISABLED
+#endif
+#endif
+
+namespace c10 {
+
+/**
+ * A per-thread cache of free memory blocks of a single size, to recycle the
+ * memory of small objects that are created and destroyed at a high rate
+ * (e.g. the TensorImpls of scalars) instead of going through malloc and free
+ * every time.
+ *
+ * Traits provides:
+ *   - static constexpr size_t kMaxCached: the number of blocks each thread
+ *     keeps, beyond which freed blocks are released;
+ *   - static void release(void* block): frees a block for good.
+ *
+ * Blocks are not tied to the thread that allocated them: a block freed on
+ * another thread just goes to that thread's cache. Nothing is cached when
+ * building with AddressSanitizer, so that it still catches use-after-free.
+ */
+template <class Traits>
+class ThreadLocalFreeList final {
+ public:
+  // Returns a cached block, or nullptr if the cache of this thread is empty.
+  static void* pop() {
+    Cache* cache = local();
+    if (cache == nullptr || cache->blocks.empty()) {
+      return nullptr;
+    }
+    void* block = cache->blocks.back();
+    cache->blocks.pop_back();
+    return block;
+  }
+
+  // Caches `block`, or releases it if the cache of this thread is full.
+  static void push(void* block) {
+    Cache* cache = local();
+    if (cache == nullptr || cache->blocks.size() >= Traits::kMaxCached) {
+      Traits::release(block);
+      return;
+    }
+    cache->blocks.push_back(block);
+  }
+
+ private:
+  struct Cache final {
+    Cache() {
+      blocks.reserve(Traits::kMaxCached);
+    }
+    ~Cache() {
+      for (void* block : blocks) {
+        Traits::release(block);
+      }
+      destroyed() = true;
+    }
+    std::vector<void*> blocks;
+  };
+
+  // Objects may be freed by the destructors of other thread locals after
+  // the cache of the thread was destroyed; they don't get cached.
+  static bool& destroyed() {
+    static thread_local bool destroyed = false;
+    return destroyed;
+  }
+
+  static Cache* local() {
+#ifdef C10_FREE_LIST_DISABLED
+    return nullptr;
+#else
+    if (C10_UNLIKELY(destroyed())) {
+      return nullptr;
+    }
+    static thread_local Cache cache;
+    return &cache;
+#endif
+  }
+};
+
+} // namespace c10
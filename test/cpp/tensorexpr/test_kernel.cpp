@@ -105,5 +105,117 @@ void testKernel_3() {
   }
 }
 
+void testKernelSoftmax() {
+  KernelScope kernel_scope;
+
+  const auto graph_string = R"IR(
+      graph(%0 : Float(5:16,16:1),
+            %1 : Float(16:1)):
+        %2 : int = prim::Constant[value=1]()
+        %3 : int = prim::Constant[value=-1]()
+        %4 : None = prim::Constant()
+        %5 : Float(5:16,16:1) = aten::add(%0, %1, %2)
+        %6 : Float(5:16,16:1) = aten::softmax(%5, %3, %4)
+        return (%6))IR";
+  auto graph = std::make_shared<Graph>();
+  parseIR(graph_string, &*graph);
+
+  auto a = at::randn({5, 16}, TensorOptions(kCPU).dtype(at::kFloat)) * 10;
+  auto b = at::randn({16}, TensorOptions(kCPU).dtype(at::kFloat));
+  auto ref = at::softmax(a + b, -1);
+  TensorExprKernel k(graph);
+  std::vector<at::Tensor> inputs = {a, b};
+
+  std::vector<IValue> stack = fmap<IValue>(inputs);
+  k.run(stack);
+  auto o = stack[0].toTensor();
+  ASSERT_TRUE(at::allclose(o, ref, 1e-5, 1e-6));
+}
+
+void testKernelSumLastAxis() {
+  KernelScope kernel_scope;
+
+  const auto graph_string = R"IR(
+      graph(%0 : Float(3:64,64:1)):
+        %1 : int[] = prim::Constant[value=[-1]]()
+        %2 : bool = prim::Constant[value=1]()
+        %3 : None = prim::Constant()
+        %4 : Float(3:1,1:1) = aten::sum(%0, %1, %2, %3)
+        return (%4))IR";
+  auto graph = std::make_shared<Graph>();
+  parseIR(graph_string, &*graph);
+
+  auto a = at::rand({3, 64}, TensorOptions(kCPU).dtype(at::kFloat));
+  auto ref = a.sum(-1, true);
+  TensorExprKernel k(graph);
+  std::vector<at::Tensor> inputs = {a};
+
+  std::vector<IValue> stack = fmap<IValue>(inputs);
+  k.run(stack);
+  auto o = stack[0].toTensor();
+  ASSERT_EQ(o.sizes(), ref.sizes());
+  ASSERT_TRUE(at::allclose(o, ref, 1e-5, 1e-6));
+}
+
+void testKernelSymbolicShapes() {
+  KernelScope kernel_scope;
+
+  const auto graph_string = R"IR(
+      graph(%0 : Float(5:16,16:1),
+            %1 : Float(16:1)):
+        %2 : int = prim::Constant[value=1]()
+        %3 : int[] = prim::Constant[value=[-1]]()
+        %4 : None = prim::Constant()
+        %5 : Float(5:16,16:1) = aten::add(%0, %1, %2)
+        %6 : Float(5:1,1:1) = aten::mean(%5, %3, %2, %4)
+        return (%6))IR";
+  auto graph = std::make_shared<Graph>();
+  parseIR(graph_string, &*graph);
+  // Make the sizes of the inputs symbolic, and their strides unknown.
+  for (Value* input : graph->inputs()) {
+    auto type = input->type()->expect<TensorType>();
+    std::vector<c10::ShapeSymbol> dims;
+    for (size_t i = 0; i < *type->dim(); i++) {
+      dims.push_back(c10::ShapeSymbol::newSymbol());
+    }
+    input->setType(TensorType::create(
+        at::kFloat,
+        at::Device(at::kCPU),
+        c10::SymbolicShape(dims),
+        c10::VaryingShape<c10::Stride>(*type->dim()),
+        false));
+  }
+  TensorExprKernel k(graph);
+
+  // The same kernel runs on any sizes.
+  for (auto const& sizes : std::vector<std::vector<int64_t>>{
+           {5, 16}, {7, 3}, {2, 100}}) {
+    auto a = at::rand(sizes, TensorOptions(kCPU).dtype(at::kFloat));
+    auto b = at::rand({sizes[1]}, TensorOptions(kCPU).dtype(at::kFloat));
+    auto ref = (a + b).mean(-1, true);
+    std::vector<IValue> stack = fmap<IValue>(std::vector<at::Tensor>{a, b});
+    k.run(stack);
+    auto o = stack[0].toTensor();
+    ASSERT_EQ(o.sizes(), ref.sizes());
+    ASSERT_TRUE(at::allclose(o, ref, 1e-5, 1e-6));
+  }
+
+  // Inputs that break the assumptions of the kernel on their shapes, i.e.
+  // that are broadcast along a symbolic dim or not contiguous, run the
+  // interpreter.
+  std::vector<std::vector<at::Tensor>> fallbackInputs = {
+      {at::rand({4, 8}), at::rand({1})},
+      {at::rand({8, 4}).t(), at::rand({8})},
+  };
+  for (auto const& inputs : fallbackInputs) {
+    auto ref = (inputs[0] + inputs[1]).mean(-1, true);
+    std::vector<IValue> stack = fmap<IValue>(inputs);
+    k.run(stack);
+    auto o = stack[0].toTensor();
+    ASSERT_EQ(o.sizes(), ref.sizes());
+    ASSERT_TRUE(at::allclose(o, ref, 1e-5, 1e-6));
+  }
+}
+
 } // namespace jit
 } // namespace torch
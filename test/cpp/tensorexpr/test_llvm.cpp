@@ -1213,6 +1213,42 @@ void testLLVMDynamicShape2D() {
   testWithSize(37, 11);
 }
 
+void testLLVMParallelFor() {
+  KernelScope kernel_scope;
+  auto testWithLoop = [](size_t loopIndex) {
+    VarHandle m("m", kInt);
+    VarHandle n("n", kInt);
+    Buffer a(BufHandle("a", {m, n}, kFloat));
+    Buffer b(BufHandle("b", {m, n}, kFloat));
+    Tensor* c = Compute(
+        "c", {{m, "m"}, {n, "n"}}, [&](const VarHandle& i, const VarHandle& j) {
+          return a(i, j) + b(i, j) * Cast::make(kFloat, i);
+        });
+    LoopNest l({c});
+    l.parallelize(l.getLoopStmtsFor(c).at(loopIndex));
+    l.prepareForCodegen();
+    Stmt* s = l.root_stmt();
+    LLVMCodeGen cg(s, {a, b, c, m, n});
+
+    const int M = 37;
+    const int N = 11;
+    std::vector<float> aData(M * N, 1.0f);
+    std::vector<float> bData(M * N, 2.0f);
+    std::vector<float> cData(M * N, 0.0f);
+    std::vector<float> cRef(M * N);
+    for (int i = 0; i < M; i++) {
+      for (int j = 0; j < N; j++) {
+        cRef[i * N + j] = 1.0f + 2.0f * i;
+      }
+    }
+    cg.call({aData, bData, cData, M, N});
+    ExpectAllNear(cData, cRef, 1e-7);
+  };
+  // The outer loop, and the inner one, which uses the index of the outer one.
+  testWithLoop(0);
+  testWithLoop(1);
+}
+
 void testLLVMEmptyStmt() {
   KernelScope kernel_scope;
   Stmt* s = new Block({});
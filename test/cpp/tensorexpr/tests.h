@@ -191,6 +191,9 @@ namespace jit {
   _(Kernel_1)                               \
   _(Kernel_2)                               \
   _(Kernel_3)                               \
+  _(KernelSoftmax)                          \
+  _(KernelSumLastAxis)                      \
+  _(KernelSymbolicShapes)                   \
   _(FuserPass_1)                            \
   _(FuserPass_2)
 
@@ -310,6 +313,7 @@ namespace jit {
   _(LLVMBindDynamicShapeAdd)               \
   _(LLVMTensorDynamicShapeAdd)             \
   _(LLVMDynamicShape2D)                    \
+  _(LLVMParallelFor)                       \
   _(LLVMEmptyStmt)                         \
   _(LLVMEliminatedStmt)                    \
   _(LLVMIfThenElseTest)                    \
@@ -0,0 +1,78 @@
+import os
+import sys
+
+import torch
+from torch.testing import FileCheck
+
+# Make the helper files in test/ importable
+pytorch_test_dir = os.path.dirname(os.path.dirname(os.path.realpath(__file__)))
+sys.path.append(pytorch_test_dir)
+from torch.testing._internal.jit_utils import JitTestCase
+
+if __name__ == '__main__':
+    raise RuntimeError("This test file is not meant to be run directly, use:\n\n"
+                       "\tpython test/test_jit.py TESTNAME\n\n"
+                       "instead.")
+
+class TestCatElimination(JitTestCase):
+    def _eliminate(self, fn, inputs):
+        graph = torch.jit.script(fn).graph.copy()
+        torch._C._jit_pass_complete_shape_analysis(graph, inputs, False)
+        self.run_pass('eliminate_cat_copies', graph)
+        return graph, torch._C._create_function_from_graph("eliminated", graph)
+
+    def test_producers_write_in_place(self):
+        def fn(x, y, z):
+            a = x * y
+            b = torch.sigmoid(z)
+            return torch.cat([a, b], dim=1)
+
+        inputs = (torch.rand(4, 3), torch.rand(4, 3), torch.rand(4, 5))
+        graph, eliminated = self._eliminate(fn, inputs)
+        FileCheck().check("aten::empty").check("aten::narrow").check("aten::mul") \
+            .check("aten::narrow").check("aten::sigmoid").check_not("aten::cat") \
+            .check_not("aten::copy_").run(graph)
+        self.assertEqual(eliminated(*inputs), fn(*inputs))
+
+    def test_ineligible_inputs_are_copied(self):
+        def fn(x, y):
+            a = x + y
+            b = x * y
+            # graph inputs and values with other uses can't be written in place
+            return torch.cat([x, a, b, a], dim=-2), a
+
+        inputs = (torch.rand(2, 3), torch.rand(2, 3))
+        graph, eliminated = self._eliminate(fn, inputs)
+        FileCheck().check_not("aten::cat").check("aten::mul").check("aten::copy_").run(graph)
+        self.assertEqual(eliminated(*inputs), fn(*inputs))
+
+    def test_requires_grad_not_eliminated(self):
+        def fn(x, y):
+            return torch.cat([x * 2, y * 3])
+
+        graph = torch.jit.script(fn).graph.copy()
+        inputs = (torch.rand(2, 3, requires_grad=True), torch.rand(2, 3))
+        torch._C._jit_pass_complete_shape_analysis(graph, inputs, False)
+        self.run_pass('eliminate_cat_copies', graph)
+        FileCheck().check("aten::cat").check_not("aten::empty").run(graph)
+
+    def test_incomplete_shapes_not_eliminated(self):
+        def fn(x, y):
+            return torch.cat([x * 2, y * 3])
+
+        graph = torch.jit.script(fn).graph
+        self.run_pass('eliminate_cat_copies', graph)
+        FileCheck().check("aten::cat").check_not("aten::empty").run(graph)
+
+    def test_slice_types_have_buffer_strides(self):
+        def fn(x, y, z):
+            return torch.cat([x * y, torch.sigmoid(z)], dim=1)
+
+        inputs = (torch.rand(4, 3), torch.rand(4, 3), torch.rand(4, 5))
+        graph, eliminated = self._eliminate(fn, inputs)
+        # the slices of the (4, 8) buffer, and what's written into them, aren't
+        # contiguous
+        for kind in ["aten::narrow", "aten::mul", "aten::sigmoid"]:
+            for node in graph.findAllNodes(kind):
+                self.assertEqual(node.output().type().strides(), [8, 1])
+        self.assertEqual(eliminated(*inputs), fn(*inputs))
@@ -928,6 +928,53 @@ class TestFreezing(JitTestCase):
 
 
 
+    def test_freeze_module_fuse_sibling_linears(self):
+        class Heads(nn.Module):
+            def __init__(self):
+                super(Heads, self).__init__()
+                self.q = nn.Linear(8, 4)
+                self.k = nn.Linear(8, 4)
+                self.v = nn.Linear(8, 6)
+                self.no_bias = nn.Linear(8, 3, bias=False)
+                self.other_input = nn.Linear(4, 2)
+
+            def forward(self, x, y):
+                return self.q(x), self.k(x), self.v(x), self.no_bias(x), self.other_input(y)
+
+        m = torch.jit.script(Heads())
+        m.eval()
+        mf = torch._C._freeze_module(m._c)
+        graph = mf._get_method('forward').graph
+        # the linears of x are fused, and F.linear's check of the input's rank is gone
+        FileCheck().check_count("aten::linear", 2, exactly=True).run(graph)
+        FileCheck().check_count("aten::narrow", 4, exactly=True).run(graph)
+        FileCheck().check_not("prim::If").run(graph)
+        for x, y in [(torch.rand(5, 8), torch.rand(5, 4)), (torch.rand(2, 5, 8), torch.rand(2, 5, 4))]:
+            self.assertEqual(mf.forward(x, y), m(x, y))
+
+    def test_freeze_module_fuse_sibling_linears_view(self):
+        class Heads(nn.Module):
+            def __init__(self):
+                super(Heads, self).__init__()
+                self.a = nn.Linear(8, 4)
+                self.b = nn.Linear(8, 6)
+
+            def forward(self, x):
+                # merging the last dim of a slice of the fused output needs it
+                # to be contiguous
+                return self.a(x).view(-1) + 1, torch.relu(self.b(x))
+
+        m = torch.jit.script(Heads())
+        m.eval()
+        mf = torch._C._freeze_module(m._c)
+        graph = mf._get_method('forward').graph
+        FileCheck().check_count("aten::linear", 1, exactly=True).run(graph)
+        FileCheck().check("aten::narrow").check("aten::contiguous").check("aten::view").run(graph)
+        # relu doesn't care about strides, so b's slice stays a view
+        FileCheck().check_count("aten::contiguous", 1, exactly=True).run(graph)
+        x = torch.rand(5, 8)
+        self.assertEqual(mf.forward(x), m(x))
+
     def test_freeze_module_detach_gradient(self):
         mod = nn.Conv2d(8, 3, 4, 2, 1)
         self.assertTrue(mod.weight.requires_grad)
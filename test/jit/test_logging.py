@@ -1,5 +1,6 @@
 import os
 import sys
+import unittest
 
 import torch
 
@@ -7,6 +8,7 @@ import torch
 pytorch_test_dir = os.path.dirname(os.path.dirname(os.path.realpath(__file__)))
 sys.path.append(pytorch_test_dir)
 from torch.testing._internal.jit_utils import JitTestCase
+from torch.testing._internal.common_utils import GRAPH_EXECUTOR, ProfilingMode
 
 if __name__ == '__main__':
     raise RuntimeError("This test file is not meant to be run directly, use:\n\n"
@@ -111,3 +113,51 @@ class TestLogging(JitTestCase):
             self.assertEqual(logger.get_counter_val('foo'), 1)
         finally:
             torch.jit._logging.set_logger(old_logger)
+
+    @unittest.skipIf(GRAPH_EXECUTOR != ProfilingMode.LEGACY, "Only the legacy executor caches plans per ArgumentSpec")
+    def test_execution_plan_cache(self):
+        @torch.jit.script
+        def foo(x):
+            return x + 1.0
+
+        old_capacity = torch._C._jit_set_execution_plan_cache_capacity(2)
+        logger = torch.jit._logging.LockingLogger()
+        old_logger = torch.jit._logging.set_logger(logger)
+        try:
+            # one plan per rank, the least recently used one is evicted
+            foo(torch.rand(3))
+            foo(torch.rand(3, 4))
+            foo(torch.rand(3))
+            foo(torch.rand(3, 4, 5))
+            foo(torch.rand(3))
+            foo(torch.rand(3, 4))
+
+            self.assertEqual(logger.get_counter_val('pytorch_runtime.execution_plan_cache_hit'), 2)
+            self.assertEqual(logger.get_counter_val('pytorch_runtime.execution_plan_cache_miss'), 4)
+            self.assertEqual(logger.get_counter_val('pytorch_runtime.execution_plan_cache_eviction'), 2)
+            self.assertGreater(logger.get_counter_val('pytorch_runtime.execution_plan_compilation_time'), 0)
+            self.assertEqual(len(foo.get_debug_state().execution_plans), 2)
+        finally:
+            torch.jit._logging.set_logger(old_logger)
+            torch._C._jit_set_execution_plan_cache_capacity(old_capacity)
+
+    @unittest.skipIf(GRAPH_EXECUTOR != ProfilingMode.LEGACY, "Only the legacy executor caches plans per ArgumentSpec")
+    def test_precompile(self):
+        class M(torch.nn.Module):
+            def forward(self, x, y):
+                return x * y
+
+        m = torch.jit.script(M())
+        inputs = [(torch.rand(3), torch.rand(3)), (torch.rand(2, 3), torch.rand(2, 3))]
+        torch.jit.precompile(m, inputs)
+        self.assertEqual(len(m.get_debug_state().execution_plans), 2)
+
+        logger = torch.jit._logging.LockingLogger()
+        old_logger = torch.jit._logging.set_logger(logger)
+        try:
+            for x, y in inputs:
+                self.assertEqual(m(x, y), x * y)
+            self.assertEqual(logger.get_counter_val('pytorch_runtime.execution_plan_cache_hit'), 2)
+            self.assertEqual(logger.get_counter_val('pytorch_runtime.execution_plan_cache_miss'), 0)
+        finally:
+            torch.jit._logging.set_logger(old_logger)
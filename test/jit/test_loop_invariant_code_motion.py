@@ -0,0 +1,117 @@
+import os
+import sys
+
+import torch
+from torch.testing import FileCheck
+
+# Make the helper files in test/ importable
+pytorch_test_dir = os.path.dirname(os.path.dirname(os.path.realpath(__file__)))
+sys.path.append(pytorch_test_dir)
+from torch.testing._internal.jit_utils import JitTestCase
+
+if __name__ == '__main__':
+    raise RuntimeError("This test file is not meant to be run directly, use:\n\n"
+                       "\tpython test/test_jit.py TESTNAME\n\n"
+                       "instead.")
+
+class TestLoopInvariantCodeMotion(JitTestCase):
+    def _hoist(self, fn):
+        graph = torch.jit.script(fn).graph.copy()
+        self.run_pass('loop_invariant_code_motion', graph)
+        return graph, torch._C._create_function_from_graph("hoisted", graph)
+
+    def test_hoist(self):
+        def fn(x, w, n: int):
+            y = x
+            for _ in range(n):
+                y = y + torch.mm(x, w)
+            return y
+
+        graph, hoisted = self._hoist(fn)
+        # the loop may not run, so the hoisted nodes are guarded
+        FileCheck().check("prim::If").check("aten::mm").check("prim::Uninitialized") \
+            .check("prim::Loop").check_not("aten::mm").run(graph)
+        x, w = torch.rand(3, 3), torch.rand(3, 3)
+        for n in [0, 1, 4]:
+            self.assertEqual(hoisted(x, w, n), fn(x, w, n))
+
+    def test_constant_trip_count(self):
+        def fn(x, w):
+            y = x
+            for _ in range(3):
+                y = y + torch.mm(x, w)
+            return y
+
+        graph, hoisted = self._hoist(fn)
+        FileCheck().check_not("prim::If").check("aten::mm").check("prim::Loop") \
+            .check_not("aten::mm").run(graph)
+        x, w = torch.rand(3, 3), torch.rand(3, 3)
+        self.assertEqual(hoisted(x, w), fn(x, w))
+
+    def test_while_loop(self):
+        def fn(x, w, n: int):
+            y = x
+            i = 0
+            while i < n:
+                y = y * torch.sigmoid(w)
+                i += 1
+            return y
+
+        graph, hoisted = self._hoist(fn)
+        FileCheck().check("aten::sigmoid").check("prim::Loop").check_not("aten::sigmoid").run(graph)
+        x, w = torch.rand(3), torch.rand(3)
+        for n in [0, 2]:
+            self.assertEqual(hoisted(x, w, n), fn(x, w, n))
+
+    def test_nested_loops(self):
+        def fn(x, w, n: int, m: int):
+            y = x
+            for _ in range(n):
+                for _ in range(m):
+                    y = y + torch.mm(x, w)
+            return y
+
+        graph, hoisted = self._hoist(fn)
+        FileCheck().check("aten::mm").check("prim::Loop").check("prim::Loop") \
+            .check_not("aten::mm").run(graph)
+        x, w = torch.rand(3, 3), torch.rand(3, 3)
+        for n, m in [(0, 2), (2, 0), (2, 3)]:
+            self.assertEqual(hoisted(x, w, n, m), fn(x, w, n, m))
+
+    def test_mutation_not_hoisted(self):
+        def fn(x, n: int):
+            y = torch.zeros_like(x)
+            for _ in range(n):
+                x.add_(1)
+                y = y + x * 2
+            return y
+
+        graph, hoisted = self._hoist(fn)
+        FileCheck().check("prim::Loop").check("aten::add_").check("aten::mul").run(graph)
+        x = torch.rand(3)
+        self.assertEqual(hoisted(x.clone(), 3), fn(x.clone(), 3))
+
+    def test_nondeterministic_not_hoisted(self):
+        def fn(x, n: int):
+            for _ in range(n):
+                x = x + torch.rand(3)
+            return x
+
+        graph, _ = self._hoist(fn)
+        FileCheck().check("prim::Loop").check("aten::rand").run(graph)
+
+    def test_not_hoisted_past_assert(self):
+        def fn(x, w, n: int):
+            y = x
+            for _ in range(n):
+                assert x.dim() == 2
+                y = y + torch.mm(x, w)
+            return y
+
+        graph, hoisted = self._hoist(fn)
+        FileCheck().check("prim::Loop").check("prim::RaiseException").check("aten::mm").run(graph)
+        x, w = torch.rand(3, 3), torch.rand(3, 3)
+        self.assertEqual(hoisted(x, w, 2), fn(x, w, 2))
+        # the assert fails before mm can complain about the shapes
+        with self.assertRaisesRegex(Exception, "AssertionError"):
+            hoisted(torch.rand(3), w, 2)
@@ -0,0 +1,88 @@
+import os
+import sys
+
+import torch
+from torch.testing import FileCheck
+
+# Make the helper files in test/ importable
+pytorch_test_dir = os.path.dirname(os.path.dirname(os.path.realpath(__file__)))
+sys.path.append(pytorch_test_dir)
+from torch.testing._internal.jit_utils import JitTestCase
+
+if __name__ == '__main__':
+    raise RuntimeError("This test file is not meant to be run directly, use:\n\n"
+                       "\tpython test/test_jit.py TESTNAME\n\n"
+                       "instead.")
+
+class TestMemoryPlanning(JitTestCase):
+    def _plan(self, fn, inputs):
+        graph = torch.jit.script(fn).graph.copy()
+        torch._C._jit_pass_complete_shape_analysis(graph, inputs, False)
+        self.run_pass('plan_memory', graph)
+        return graph, torch._C._create_function_from_graph("planned", graph)
+
+    def test_intermediates_use_arena(self):
+        def fn(x, y):
+            a = x * y
+            b = a + x
+            c = torch.sigmoid(b)
+            return torch.tanh(c * y)
+
+        inputs = (torch.rand(8, 16), torch.rand(8, 16))
+        graph, planned = self._plan(fn, inputs)
+        # the output isn't planned, its producer stays functional
+        FileCheck().check("prim::MemoryPlanArena").check_count("prim::MemoryPlanSlot", 4, exactly=True) \
+            .run(graph)
+        # the first run sizes the slots, the next ones reuse the arena
+        for _ in range(3):
+            self.assertEqual(planned(*inputs), fn(*inputs))
+
+        with torch.autograd.profiler.profile(profile_memory=True) as prof:
+            planned(*inputs)
+        for event in prof.function_events:
+            if event.name in ("aten::mul", "aten::add", "aten::sigmoid"):
+                self.assertEqual(event.cpu_memory_usage, 0)
+
+    def test_aliases_extend_lifetime(self):
+        def fn(x, y):
+            a = x + y
+            v = a.view(-1)
+            b = x * y
+            c = b - x
+            return v.sum() + c.sum()
+
+        inputs = (torch.rand(4, 4), torch.rand(4, 4))
+        graph, planned = self._plan(fn, inputs)
+        FileCheck().check("prim::MemoryPlanArena").check("aten::view").run(graph)
+        for _ in range(3):
+            self.assertEqual(planned(*inputs), fn(*inputs))
+
+    def test_outputs_and_lists_not_planned(self):
+        def fn(x, y):
+            a = x * y
+            b = x + y
+            return a, [b]
+
+        graph, planned = self._plan(fn, (torch.rand(3), torch.rand(3)))
+        FileCheck().check_not("prim::MemoryPlanSlot").run(graph)
+
+    def test_shapes_change_after_planning(self):
+        def fn(x, y):
+            a = x * y
+            b = torch.relu(a) + y
+            return b * 2
+
+        graph, planned = self._plan(fn, (torch.rand(4), torch.rand(4)))
+        for size in (4, 4, 64, 2, 64):
+            inputs = (torch.randn(size), torch.randn(size))
+            self.assertEqual(planned(*inputs), fn(*inputs))
+
+    def test_requires_grad_not_planned(self):
+        def fn(x, y):
+            return (x * y) * 2
+
+        graph = torch.jit.script(fn).graph.copy()
+        inputs = (torch.rand(2, 3, requires_grad=True), torch.rand(2, 3))
+        torch._C._jit_pass_complete_shape_analysis(graph, inputs, False)
+        self.run_pass('plan_memory', graph)
+        FileCheck().check_not("prim::MemoryPlanSlot").run(graph)
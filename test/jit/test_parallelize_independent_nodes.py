@@ -0,0 +1,92 @@
+import os
+import sys
+
+import torch
+from torch.testing import FileCheck
+
+# Make the helper files in test/ importable
+pytorch_test_dir = os.path.dirname(os.path.dirname(os.path.realpath(__file__)))
+sys.path.append(pytorch_test_dir)
+from torch.testing._internal.jit_utils import JitTestCase
+
+if __name__ == '__main__':
+    raise RuntimeError("This test file is not meant to be run directly, use:\n\n"
+                       "\tpython test/test_jit.py TESTNAME\n\n"
+                       "instead.")
+
+def towers(x, w1, w2, w3):
+    a = torch.mm(x, w1)
+    a = torch.relu(a)
+    a = torch.sigmoid(a) * 2
+    b = torch.mm(x, w2)
+    b = torch.tanh(b)
+    b = torch.sigmoid(b) * 3
+    c = torch.mm(x, w3)
+    c = torch.relu(c)
+    c = torch.tanh(c) + 1
+    return torch.cat([a, b, c], 1)
+
+class TestParallelizeIndependentNodes(JitTestCase):
+    def _parallelize(self, fn):
+        graph = torch.jit.script(fn).graph.copy()
+        self.run_pass('parallelize_independent_nodes', graph)
+        return graph, torch._C._create_function_from_graph("parallelized", graph)
+
+    def test_towers(self):
+        graph, parallelized = self._parallelize(towers)
+        # the last tower runs on the calling thread
+        FileCheck().check_count("prim::fork", 2, exactly=True) \
+            .check_count("aten::wait", 2, exactly=True).check("aten::cat").run(graph)
+        inputs = (torch.rand(4, 8), torch.rand(8, 5), torch.rand(8, 6), torch.rand(8, 7))
+        for _ in range(3):
+            self.assertEqual(parallelized(*inputs), towers(*inputs))
+
+    def test_multiple_outputs(self):
+        def fn(x, y):
+            a = x * 2
+            b = a + 1
+            c = torch.sigmoid(b)
+            d = y * 3
+            e = d - 1
+            f = torch.tanh(e)
+            return b + f, c
+
+        graph, parallelized = self._parallelize(fn)
+        FileCheck().check("prim::fork").check("aten::wait").check("prim::TupleUnpack").run(graph)
+        x, y = torch.rand(3, 3), torch.rand(3, 3)
+        self.assertEqual(parallelized(x, y), fn(x, y))
+
+    def test_mutation_not_forked(self):
+        def fn(x, y):
+            a = x * 2
+            a.add_(1)
+            b = torch.sigmoid(a) * 2
+            c = y * 3
+            c = c - 1
+            c = torch.tanh(c)
+            return b + c
+
+        graph, parallelized = self._parallelize(fn)
+        FileCheck().check_not("prim::fork").run(graph)
+
+    def test_dependent_nodes_not_forked(self):
+        def fn(x):
+            a = x * 2
+            b = torch.relu(a) + x
+            c = torch.sigmoid(b) * a
+            return torch.tanh(c) - b
+
+        graph, parallelized = self._parallelize(fn)
+        FileCheck().check_not("prim::fork").run(graph)
+
+    def test_executor(self):
+        prev = torch._C._jit_inter_op_parallelization_enabled()
+        torch._C._jit_set_inter_op_parallelization_enabled(True)
+        try:
+            scripted = torch.jit.script(towers)
+            inputs = (torch.rand(4, 8), torch.rand(8, 5), torch.rand(8, 6), torch.rand(8, 7))
+            with torch.no_grad():
+                for _ in range(3):
+                    self.assertEqual(scripted(*inputs), towers(*inputs))
+        finally:
+            torch._C._jit_set_inter_op_parallelization_enabled(prev)
@@ -0,0 +1,100 @@
+import os
+import sys
+
+import torch
+
+# Make the helper files in test/ importable
+pytorch_test_dir = os.path.dirname(os.path.dirname(os.path.realpath(__file__)))
+sys.path.append(pytorch_test_dir)
+from torch.testing._internal.jit_utils import JitTestCase
+
+if __name__ == '__main__':
+    raise RuntimeError("This test file is not meant to be run directly, use:\n\n"
+                       "\tpython test/test_jit.py TESTNAME\n\n"
+                       "instead.")
+
+class DeepAndWide(torch.nn.Module):
+    def __init__(self, num_features):
+        super(DeepAndWide, self).__init__()
+        self.mu = torch.nn.Parameter(torch.randn(1, num_features))
+        self.sigma = torch.nn.Parameter(torch.randn(1, num_features))
+        self.fc_w = torch.nn.Parameter(torch.randn(1, num_features + 1))
+        self.fc_b = torch.nn.Parameter(torch.randn(1))
+
+    def forward(self, ad_emb_packed, user_emb, wide):
+        wide_offset = wide + self.mu
+        wide_normalized = wide_offset * self.sigma
+        wide_preproc = torch.relu(wide_normalized)
+        user_emb_t = torch.transpose(user_emb, 1, 2)
+        dp_unflatten = torch.bmm(ad_emb_packed, user_emb_t)
+        dp = torch.flatten(dp_unflatten, 1)
+        inp = torch.cat([dp, wide_preproc], 1)
+        fc1 = torch.addmm(self.fc_b, inp, self.fc_w.t())
+        return torch.sigmoid(fc1)
+
+class TestStaticRuntime(JitTestCase):
+    def test_module(self):
+        num_features = 50
+        mod = DeepAndWide(num_features).eval()
+        runtime = torch._C._jit_to_static_runtime(torch.jit.script(mod)._c)
+        for batch_size in (1, 1, 8, 1):
+            inputs = [torch.randn(batch_size, 1, 32), torch.randn(batch_size, 1, 32),
+                      torch.randn(batch_size, num_features)]
+            with torch.no_grad():
+                expected = mod(*inputs)
+            outputs = runtime.run(inputs)
+            self.assertEqual(len(outputs), 1)
+            self.assertEqual(outputs[0], expected)
+            self.assertFalse(outputs[0].requires_grad)
+
+    def test_outputs_not_reused(self):
+        def fn(x, y):
+            a = x * y
+            b = torch.tanh(a) + x
+            return b, b.view(-1), torch.sigmoid(a)
+
+        runtime = torch._C._jit_to_static_runtime(torch.jit.script(fn).graph)
+        x, y = torch.randn(3, 4), torch.randn(3, 4)
+        first = runtime.run([x, y])
+        first_values = [t.clone() for t in first]
+        second = runtime.run([y, x])
+        # the tensors returned by the first run are left untouched
+        self.assertEqual(first, first_values)
+        self.assertEqual(second, list(fn(y, x)))
+
+    def test_boxed_ops(self):
+        def fn(x, y):
+            a = torch.cat([x, y], 0)
+            b, c = torch.chunk(a * 2, 2, 0)
+            return torch.matmul(b, c.t()).clamp(min=0)
+
+        runtime = torch._C._jit_to_static_runtime(torch.jit.script(fn).graph)
+        for _ in range(3):
+            x, y = torch.randn(2, 5), torch.randn(2, 5)
+            self.assertEqual(runtime.run([x, y]), [fn(x, y)])
+
+    def test_dtype_changes(self):
+        def fn(x, y):
+            return (x + y) * 2
+
+        runtime = torch._C._jit_to_static_runtime(torch.jit.script(fn).graph)
+        for dtype in (torch.float, torch.double, torch.int64):
+            x, y = torch.ones(4, dtype=dtype), torch.ones(4, dtype=dtype)
+            output, = runtime.run([x, y])
+            self.assertEqual(output.dtype, dtype)
+            self.assertEqual(output, fn(x, y))
+
+    def test_unsupported(self):
+        def control_flow(x):
+            if bool(x.sum() > 0):
+                x = x * 2
+            return x
+
+        with self.assertRaisesRegex(RuntimeError, "doesn't support control flow"):
+            torch._C._jit_to_static_runtime(torch.jit.script(control_flow).graph)
+
+        def scalar_input(x, n: int):
+            return x * n
+
+        with self.assertRaisesRegex(RuntimeError, "only supports tensor inputs"):
+            torch._C._jit_to_static_runtime(torch.jit.script(scalar_input).graph)
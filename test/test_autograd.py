@@ -1108,6 +1108,114 @@ class TestAutograd(TestCase):
             has_deprecated = reduce(lambda x, y: x or y, has_deprecated)
             self.assertTrue(has_deprecated)
 
+    def test_saved_tensors_hooks(self):
+        packed = []
+
+        def pack(tensor):
+            packed.append(tensor.shape)
+            return tensor.clone()
+
+        a = torch.randn(5, requires_grad=True)
+        with torch.autograd.graph.saved_tensors_hooks(pack, lambda x: x * 1):
+            y = (a * 2).exp()
+            # leaves are saved as is
+            z = a * a
+        self.assertEqual(packed, [torch.Size([5])])
+        y.sum().backward(retain_graph=True)
+        self.assertEqual(a.grad, 2 * y)
+        # unpack_hook is called every time the tensor is needed
+        y.sum().backward()
+        self.assertEqual(a.grad, 4 * y)
+        with self.assertRaisesRegex(RuntimeError, "backward through the graph a second time"):
+            y.sum().backward()
+
+        # the previous hooks are restored on exit
+        self.assertIsNone(torch.autograd._get_saved_tensors_hooks())
+        with torch.autograd.graph.saved_tensors_hooks(lambda x: x.exp().log(), lambda x: x):
+            y = (a * 2).exp()
+        a.grad = None
+        y.sum().backward()
+        self.assertEqual(a.grad, 2 * y)
+
+        with torch.autograd.graph.saved_tensors_hooks(lambda x: x, lambda x: None):
+            y = (a * 2).exp()
+        with self.assertRaisesRegex(RuntimeError, "unpack_hook should return a Tensor"):
+            y.sum().backward()
+
+    def test_compress_saved_tensors(self):
+        a = torch.randn(10, 10, requires_grad=True)
+        expected = torch.autograd.grad(a.mul(2).sigmoid().sum(), a)[0]
+        for dtype, atol in ((torch.bfloat16, 1e-2), (torch.quint8, 5e-2)):
+            with torch.autograd.graph.compress_saved_tensors(dtype):
+                y = a.mul(2).sigmoid().sum()
+            self.assertEqual(torch.autograd.grad(y, a)[0], expected, atol=atol, rtol=0)
+
+        # small tensors are saved as is
+        with torch.autograd.graph.compress_saved_tensors(torch.quint8, min_numel=1000):
+            y = a.mul(2).sigmoid().sum()
+        self.assertEqual(torch.autograd.grad(y, a)[0], expected)
+
+        with self.assertRaisesRegex(ValueError, "only supports"):
+            torch.autograd.graph.compress_saved_tensors(torch.int8)
+
+    def test_grad_accumulation_in_place(self):
+        x = torch.randn(10, requires_grad=True)
+        torch.autograd.grad_accumulation_stats(reset=True)
+        y = x * 2
+        (y.sin() + y.cos() + y.exp()).sum().backward()
+        stats = torch.autograd.grad_accumulation_stats(reset=True)
+        self.assertEqual(x.grad, 2 * (y.cos() - y.sin() + y.exp()))
+        # the gradients of the three uses of y are summed into the first one
+        self.assertEqual(stats, {'in_place': 2, 'stolen': 1, 'allocated': 0})
+
+        x.grad = None
+        y = x * 2
+        grad, = torch.autograd.grad((y.sin() + y.cos()).sum(), x, create_graph=True)
+        stats = torch.autograd.grad_accumulation_stats(reset=True)
+        self.assertEqual(grad, 2 * (y.cos() - y.sin()))
+        self.assertEqual(stats['in_place'], 0)
+
+        # gradients referenced outside of the engine are never modified
+        kept = []
+
+        class Keep(Function):
+            @staticmethod
+            def forward(ctx, x):
+                return x.clone()
+
+            @staticmethod
+            def backward(ctx, grad):
+                grad = grad * 1
+                kept.append(grad)
+                return grad
+
+        y = x * 2
+        (Keep.apply(y) + Keep.apply(y)).sum().backward()
+        self.assertEqual(x.grad, torch.full_like(x, 4))
+        self.assertEqual(kept[0], torch.ones_like(x))
+        self.assertEqual(kept[1], torch.ones_like(x))
+
+    @unittest.skipIf(not torch._C.has_mkldnn, "MKL-DNN build is disabled")
+    def test_grad_accumulation_mkldnn(self):
+        # mkldnn gradients have no storage, so they're summed out of place
+        a = torch.randn(4, 4, dtype=torch.float32).to_mkldnn().requires_grad_()
+        torch.autograd.grad_accumulation_stats(reset=True)
+        (a.to_dense() + a.to_dense() * 2).sum().backward()
+        stats = torch.autograd.grad_accumulation_stats(reset=True)
+        self.assertEqual(a.grad.to_dense(), torch.full((4, 4), 3.))
+        self.assertEqual(stats['in_place'], 0)
+
+    @unittest.skipIf(IS_WINDOWS, "spilling saved tensors is not supported on Windows")
+    def test_spill_saved_tensors(self):
+        a = torch.randn(100, 10, requires_grad=True)
+        b = torch.randn(10, 10, requires_grad=True)
+        with tempfile.TemporaryDirectory() as directory:
+            with torch.autograd.graph.spill_saved_tensors(directory):
+                y = a.mm(b).tanh().mm(b).sigmoid().sum()
+            grads = torch.autograd.grad(y, (a, b))
+        y = a.mm(b).tanh().mm(b).sigmoid().sum()
+        self.assertEqual(grads, torch.autograd.grad(y, (a, b)))
+
     def test_requires_grad(self):
         x = torch.randn(5, 5)
         y = torch.randn(5, 5)
@@ -2650,6 +2758,46 @@ class TestAutograd(TestCase):
             # Now validate the json
             json.load(f)
 
+    @unittest.skipIf(IS_WINDOWS, """File open permission error on Windows,
+            https://github.com/pytorch/pytorch/issues/34086""")
+    def test_profiler_tracks(self):
+        x = torch.randn(1000, 1000, requires_grad=True)
+        with torch.autograd.profiler.profile(profile_memory=True, record_tracks=True) as prof:
+            y = (x * 2).sum()
+            y.backward()
+
+        task_names = ("at::parallel_for", "at::launch")
+        self.assertFalse(any(evt.name in task_names for evt in prof.function_events))
+
+        with tempfile.NamedTemporaryFile(mode="w+") as f:
+            prof.export_chrome_trace(f.name)
+            trace = json.load(f)
+
+        counters = {evt["name"] for evt in trace if evt["ph"] == "C"}
+        self.assertIn("CPU memory", counters)
+        self.assertIn("autograd::ReadyQueue", counters)
+
+        flows = [evt for evt in trace if evt.get("cat") == "forward_backward"]
+        starts = {evt["id"]: evt["name"] for evt in flows if evt["ph"] == "s"}
+        ends = {evt["id"]: evt["name"] for evt in flows if evt["ph"] == "f"}
+        self.assertEqual(set(starts), set(ends))
+        pairs = {(starts[i], ends[i]) for i in starts}
+        self.assertTrue(any("mul" in fwd and bwd == "MulBackward0" for fwd, bwd in pairs))
+        self.assertTrue(any("sum" in fwd and bwd == "SumBackward0" for fwd, bwd in pairs))
+
+        parallel_info = torch.__config__.parallel_info()
+        if "ATen parallel backend: native thread pool" in parallel_info and torch.get_num_threads() > 1:
+            pids = {evt["pid"] for evt in trace}
+            self.assertIn("Intra-op pool", pids)
+
+        # without record_tracks, only the functions are exported
+        with torch.autograd.profiler.profile(profile_memory=True) as prof:
+            (x * 2).sum().backward()
+        with tempfile.NamedTemporaryFile(mode="w+") as f:
+            prof.export_chrome_trace(f.name)
+            trace = json.load(f)
+        self.assertFalse(any(evt["ph"] == "C" for evt in trace))
+
     def test_profiler(self):
         x = torch.randn(10, 10)
 
@@ -2672,6 +2820,43 @@ class TestAutograd(TestCase):
                 last_end = info.cpu_interval.end
             self.assertEqual(info.name, expected_name)
 
+    def test_profiler_peak_memory(self):
+        x = torch.randn(10, 10)
+        with profile(profile_memory=True) as prof:
+            with record_function("big"):
+                big = torch.ones(1000, 1000)
+            with record_function("small"):
+                small = x * 2
+            del big
+            y = x + 1
+
+        big_bytes = 1000 * 1000 * 4
+        peak = prof.peak_memory()
+        self.assertGreaterEqual(peak.bytes, big_bytes)
+        op, nbytes, count = peak.allocations[0]
+        self.assertIn("ones", op)
+        self.assertGreaterEqual(nbytes, big_bytes)
+        self.assertEqual(prof.peak_memory(group_by="scope").allocations[0][0], "big")
+
+        timeline = prof.memory_timeline()
+        self.assertEqual(max(nbytes for _, nbytes in timeline), peak.bytes)
+        self.assertLess(timeline[-1][1], big_bytes)
+
+        # allocations made by TorchScript are attributed to its source
+        @torch.jit.script
+        def fn(x):
+            return torch.ones(1000, 1000) + x
+
+        with profile(profile_memory=True) as prof:
+            fn(x.new_ones(1))
+        source, nbytes, count = prof.peak_memory(group_by="source").allocations[0]
+        self.assertIn("test_autograd.py:", source)
+
+        with profile() as prof:
+            pass
+        with self.assertRaisesRegex(RuntimeError, "profile_memory"):
+            prof.peak_memory()
+
     def test_profiler_unboxed_only(self):
         x = torch.rand(3, 4)
 
@@ -2688,6 +2873,42 @@ class TestAutograd(TestCase):
         self.assertEqual(len(prof.function_events), 1)
         self.assertEqual(prof.function_events[0].name, '_TorchScriptTesting::take_an_instance')
 
+    def test_sampled_profiler(self):
+        x = torch.randn(10, 10)
+        with torch.autograd.profiler.sampled_profile() as prof:
+            with record_function("outer"):
+                y = x.mm(x)
+            t = threading.Thread(target=lambda: x.add(1))
+            t.start()
+            t.join()
+        # skip the ops implementing record_function
+        ranges = [r for r in prof.ranges if not r.name.startswith("profiler::")]
+        names = [r.name for r in ranges]
+        self.assertEqual(names[:2], ["outer", "aten::mm"])
+        self.assertIn("aten::add", names)
+        self.assertEqual(prof.dropped_events, 0)
+        for r in ranges:
+            self.assertLessEqual(r.start_us, r.end_us)
+        outer, mm = ranges[:2]
+        self.assertLessEqual(outer.start_us, mm.start_us)
+        self.assertLessEqual(mm.end_us, outer.end_us)
+
+        with torch.autograd.profiler.sampled_profile(sampling_prob=0.01) as prof:
+            for _ in range(1000):
+                x.add(1)
+        self.assertLess(len(prof.ranges), 100)
+
+        # events that don't fit in a buffer are dropped
+        with torch.autograd.profiler.sampled_profile(buffer_capacity=2) as prof:
+            for _ in range(100):
+                x.add(1)
+        self.assertGreater(prof.dropped_events, 0)
+
+        with torch.autograd.profiler.sampled_profile():
+            with self.assertRaisesRegex(RuntimeError, "already enabled"):
+                with torch.autograd.profiler.sampled_profile():
+                    pass
+
     def test_profiler_propagation(self):
         def foo(x):
             with record_function("in_foo") as rf:
@@ -6423,6 +6644,68 @@ class TestMultithreadAutograd(TestCase):
         self._run_py_multithread_fn(train_fn)
 
 
+    def test_parallel_cpu_workers(self):
+        prev_num_workers = torch.autograd.get_num_cpu_workers()
+        self.assertRaisesRegex(RuntimeError, "must be non-negative",
+                               lambda: torch.autograd.set_num_cpu_workers(-1))
+        try:
+            torch.autograd.set_num_cpu_workers(3)
+            self.assertEqual(torch.autograd.get_num_cpu_workers(), 3)
+
+            # Independent branches: the backward of each tower waits for the
+            # backward of the other one to start, which only happens if they
+            # are executed concurrently, whatever order they're queued in.
+            barrier = threading.Barrier(2, timeout=10)
+
+            class Rendezvous(Function):
+                @staticmethod
+                def forward(ctx, x):
+                    return x.clone()
+
+                @staticmethod
+                def backward(ctx, grad):
+                    barrier.wait()
+                    return grad
+
+            x = torch.randn(4, 4, requires_grad=True)
+            (Rendezvous.apply(x * 2) + Rendezvous.apply(x * 3)).sum().backward()
+            self.assertEqual(x.grad, torch.full_like(x, 5))
+
+            # Wide graph with reentrant backwards in some of the branches
+            x = torch.randn(8, 8, requires_grad=True)
+            towers = [x * i for i in range(8)]
+            towers += [checkpoint(lambda t: t.sin() * 2, x) for _ in range(4)]
+            sum(t.sum() for t in towers).backward()
+            self.assertEqual(x.grad, torch.full_like(x, 28) + 8 * x.cos())
+
+            grad, = torch.autograd.grad(sum(t.pow(2).sum() for t in torch.unbind(x)), x)
+            self.assertEqual(grad, 2 * x)
+
+            # Errors in any branch are reported to the caller
+            class Fail(Function):
+                @staticmethod
+                def forward(ctx, x):
+                    return x.clone()
+
+                @staticmethod
+                def backward(ctx, grad):
+                    raise RuntimeError("Simulate error")
+
+            x = torch.randn(4, requires_grad=True)
+            with self.assertRaisesRegex(RuntimeError, "Simulate error"):
+                (Fail.apply(x) + x * 2).sum().backward()
+
+            # Parallel backward from several threads at once
+            def train_fn():
+                x = torch.ones(5, 5, requires_grad=True)
+                y = (x + 3) * (x + 4) * 0.5
+                y.sum().backward()
+                self.assertEqual(x.grad, x + 3.5)
+
+            self._run_py_multithread_fn(train_fn)
+        finally:
+            torch.autograd.set_num_cpu_workers(prev_num_workers)
+
     def test_simple_backward_same_input(self):
         # simple multithreaded backward with only shared inputs (i.e. This is common
         # for things like Hogwild multithreaded training with multiple CPU threads)
@@ -29,6 +29,11 @@ from jit.test_op_normalization import TestOpNormalization  # noqa: F401
 from jit.test_module_interface import TestModuleInterface  # noqa: F401
 from jit.test_onnx_export import TestONNXExport  # noqa: F401
 from jit.test_with import TestWith  # noqa: F401
+from jit.test_cat_elimination import TestCatElimination  # noqa: F401
+from jit.test_memory_planning import TestMemoryPlanning  # noqa: F401
+from jit.test_static_runtime import TestStaticRuntime  # noqa: F401
+from jit.test_parallelize_independent_nodes import TestParallelizeIndependentNodes  # noqa: F401
+from jit.test_loop_invariant_code_motion import TestLoopInvariantCodeMotion  # noqa: F401
 
 # Torch
 from torch import Tensor
@@ -10349,6 +10354,21 @@ a")
         FileCheck().check_not("aten::dropout").run(str(m.graph))
         torch.testing.assert_allclose(ref_res, res, rtol=1e-2, atol=1e-3)
 
+    def test_mm_batching_independent(self):
+        def fn(a0, b0, a1, b1, a2, b2, a3, b3):
+            return torch.mm(a0, b0), torch.mm(a1, b1), torch.mm(a2, b2), torch.mm(a3, b3)
+
+        graph = torch.jit.script(fn).graph.copy()
+        self.run_pass('batch_mm', graph)
+        FileCheck().check("prim::MMBatchIndependent").check_not("aten::mm").run(str(graph))
+        batched = torch._C._create_function_from_graph("batched", graph)
+
+        same_shapes = [torch.rand(3, 4) if i % 2 == 0 else torch.rand(4, 5) for i in range(8)]
+        self.assertEqual(batched(*same_shapes), fn(*same_shapes))
+        # falls back to separate mms
+        different_shapes = [torch.rand(i + 1, 4) if i % 2 == 0 else torch.rand(4, i) for i in range(8)]
+        self.assertEqual(batched(*different_shapes), fn(*different_shapes))
+
     def test_mm_batching(self):
 
         with enable_profiling_mode_for_profiling_tests():
@@ -10415,6 +10435,22 @@ a")
         check(fn, 'add_const')
         check(fn2, 'add_iter')
 
+    def test_loop_unrolling_const_remainder(self):
+        def fn():
+            y = 0
+            for _ in range(70):
+                y -= 1
+            return y
+
+        graph = torch.jit.script(fn).graph
+        self.run_pass('loop_unrolling', graph)
+        # 8 iterations of the unrolled loop, then 6 unrolled ones instead of an epilogue loop
+        unroll_factor = 8
+        FileCheck().check_count("prim::Loop", 1, exactly=True).run(str(graph))
+        FileCheck().check("prim::Loop").check_count("aten::sub", unroll_factor + 6, exactly=True) \
+            .run(str(graph))
+        self.checkScript(fn, ())
+
     def test_loop_unrolling_nested(self):
         def fn(x):
             y = 0
@@ -28,7 +28,7 @@ import torch.nn.init as init
 import torch.nn.utils.rnn as rnn_utils
 from torch.nn.utils import clip_grad_norm_, clip_grad_value_
 import torch.nn.utils.prune as prune
-from torch.nn.utils import parameters_to_vector, vector_to_parameters
+from torch.nn.utils import parameters_to_vector, vector_to_parameters, allocate_grad_arena
 from torch.autograd import gradcheck
 from torch.autograd.gradcheck import gradgradcheck
 from torch.nn import Parameter
@@ -1736,6 +1736,28 @@ class TestNN(NNTestCase):
         sample = next(model.parameters())[0, 0, 0]
         self.assertTrue(torch.equal(sample.data, vec.data[:5]))
 
+    def test_allocate_grad_arena(self):
+        conv1 = nn.Conv2d(3, 10, 5)
+        fc1 = nn.Linear(10, 20).double()
+        model = nn.Sequential(conv1, fc1)
+        conv1.bias.grad = torch.ones_like(conv1.bias)
+        fc1.bias.requires_grad_(False)
+
+        arenas = allocate_grad_arena(model.parameters())
+        self.assertEqual([a.numel() for a in arenas], [760, 200])
+        self.assertEqual(conv1.bias.grad, torch.ones(10))
+        self.assertEqual(arenas[0][750:], torch.ones(10))
+        self.assertIsNone(fc1.bias.grad)
+
+        grads = [p.grad for p in model.parameters() if p.grad is not None]
+        for _ in range(2):
+            fc1(conv1(torch.randn(2, 3, 5, 5)).view(2, 10).double()).sum().backward()
+        # gradients were accumulated in the arena
+        for p, grad in zip((p for p in model.parameters() if p.grad is not None), grads):
+            self.assertIs(p.grad, grad)
+        self.assertEqual(arenas[1], fc1.weight.grad.view(-1))
+        self.assertEqual(torch.cat([g.view(-1) for g in grads[:2]]), arenas[0])
+
     # torch/nn/utils/prune.py
     @unittest.skipIf(not TEST_NUMPY, "numpy not found")
     def test_validate_pruning_amount_init(self):
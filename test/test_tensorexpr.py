@@ -1,9 +1,11 @@
 import numpy as np
+import os
+import tempfile
 import torch
 import torch.nn.functional as F
 import unittest
 
-from torch.testing._internal.common_utils import suppress_warnings, num_profiled_runs
+from torch.testing._internal.common_utils import suppress_warnings, num_profiled_runs, IS_WINDOWS
 
 from te_utils import CudaCodeGenCreated, CudaCodeGenExecuted, \
     LLVMCodeGenExecuted, SimpleIREvalExecuted
@@ -1001,6 +1003,131 @@ class TestTensorExprFuser(BaseTestClass):
         npr_a, npr_b = np.array_split(npr2, 2)
         np.testing.assert_allclose(npr_a + npr_b, x.numpy())
 
+    def _assert_one_fusion_group(self, fn, *args):
+        for _ in range(num_profiled_runs + 1):
+            fn(*args)
+        graph = fn.graph_for(*args)
+        self.assertEqual(str(graph).count("tensorexpr::Group"), 1)
+        self.assertEqual(len(graph.findAllNodes("aten::sum")), 0)
+        self.assertEqual(len(graph.findAllNodes("aten::mean")), 0)
+        self.assertEqual(len(graph.findAllNodes("aten::softmax")), 0)
+
+    def test_reductions(self):
+        @torch.jit.script
+        def reduce_dim(x, y):
+            return (x * y).sum(1) + (x + y).mean([0, 2], keepdim=True).sum()
+
+        @torch.jit.script
+        def reduce_all(x, y):
+            return torch.sum(x - y) * torch.mean(x + y)
+
+        x, y = torch.rand(4, 8, 16), torch.rand(4, 8, 16)
+        self._assert_one_fusion_group(reduce_all, x, y)
+        np.testing.assert_allclose(reduce_all(x, y).numpy(),
+                                   ((x - y).sum() * (x + y).mean()).numpy(), rtol=1e-5)
+        for _ in range(num_profiled_runs + 1):
+            r = reduce_dim(x, y)
+        np.testing.assert_allclose(
+            r.numpy(), ((x * y).sum(1) + (x + y).mean([0, 2], keepdim=True).sum()).numpy(), rtol=1e-5)
+
+    def test_softmax(self):
+        def bias_softmax(x, bias):
+            return torch.softmax(x + bias, dim=-1)
+
+        def bias_log_softmax(x, bias):
+            return torch.log_softmax(x + bias, dim=0)
+
+        # The innermost axis, with and without a tail for vectorization, and
+        # an outer one, in float and double.
+        for fn, size, dtype in ((bias_softmax, 64, torch.float),
+                                (bias_softmax, 37, torch.float),
+                                (bias_log_softmax, 64, torch.float),
+                                (bias_softmax, 37, torch.double),
+                                (bias_log_softmax, 64, torch.double)):
+            x, bias = torch.randn(8, size, dtype=dtype) * 10, torch.randn(size, dtype=dtype)
+            scripted = torch.jit.script(fn)
+            self._assert_one_fusion_group(scripted, x, bias)
+            np.testing.assert_allclose(scripted(x, bias).numpy(), fn(x, bias).numpy(),
+                                       rtol=1e-5, atol=1e-6)
+
+    def test_layer_norm_pattern(self):
+        @torch.jit.script
+        def layer_norm(x, weight, bias):
+            mean = x.mean(-1, keepdim=True)
+            centered = x - mean
+            var = (centered * centered).mean(-1, keepdim=True)
+            return centered * torch.rsqrt(var + 1e-5) * weight + bias
+
+        x, weight, bias = torch.randn(16, 128), torch.rand(128), torch.rand(128)
+        self._assert_one_fusion_group(layer_norm, x, weight, bias)
+        np.testing.assert_allclose(
+            layer_norm(x, weight, bias).numpy(),
+            F.layer_norm(x, (128,), weight, bias).numpy(), rtol=1e-4, atol=1e-5)
+
+    def test_cpu_schedule(self):
+        def pointwise(x, y):
+            return (x * y + 1.0).relu()
+
+        def bias_softmax(x, bias):
+            return torch.softmax(x + bias, dim=-1)
+
+        # Large enough to run in parallel, with tails for vectorization, in
+        # float and double.
+        num_threads = torch.get_num_threads()
+        torch.set_num_threads(4)
+        try:
+            for fn, shape, dtype in ((pointwise, (1 << 16) + 3, torch.float),
+                                     (pointwise, (3, 1 << 15), torch.float),
+                                     (pointwise, (257, 129), torch.double),
+                                     (bias_softmax, (512, 100), torch.float)):
+                x = torch.randn(shape, dtype=dtype)
+                y = torch.randn(shape[-1] if isinstance(shape, tuple) else shape, dtype=dtype)
+                scripted = torch.jit.script(fn)
+                self._assert_one_fusion_group(scripted, x, y)
+                np.testing.assert_allclose(scripted(x, y).numpy(), fn(x, y).numpy(),
+                                           rtol=1e-5, atol=1e-6)
+        finally:
+            torch.set_num_threads(num_threads)
+
+    def test_dynamic_shapes(self):
+        def bias_gelu(x, bias):
+            y = x + bias
+            return y * 0.5 * (1.0 + torch.erf(y / 1.41421))
+
+        old_dynamic_shapes = torch._C._jit_texpr_dynamic_shapes_enabled()
+        old_bucketing = torch._C._jit_get_te_shape_bucketing()
+        torch._C._jit_set_texpr_dynamic_shapes_enabled(True)
+        try:
+            for bucketing in (False, True):
+                torch._C._jit_set_te_shape_bucketing(bucketing)
+                scripted = torch.jit.script(bias_gelu)
+                bias = torch.randn(64)
+                self._assert_one_fusion_group(scripted, torch.randn(2, 16, 64), bias)
+
+                # Other batch sizes and sequence lengths run the same kernel,
+                # rather than bailing out.
+                llvm_executed = LLVMCodeGenExecuted()
+                simple_ir_eval_executed = SimpleIREvalExecuted()
+                shapes = ((2, 16, 64), (2, 37, 64), (5, 200, 64), (3, 1000, 64))
+                for shape in shapes:
+                    x = torch.randn(shape)
+                    np.testing.assert_allclose(scripted(x, bias).numpy(),
+                                               bias_gelu(x, bias).numpy(),
+                                               rtol=1e-5, atol=1e-6)
+                self.assertEqual(llvm_executed.elapsed_value() +
+                                 simple_ir_eval_executed.elapsed_value(), len(shapes))
+
+                # Broadcasting along a symbolic dim falls back to the
+                # interpreter.
+                for x, b in ((torch.randn(1, 7, 64), bias),
+                             (torch.randn(2, 7, 64), torch.randn(1))):
+                    np.testing.assert_allclose(scripted(x, b).numpy(),
+                                               bias_gelu(x, b).numpy(),
+                                               rtol=1e-5, atol=1e-6)
+        finally:
+            torch._C._jit_set_texpr_dynamic_shapes_enabled(old_dynamic_shapes)
+            torch._C._jit_set_te_shape_bucketing(old_bucketing)
+
     def _test_cat(self, device):
         def easy(*args):
             args_2 = [v + i for i, v in enumerate(args)]
@@ -1048,6 +1175,107 @@ class TestTensorExprFuser(BaseTestClass):
             # FIXME: interp.elapsed_value() also increments due to simplifier
             assert llvm.elapsed_value() == 1 or interp.elapsed_value() > 1
 
+    def test_lazy_eager(self):
+        torch._C._jit_lazy_eager_clear_kernel_cache()
+        x, a, b = [torch.rand(4, 8) for i in range(3)]
+        for _ in range(2):
+            llvm = LLVMCodeGenExecuted()
+            with torch.jit.lazy_eager():
+                self.assertTrue(torch._C._jit_lazy_eager_enabled())
+                y = (x * a + b).relu()
+                z = torch.sigmoid(y - 0.5) / 2
+            self.assertFalse(torch._C._jit_lazy_eager_enabled())
+            np.testing.assert_allclose(y.numpy(), np.maximum(x.numpy() * a.numpy() + b.numpy(), 0), rtol=1e-6)
+            np.testing.assert_allclose(z.numpy(), torch.sigmoid(y - 0.5).numpy() / 2, rtol=1e-6)
+            # Both chains run as one kernel, compiled once (unless LLVM is disabled)
+            cache_size = torch._C._jit_lazy_eager_kernel_cache_size()
+            self.assertIn(cache_size, (0, 1))
+            assert llvm.elapsed_value() == cache_size
+
+    def test_lazy_eager_materialize_on_access(self):
+        x = torch.rand(16)
+        with torch.jit.lazy_eager():
+            y = x.exp().neg() + 1
+            np.testing.assert_allclose(y.numpy(), 1 - np.exp(x.numpy()), rtol=1e-6)
+            # Ops without a lazy kernel read the computed values
+            self.assertAlmostEqual(y.sum().item(), (1 - x.exp()).sum().item(), places=4)
+
+    def test_lazy_eager_broadcast_and_numbers(self):
+        x = torch.rand(4, 1) + 0.5
+        w = torch.rand(3)
+        with torch.jit.lazy_eager():
+            y = torch.add(x, w, alpha=2).log() * 3 - 1
+            z = (x / 2).tanh()
+        np.testing.assert_allclose(y.numpy(), np.log(x.numpy() + 2 * w.numpy()) * 3 - 1, rtol=1e-5)
+        np.testing.assert_allclose(z.numpy(), np.tanh(x.numpy() / 2), rtol=1e-6)
+
+    def test_lazy_eager_runs_eagerly_unsupported(self):
+        x = torch.rand(8, requires_grad=True)
+        d = torch.rand(8, dtype=torch.double)
+        with torch.jit.lazy_eager():
+            y = (x * 2).relu()
+            e = d * 2
+        # autograd is recorded as usual
+        self.assertIsNotNone(y.grad_fn)
+        y.sum().backward()
+        self.assertTrue(torch.equal(e, d * 2))
+
+    def test_lazy_eager_inplace_input(self):
+        x = torch.rand(8)
+        expected = x * 2
+        with torch.jit.lazy_eager():
+            # the pending ops are computed before their operands are modified
+            y = x * 2
+            x.add_(1)
+            z = (x * 3).relu()
+            torch.mul(x, 2, out=x)
+            x[0] = 5
+        self.assertEqual(y, expected)
+        self.assertEqual(z, (expected / 2 + 1) * 3)
+        self.assertEqual(x[0], 5)
+
+    def test_lazy_eager_detach(self):
+        x = torch.rand(8)
+        with torch.jit.lazy_eager():
+            y = x * 2 + 1
+            d = y.detach()
+            data = y.data
+            self.assertEqual(d.view(-1), x * 2 + 1)
+            self.assertEqual(data, x * 2 + 1)
+            w = torch.rand(8)
+            y.data = w
+            self.assertEqual(y, w)
+
+    @unittest.skipIf(IS_WINDOWS, "the kernel cache is not supported on Windows")
+    def test_kernel_disk_cache(self):
+        old_dir = torch._C._jit_kernel_cache_dir()
+        old_max_bytes = torch._C._jit_kernel_cache_max_bytes()
+        with tempfile.TemporaryDirectory() as cache_dir:
+            torch._C._jit_kernel_cache_set_dir(cache_dir)
+            torch._C._jit_kernel_cache_reset_stats()
+            try:
+                x, a, b = [torch.rand(4, 8) for i in range(3)]
+                for _ in range(2):
+                    torch._C._jit_lazy_eager_clear_kernel_cache()
+                    with torch.jit.lazy_eager():
+                        y = (x * a + b).relu()
+                    np.testing.assert_allclose(y.numpy(), np.maximum(x.numpy() * a.numpy() + b.numpy(), 0), rtol=1e-6)
+                # Without LLVM, nothing is compiled
+                if torch._C._jit_lazy_eager_kernel_cache_size() == 0:
+                    return
+                # Compiled by the first iteration, loaded from the disk by the second
+                stats = torch._C._jit_kernel_cache_stats()
+                self.assertEqual(stats["stores"], 1)
+                self.assertEqual(stats["hits"], 1)
+                self.assertEqual(len([f for f in os.listdir(cache_dir) if f.endswith(".o")]), 1)
+
+                torch._C._jit_kernel_cache_set_max_bytes(0)
+                self.assertEqual(torch._C._jit_kernel_cache_stats()["evictions"], 1)
+                self.assertEqual(os.listdir(cache_dir), [])
+            finally:
+                torch._C._jit_kernel_cache_set_max_bytes(old_max_bytes)
+                torch._C._jit_kernel_cache_set_dir(old_dir)
+
 # FIXME: Blocked on profiling executor changes
 # def test_loop():
 #    @torch.jit.script
@@ -10585,6 +10585,57 @@ class TestTorchDeviceType(TestCase):
             alias_samples = torch._multinomial_alias_draw(prob_table, alias_table, MAX_SAMPLES)
             self.assertEqual(alias_samples.unique(), probs.nonzero().squeeze(-1))
 
+    @onlyCPU
+    def test_multinomial_alias_sampler(self, device):
+        # Unnormalized weights are normalized while building the tables
+        weights = torch.tensor([8., 1.99, 0.01], device=device)
+        sampler = torch.classes.distributions.AliasMultinomialSampler(weights)
+        self.assertEqual(sampler.num_categories(), 3)
+
+        alias_table, prob_table = sampler.tables()
+        actual = torch.zeros_like(weights)
+        for i, (idx, p) in enumerate(zip(alias_table, prob_table)):
+            actual[i] += p
+            actual[idx] += 1. - p
+        self.assertEqual(actual / len(weights), weights / weights.sum(), atol=1e-6, rtol=0)
+
+        # Draws are split into independently seeded chunks, so the samples
+        # only depend on the seed and not on the number of threads.
+        num_threads = torch.get_num_threads()
+        try:
+            torch.manual_seed(0)
+            torch.set_num_threads(1)
+            serial = sampler.sample(100000)
+            torch.manual_seed(0)
+            torch.set_num_threads(4)
+            parallel = sampler.sample(100000)
+        finally:
+            torch.set_num_threads(num_threads)
+        self.assertEqual(serial, parallel)
+        counts = torch.bincount(serial, minlength=3).to(weights.dtype) / serial.numel()
+        self.assertEqual(counts, weights / weights.sum(), atol=0.01, rtol=0)
+
+        @torch.jit.script
+        def draw(s: torch.classes.distributions.AliasMultinomialSampler, n: int) -> torch.Tensor:
+            return s.sample(n)
+
+        self.assertEqual(draw(sampler, 10).size(), torch.Size([10]))
+
+        class NegativeSampler(torch.nn.Module):
+            def __init__(self, sampler):
+                super(NegativeSampler, self).__init__()
+                self.sampler = sampler
+
+            def forward(self, n: int):
+                return self.sampler.sample(n)
+
+        buffer = io.BytesIO()
+        torch.jit.save(torch.jit.script(NegativeSampler(sampler)), buffer)
+        buffer.seek(0)
+        loaded = torch.jit.load(buffer)
+        self.assertEqual(loaded.sampler.tables(), sampler.tables())
+        self.assertEqual(loaded(10).size(), torch.Size([10]))
+
     @skipCUDAIfNoMagma
     @skipCPUIfNoLapack
     def test_lapack_empty(self, device):
@@ -11393,6 +11444,44 @@ class TestTorchDeviceType(TestCase):
             self.assertTrue(y.is_contiguous())
             self.assertEqual(expected, actual)
 
+    def test_cdist_topk(self, device):
+        for batch in [(), (2, 3)]:
+            for m in [1, 3, 10, 30]:
+                for p in [0, 1, 2, 3, 1.5, float('inf')]:
+                    x = torch.randn(*batch, 37, m, dtype=torch.double, device=device)
+                    y = torch.randn(*batch, 53, m, dtype=torch.double, device=device)
+                    if p == 0:
+                        x, y = x.round(), y.round()
+                    for k in [1, 5, 53]:
+                        values, indices = torch.cdist_topk(x, y, k, p=p)
+                        expected = self._brute_cdist(x, y, p=p).sort(-1)[0][..., :k]
+                        self.assertEqual(values.shape, batch + (37, k))
+                        self.assertEqual(expected, values)
+                        self.assertEqual(self._brute_cdist(x, y, p=p).gather(-1, indices), values)
+
+        x = torch.randn(5, 4, dtype=torch.double, device=device, requires_grad=True)
+        y = torch.randn(9, 4, dtype=torch.double, device=device, requires_grad=True)
+        for p in [1, 2, 3]:
+            self.assertTrue(torch.autograd.gradcheck(lambda x, y: torch.cdist_topk(x, y, 3, p)[0], (x, y)))
+
+        # rows without columns are all at distance 0
+        x, y = torch.randn(2, 4, 0, device=device), torch.randn(2, 6, 0, device=device)
+        cdist_topk_fns = [torch.cdist_topk]
+        if device == 'cpu':
+            cdist_topk_fns.append(torch._cdist_topk)
+        for fn in cdist_topk_fns:
+            values, indices = fn(x, y, 3, 2)
+            self.assertEqual(values, torch.zeros(2, 4, 3, device=device))
+            self.assertEqual(indices, torch.arange(3, device=device).expand(2, 4, 3))
+
+        values, indices = torch.cdist_topk(torch.randn(4, 3, device=device), torch.randn(6, 3, device=device), 0)
+        self.assertEqual(values.shape, (4, 0))
+        self.assertEqual(indices.dtype, torch.long)
+        self.assertRaisesRegex(RuntimeError, "must be between 0 and the number of rows",
+                               lambda: torch.cdist_topk(torch.randn(4, 3, device=device), torch.randn(6, 3, device=device), 7))
+        self.assertRaisesRegex(RuntimeError, "same batch dimensions",
+                               lambda: torch.cdist_topk(torch.randn(2, 4, 3, device=device), torch.randn(6, 3, device=device), 1))
+
     def test_multinomial_constraints(self, device):
         x = torch.empty(1, 2, 3, dtype=torch.double, device=device)
         self.assertRaisesRegex(
@@ -11938,6 +12027,65 @@ class TestTorchDeviceType(TestCase):
             expanded = torch.randn(1, 5, 1, 2, device=device).expand(3, 5, 7, 2)
             test_against_np(expanded)
 
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_histc_parallel(self, device, dtype):
+        # Large enough to be split among threads with private bins
+        x = torch.randn(1 << 20, device=device, dtype=dtype)
+        x[::1000] = float('nan')
+        in_range = (x >= -2) & (x <= 2)
+        expected = torch.bincount(((x[in_range] + 2) / 4 * 64).long().clamp(max=63), minlength=64)
+        num_threads = torch.get_num_threads()
+        try:
+            for threads in [1, 4]:
+                torch.set_num_threads(threads)
+                actual = torch.histc(x, bins=64, min=-2, max=2)
+                self.assertEqual(actual, expected.to(dtype), atol=0, rtol=0)
+
+                idx = torch.randint(100, (1 << 20,), device=device)
+                w = torch.rand(1 << 20, device=device, dtype=torch.double)
+                self.assertEqual(torch.bincount(idx, w),
+                                 torch.zeros(100, device=device, dtype=torch.double).index_add_(0, idx, w))
+                self.assertEqual(torch.bincount(idx),
+                                 torch.zeros(100, device=device, dtype=torch.long).index_add_(0, idx, torch.ones_like(idx)))
+        finally:
+            torch.set_num_threads(num_threads)
+
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_histogramdd(self, device, dtype):
+        points = torch.tensor([[0., 0.], [1., 1.], [1., 2.], [2., 2.]], device=device, dtype=dtype)
+        self.assertEqual(torch.histogramdd(points, [2, 2]),
+                         torch.tensor([[1., 0.], [0., 3.]], device=device, dtype=dtype))
+        weight = torch.tensor([1., 2., 3., 4.], device=device, dtype=dtype)
+        self.assertEqual(torch.histogramdd(points, [2, 2], weight=weight),
+                         torch.tensor([[1., 0.], [0., 9.]], device=device, dtype=dtype))
+        # points out of range are ignored
+        bounds = torch.tensor([[0., 1.], [0., 4.]], device=device, dtype=dtype)
+        self.assertEqual(torch.histogramdd(points, [1, 4], range=bounds),
+                         torch.tensor([[1., 1., 1., 0.]], device=device, dtype=dtype))
+
+        # 1-D histograms match histc, with and without weights
+        x = torch.randn(100000, device=device, dtype=dtype)
+        self.assertEqual(torch.histogramdd(x.unsqueeze(1), [50]), torch.histc(x, bins=50))
+        w = torch.rand(100000, device=device, dtype=dtype)
+        bins = ((x - x.min()) / (x.max() - x.min()) * 50).long().clamp(max=49)
+        self.assertEqual(torch.histogramdd(x.unsqueeze(1), [50], weight=w),
+                         torch.zeros(50, device=device, dtype=dtype).index_add_(0, bins, w))
+
+        # against numpy, in 3 dimensions
+        if TEST_NUMPY:
+            points = torch.rand(10000, 3, device=device, dtype=dtype)
+            bounds = torch.tensor([[0., 1.], [0.25, 0.75], [0., 0.5]], device=device, dtype=dtype)
+            expected, _ = np.histogramdd(points.numpy(), bins=[3, 4, 5], range=bounds.tolist())
+            self.assertEqual(torch.histogramdd(points, [3, 4, 5], range=bounds),
+                             torch.from_numpy(expected).to(dtype))
+
+        with self.assertRaisesRegex(RuntimeError, "expected 2 bin counts"):
+            torch.histogramdd(torch.rand(5, 2, device=device, dtype=dtype), [2])
+        with self.assertRaisesRegex(RuntimeError, "bins must be > 0"):
+            torch.histogramdd(torch.rand(5, 3, device=device, dtype=dtype), [2, 0, 2])
+
     def test_bool_tensor_comparison_ops(self, device):
         a = torch.tensor([True, False, True, False, True, False], dtype=torch.bool, device=device)
         b = torch.tensor([True, False, True, True, True, True], dtype=torch.bool, device=device)
@@ -12502,6 +12650,31 @@ class TestTorchDeviceType(TestCase):
         for i in range(idx.size(0)):
             self.assertEqual(dest[i], src[idx[i]])
 
+    @onlyCPU
+    @dtypes(torch.uint8, torch.half, torch.bfloat16, torch.float, torch.double, torch.complex128)
+    def test_index_select_rows(self, device, dtype):
+        # Covers the row copy fast path for every row width, dimension and dtype,
+        # checked against the strided fallback on a non-contiguous source.
+        for shape in [(7,), (7, 1), (7, 3), (5, 7, 2), (2, 3, 7, 33)]:
+            src = torch.randn(shape, device=device).to(dtype)
+            noncontig = torch.empty(shape[::-1], dtype=dtype, device=device).permute(*reversed(range(len(shape))))
+            noncontig.copy_(src)
+            for dim in range(len(shape)):
+                idx = torch.randint(shape[dim], (11,), device=device)
+                expected = torch.index_select(noncontig, dim, idx)
+                self.assertEqual(torch.index_select(src, dim, idx), expected, atol=0, rtol=0)
+
+        src = torch.randn(3, 4, device=device).to(dtype)
+        with self.assertRaisesRegex(IndexError, "index out of range in self"):
+            torch.index_select(src, 0, torch.tensor([0, 3], device=device))
+        with self.assertRaisesRegex(IndexError, "index out of range in self"):
+            torch.index_select(src, 1, torch.tensor([-1], device=device))
+
+        # gather with an index expanded along all but the gathered dim selects whole rows
+        rows = torch.randint(3, (6,), device=device)
+        index = rows.unsqueeze(1).expand(-1, 4)
+        self.assertEqual(torch.gather(src, 0, index), src[rows], atol=0, rtol=0)
+
     def test_take_empty(self, device):
         for input_shape in [(0,), (0, 1, 2, 0), (1, 2, 3)]:
             for indices_shape in [(0,), (0, 1, 2, 0)]:
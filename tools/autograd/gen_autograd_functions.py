@@ -19,6 +19,7 @@ struct TORCH_API ${op} : public ${superclass} {
     ${thread_lock}
     ${release_variables}
   }
+  ${prefetch_saved_variables}
   ${will_release_variables}
   ${saved_variables}
   ${saved_list_sizes}
@@ -32,6 +33,13 @@ void will_release_variables() override {
 }
 """)
 
+PREFETCH_SAVED_VARIABLES = CodeTemplate("""\
+void prefetch_saved_variables() override {
+  ${thread_lock}
+  ${prefetch_variables}
+}
+""")
+
 FUNCTION_DEFINITION = CodeTemplate("""\
 variable_list ${op}::apply(variable_list&& grads) {
   ${thread_lock}
@@ -127,6 +135,7 @@ def process_function(func):
     env = {}
     saved_variables = []
     release_variables = []
+    prefetch_variables = []
     saved_list_sizes = []
     unpack = []
     asserts = []
@@ -147,6 +156,7 @@ def process_function(func):
             saved_variables.append('SavedVariable {}_;'.format(name))
             release_variables.append('{}_.reset_data();'.format(name))
             release_variables.append('{}_.reset_grad_function();'.format(name))
+            prefetch_variables.append('{}_.prefetch();'.format(name))
             ptr = 'shared_from_this()' if is_output else ''
             unpack.append('auto {} = {}_.unpack({});'.format(name, name, ptr))
         elif arg['type'] == 'TensorList':
@@ -156,6 +166,7 @@ def process_function(func):
             # Because the SavedVariable owns a tensor and a grad_fn, removing the SavedVariable makes them go away as well.
             release_variables.append('{}_.clear();'.format(name))
             release_variables.append('{}_released_ = true;'.format(name))
+            prefetch_variables.append('for (auto& var : {}_) var.prefetch();'.format(name))
             unpack.append('auto {} = unpack_list({}_);'.format(name, name))
             asserts.append('TORCH_CHECK(!{}_released_, ERR_BACKWARD_TWICE);'.format(name))
         elif arg['type'] == 'IntArrayRef':
@@ -181,6 +192,12 @@ def process_function(func):
     else:
         env['thread_lock'] = ''
 
+    if len(prefetch_variables) > 0:
+        env['prefetch_saved_variables'] = PREFETCH_SAVED_VARIABLES.substitute(
+            thread_lock=env['thread_lock'], prefetch_variables=prefetch_variables)
+    else:
+        env['prefetch_saved_variables'] = ''
+
     if uses_retain_variables(func):
         env['will_release_variables'] = WILL_RELEASE_VARIABLES.substitute()
     else:
@@ -1089,6 +1089,47 @@ Example::
              -0.5790,  0.1497]])
 """.format(**common_args))
 
+add_docstr(torch.cdist_topk,
+           r"""
+cdist_topk(x1, x2, k, p=2.) -> (Tensor, Tensor)
+
+Returns the :attr:`k` smallest p-norm distances between each row vector of
+:attr:`x1` and the row vectors of :attr:`x2`, together with the indices of the
+corresponding rows of :attr:`x2`.
+
+This is equivalent to ``torch.cdist(x1, x2, p).topk(k, largest=False)``, but
+the full distance matrix is never materialized: on CPU the distances are
+computed tile by tile and folded into a per-row top-k, and otherwise
+:func:`torch.cdist` is evaluated on bounded chunks of :attr:`x2`. This makes it
+suitable for nearest-neighbor search over large sets of embeddings.
+
+The distances are returned in ascending order. Ties are broken by the smaller
+index on CPU. Gradients flow to :attr:`x1` and :attr:`x2` through the returned
+distances only.
+
+Args:
+    x1 (Tensor): input tensor of shape :math:`B \times P \times M`.
+    x2 (Tensor): input tensor of shape :math:`B \times R \times M`, with the
+        same batch dimensions :math:`B` as :attr:`x1`.
+    k (int): the number of nearest neighbors to return, at most :math:`R`.
+    p: p value for the p-norm distance to calculate between each vector pair
+        :math:`\in [0, \infty]`.
+
+Returns:
+    A tuple of ``(values, indices)``, both of shape :math:`B \times P \times k`.
+
+Example::
+
+    >>> a = torch.tensor([[0.9041,  0.0196], [-0.3108, -2.4423], [-0.4821,  1.059]])
+    >>> b = torch.tensor([[-2.1763, -0.4713], [-0.6986,  1.3702]])
+    >>> torch.cdist_topk(a, b, 1)
+    (tensor([[2.0959],
+            [2.7138],
+            [0.3791]]), tensor([[1],
+            [0],
+            [1]]))
+""")
+
 add_docstr(torch.ceil,
            r"""
 ceil(input, out=None) -> Tensor
@@ -2681,6 +2722,40 @@ Example::
     tensor([ 0.,  2.,  1.,  0.])
 """.format(**common_args))
 
+add_docstr(torch.histogramdd,
+           r"""
+histogramdd(input, bins, range=None, weight=None) -> Tensor
+
+Computes the multi-dimensional histogram of the points in a 2-D tensor of
+shape :math:`(N, D)`, where every row is a point in :math:`D` dimensions.
+
+Along dimension ``d`` the points are sorted into ``bins[d]`` equal width bins
+between ``range[d][0]`` and ``range[d][1]``. If :attr:`range` is not given,
+the minimum and maximum values of the data along every dimension are used.
+Points outside of the range are ignored. Currently only supported on CPU.
+
+Args:
+    input (Tensor): the points, of shape :math:`(N, D)`
+    bins (list of ints): number of bins along every dimension
+    range (Tensor, optional): tensor of shape :math:`(D, 2)` holding the lower
+        and upper end (both inclusive) of the range along every dimension
+    weight (Tensor, optional): tensor of shape :math:`(N)`, the weight of
+        every point. Defaults to a weight of 1 for every point.
+
+Returns:
+    Tensor: Histogram of shape ``bins``
+
+Example::
+
+    >>> points = torch.tensor([[0., 0.], [1., 1.], [1., 2.], [2., 2.]])
+    >>> torch.histogramdd(points, bins=[2, 2])
+    tensor([[1., 0.],
+            [0., 3.]])
+    >>> torch.histogramdd(points, bins=[2, 2], weight=torch.tensor([1., 2., 3., 4.]))
+    tensor([[1., 0.],
+            [0., 9.]])
+""")
+
 add_docstr(torch.index_select,
            r"""
 index_select(input, dim, index, out=None) -> Tensor
@@ -8,7 +8,7 @@ half, float, double and bfloat16) and complex :class:`Tensor` types (cfloat, cdo
 """
 import torch
 import warnings
-from typing import Any, Callable, Union, Tuple, Sequence, Optional
+from typing import Any, Callable, Dict, Union, Tuple, Sequence, Optional
 from torch.types import _TensorOrTensors
 
 from .variable import Variable
@@ -18,6 +18,7 @@ from .grad_mode import no_grad, enable_grad, set_grad_enabled
 from .anomaly_mode import detect_anomaly, set_detect_anomaly
 from . import profiler
 from . import functional
+from . import graph
 
 __all__ = ['Variable', 'Function', 'backward', 'grad_mode']
 
@@ -208,6 +209,63 @@ def _is_checkpoint_valid():
     return Variable._execution_engine.is_checkpoint_valid()
 
 
+def set_num_cpu_workers(num_workers: int) -> None:
+    r"""Sets the number of extra threads used to run the CPU part of backward
+    passes.
+
+    By default, the CPU nodes of a backward pass are executed one at a time on
+    the thread that called :func:`backward` or :func:`grad`. With
+    ``num_workers > 0``, that many additional threads execute independent
+    branches of the graph concurrently, which speeds up wide graphs such as
+    multi-tower models or ensembles. ``0`` restores the default behavior.
+
+    The setting applies to backward passes started after the call. Reentrant
+    backward calls made during a backward pass (e.g. by
+    :func:`torch.utils.checkpoint.checkpoint`) keep working, and are executed
+    in parallel whenever their parent is.
+
+    .. note::
+        Custom :class:`Function` s and hooks may be called from several
+        threads at once, and the order in which independent branches run is
+        not deterministic.
+
+    Arguments:
+        num_workers (int): the number of worker threads, or 0 to disable
+    """
+    Variable._execution_engine.set_num_cpu_workers(num_workers)
+
+
+def get_num_cpu_workers() -> int:
+    r"""Returns the number of extra threads used to run the CPU part of
+    backward passes. See :func:`set_num_cpu_workers`."""
+    return Variable._execution_engine.num_cpu_workers()
+
+
+def grad_accumulation_stats(reset: bool = False) -> Dict[str, int]:
+    r"""Returns how the gradients received by the functions of backward passes
+    were accumulated since the stats were last reset.
+
+    The returned dict has the following keys:
+
+    - ``in_place``: gradients summed in place into another one.
+    - ``stolen``: gradients of leaves taken as their ``.grad`` without a copy.
+    - ``allocated``: gradients that needed a new tensor to be summed or
+      copied into.
+
+    The first two count the allocations that were avoided. Gradients are
+    only summed in place when the backward is not differentiated
+    (``create_graph=False``) and one of them is not referenced outside of the
+    engine. See also :func:`torch.nn.utils.allocate_grad_arena`.
+
+    Arguments:
+        reset (bool): reset the stats after reading them
+    """
+    stats = torch.autograd._grad_accumulation_stats()
+    if reset:
+        torch.autograd._reset_grad_accumulation_stats()
+    return stats
+
+
 def variable(*args, **kwargs):
     warnings.warn("torch.autograd.variable(...) is deprecated, use torch.tensor(...) instead")
     return torch.tensor(*args, **kwargs)
@@ -0,0 +1,98 @@
+import torch
+from typing import Any, Callable
+
+
+class _SavedTensorsHooksContext(object):
+    def __init__(self, hooks) -> None:
+        self.hooks = hooks
+        self.prev = None
+
+    def __enter__(self) -> None:
+        self.prev = torch.autograd._get_saved_tensors_hooks()
+        torch.autograd._set_saved_tensors_hooks(self.hooks)
+
+    def __exit__(self, *args: Any) -> bool:
+        torch.autograd._set_saved_tensors_hooks(self.prev)
+        return False
+
+
+class saved_tensors_hooks(_SavedTensorsHooksContext):
+    r"""Context-manager that sets a pair of pack / unpack hooks for the tensors
+    that operations save for backward.
+
+    Within this context, ``pack_hook(tensor)`` is called every time an
+    operation saves a tensor that is not a leaf for backward, and its result is
+    kept instead of the tensor. ``unpack_hook(packed)`` is called with it when
+    backward needs the tensor, and should return a tensor with the same
+    content. Since leaf tensors (e.g. parameters) are kept alive by the user
+    anyway, they are always saved as is.
+
+    The hooks apply to the current thread only, and are called on the thread
+    running backward for ``unpack_hook``.
+
+    Arguments:
+        pack_hook (callable): takes a tensor and returns any object.
+        unpack_hook (callable): takes the object returned by ``pack_hook``
+            and returns a tensor.
+
+    Example::
+
+        >>> a = torch.randn(5, requires_grad=True)
+        >>> with torch.autograd.graph.saved_tensors_hooks(lambda x: x.cpu(),
+        ...                                                lambda x: x.cuda()):
+        ...     y = (a.cuda() * 2).exp()
+        >>> y.sum().backward()  # the saved result of exp() is copied back
+    """
+    def __init__(self, pack_hook: Callable[[torch.Tensor], Any],
+                 unpack_hook: Callable[[Any], torch.Tensor]) -> None:
+        super(saved_tensors_hooks, self).__init__(
+            torch.autograd._python_saved_tensors_hooks(pack_hook, unpack_hook))
+
+
+class compress_saved_tensors(_SavedTensorsHooksContext):
+    r"""Context-manager that saves floating point tensors for backward in a
+    smaller dtype, and converts them back to their original dtype when
+    backward needs them.
+
+    ``dtype`` is either ``torch.bfloat16``, or ``torch.quint8`` to quantize
+    the saved tensors to 8 bits with a single scale per tensor (CPU only).
+    Half precision tensors, and tensors with fewer than ``min_numel`` elements
+    are saved as is.
+
+    .. warning::
+        The compression is lossy: gradients are computed from the rounded
+        values, which is usually acceptable for activations but should be
+        validated for each model.
+
+    Arguments:
+        dtype (torch.dtype): ``torch.bfloat16`` or ``torch.quint8``.
+            Default: ``torch.bfloat16``.
+        min_numel (int): minimum number of elements of a tensor to be
+            compressed. Default: ``0``.
+    """
+    def __init__(self, dtype: torch.dtype = torch.bfloat16, min_numel: int = 0) -> None:
+        if dtype not in (torch.bfloat16, torch.quint8):
+            raise ValueError("compress_saved_tensors only supports torch.bfloat16 "
+                             "and torch.quint8, but got {}".format(dtype))
+        super(compress_saved_tensors, self).__init__(
+            torch.autograd._compress_saved_tensors_hooks(dtype == torch.quint8, min_numel))
+
+
+class spill_saved_tensors(_SavedTensorsHooksContext):
+    r"""Context-manager that writes the contiguous CPU tensors saved for
+    backward to files in ``directory``, and frees their memory.
+
+    The files are unlinked right away and mapped back in memory, so that
+    backward reads them lazily. Before a function is run by backward, the
+    engine prefetches the tensors it saved as soon as it receives its first
+    gradient. Putting ``directory`` on a fast local drive (e.g. NVMe) is
+    recommended. Not supported on Windows.
+
+    Arguments:
+        directory (str): directory to create the files in.
+        min_numel (int): minimum number of elements of a tensor to be
+            spilled. Default: ``0``.
+    """
+    def __init__(self, directory: str, min_numel: int = 0) -> None:
+        super(spill_saved_tensors, self).__init__(
+            torch.autograd._spill_saved_tensors_hooks(directory, min_numel))
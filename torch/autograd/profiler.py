@@ -25,10 +25,14 @@ class EventList(list):
     def __init__(self, *args, **kwargs):
         use_cuda = kwargs.pop('use_cuda', True)
         profile_memory = kwargs.pop('profile_memory', False)
+        tracks = kwargs.pop('tracks', None)
+        memory_events = kwargs.pop('memory_events', None)
         super(EventList, self).__init__(*args, **kwargs)
         self._cpu_children_populated = False
         self._use_cuda = use_cuda
         self._profile_memory = profile_memory
+        self._tracks = tracks
+        self._memory_events = memory_events
 
     def __str__(self):
         return self.table()
@@ -129,7 +133,14 @@ class EventList(list):
     def export_chrome_trace(self, path):
         """Exports an EventList as a Chrome tracing tools file.
 
-        The checkpoint can be later loaded and inspected under ``chrome://tracing`` URL.
+        The checkpoint can be later loaded and inspected under ``chrome://tracing`` URL,
+        or in Perfetto. Flow arrows link the forward ops to the autograd nodes that
+        compute their backward.
+
+        When the events were recorded with ``record_tracks=True``, the trace also has
+        separate tracks for the intra-op (``at::parallel_for``) and inter-op
+        (``at::launch``) thread pool tasks, for the counters such as the depth of the
+        autograd ready queue and, with ``profile_memory=True``, for the memory usage.
 
         Arguments:
             path (str): Path where the trace will be written.
@@ -189,11 +200,43 @@ class EventList(list):
                                                k.interval.elapsed_us(), k.device))
                     next_id += 1
 
+            next_id = self._write_forward_backward_flows(f, next_id)
+            if self._tracks is not None:
+                self._tracks.write_chrome_trace(f)
+
             # remove trailing whitespace and comma
             f.seek(f.tell() - 2, os.SEEK_SET)
             f.truncate()
             f.write("]")
 
+    def _write_forward_backward_flows(self, f, next_id):
+        # The forward op that created an autograd node is the latest one that
+        # saw its sequence number: the ops nested in it, and the following ops
+        # that don't create a node, see the next number.
+        forward_ops = {}
+        for evt in sorted(self, key=lambda evt: evt.cpu_interval.start):
+            if evt.sequence_nr < 0:
+                continue
+            if evt.scope == torch.autograd.RecordScope.FUNCTION:
+                forward_ops[evt.sequence_nr] = evt
+            elif evt.scope == torch.autograd.RecordScope.BACKWARD_FUNCTION:
+                fwd = forward_ops.pop(evt.sequence_nr, None)
+                if fwd is None:
+                    continue
+                for ph, flow_evt in (('s', fwd), ('f', evt)):
+                    f.write('{"name": "%s", '
+                            '"ph": "%s", '
+                            '"ts": %s, '
+                            '"tid": %s, '
+                            '"pid": "CPU functions", '
+                            '"id": %s, '
+                            '"cat": "forward_backward", '
+                            '"bp": "e", '
+                            '"args": {}}, ' % (flow_evt.name, ph, flow_evt.cpu_interval.start,
+                                               flow_evt.thread, next_id))
+                next_id += 1
+        return next_id
+
     def key_averages(self, group_by_input_shapes=False):
         """Averages all function events over their keys.
 
@@ -231,6 +274,153 @@ class EventList(list):
         total_stat.key = 'Total'
         return total_stat
 
+    def _check_memory_events(self, device):
+        if self._memory_events is None:
+            raise RuntimeError("memory events were not recorded, use profile(profile_memory=True)")
+        if device not in ('cpu', 'cuda'):
+            raise ValueError("expected device to be 'cpu' or 'cuda', but got {}".format(device))
+        return sorted(
+            (evt for evt in self._memory_events if evt.device == device),
+            key=attrgetter('time'))
+
+    def memory_timeline(self, device='cpu'):
+        """Returns the memory used by the tensors allocated while profiling over time.
+
+        Memory that was allocated before the profiler was enabled, or freed by
+        a thread that is not profiled, is not accounted for.
+
+        Arguments:
+            device (str, optional): ``'cpu'`` or ``'cuda'``. Default: ``'cpu'``
+
+        Returns:
+            A list of ``(time in us, bytes)`` pairs, one after each allocation
+            and free.
+        """
+        timeline = []
+        live = {}
+        total = 0
+        for evt in self._check_memory_events(device):
+            if evt.bytes > 0:
+                live[evt.ptr] = evt.bytes
+                total += evt.bytes
+            elif evt.ptr in live:
+                total -= live.pop(evt.ptr)
+            else:
+                continue
+            timeline.append((evt.time, total))
+        return timeline
+
+    def peak_memory(self, device='cpu', group_by='op'):
+        """Attributes the memory that is live at its peak to the code that allocated it.
+
+        Each allocation is attributed to the outermost op (or autograd node) that
+        was running on its thread when it was made, to the innermost
+        ``record_function`` range or TorchScript function around it, and, when it
+        was made from TorchScript, to the ``"file:line"`` of the TorchScript source.
+
+        Arguments:
+            device (str, optional): ``'cpu'`` or ``'cuda'``. Default: ``'cpu'``
+            group_by (str, optional): ``'op'``, ``'scope'`` (the ``record_function``
+                range or TorchScript function) or ``'source'``. Allocations that
+                don't have a scope or a source are grouped by op. Default: ``'op'``
+
+        Returns:
+            A ``PeakMemory`` with the ``time`` (in us) and ``bytes`` of the peak,
+            and the ``allocations`` live at that time as a list of
+            ``(key, bytes, number of allocations)``, largest first.
+        """
+        if group_by not in ('op', 'scope', 'source'):
+            raise ValueError(
+                "expected group_by to be 'op', 'scope' or 'source', but got {}".format(group_by))
+        events = self._check_memory_events(device)
+
+        # First find the peak, then replay the events up to it to find out what
+        # is alive, rather than copying the live set at each new peak
+        peak_idx = -1
+        peak_bytes = 0
+        live = {}
+        total = 0
+        for idx, evt in enumerate(events):
+            if evt.bytes > 0:
+                live[evt.ptr] = evt.bytes
+                total += evt.bytes
+                if total > peak_bytes:
+                    peak_bytes = total
+                    peak_idx = idx
+            elif evt.ptr in live:
+                total -= live.pop(evt.ptr)
+
+        live = {}
+        for evt in events[:peak_idx + 1]:
+            if evt.bytes > 0:
+                live[evt.ptr] = evt
+            else:
+                live.pop(evt.ptr, None)
+
+        stats = defaultdict(lambda: [0, 0])
+        for evt in live.values():
+            key = getattr(evt, group_by) or evt.op
+            stats[key][0] += evt.bytes
+            stats[key][1] += 1
+        allocations = sorted(
+            ((key, nbytes, count) for key, (nbytes, count) in stats.items()),
+            key=lambda a: -a[1])
+        peak_time = events[peak_idx].time if peak_idx >= 0 else 0
+        return PeakMemory(peak_time, peak_bytes, allocations)
+
+
+# A memory allocation (positive bytes) or free (negative bytes) recorded with
+# profile_memory=True. time is in us, op, scope and source are only set for
+# allocations.
+MemoryEvent = namedtuple('MemoryEvent', ['time', 'ptr', 'bytes', 'device', 'op', 'scope', 'source'])
+PeakMemory = namedtuple('PeakMemory', ['time', 'bytes', 'allocations'])
+
+
+class Tracks(object):
+    """Events recorded with ``record_tracks=True`` that are not function ranges.
+    They are only used to export a trace, where each kind of event gets its own track.
+    """
+    def __init__(self):
+        # FunctionEvents of the intra-op and inter-op thread pool tasks
+        self.tasks = []
+        # (name, time in us, value) of the counters
+        self.counters = []
+        # (time in us, CPU bytes, CUDA bytes) of the allocations (negative when freed)
+        self.memory = []
+
+    def write_chrome_trace(self, f):
+        pids = {
+            torch.autograd.RecordScope.INTRAOP_TASK: "Intra-op pool",
+            torch.autograd.RecordScope.INTEROP_TASK: "Inter-op pool",
+        }
+        for evt in self.tasks:
+            f.write('{"name": "%s", '
+                    '"ph": "X", '
+                    '"ts": %s, '
+                    '"dur": %s, '
+                    '"tid": %s, '
+                    '"pid": "%s", '
+                    '"args": {}}, ' % (evt.name, evt.cpu_interval.start,
+                                       evt.cpu_interval.elapsed_us(), evt.thread,
+                                       pids[evt.scope]))
+        counter_template = ('{"name": "%s", '
+                            '"ph": "C", '
+                            '"ts": %s, '
+                            '"pid": "%s", '
+                            '"args": {"%s": %s}}, ')
+        for name, ts, value in sorted(self.counters, key=lambda c: c[1]):
+            f.write(counter_template % (name, ts, "Counters", "value", value))
+        # Memory usage, relative to the start of the profiling
+        cpu_memory = 0
+        cuda_memory = 0
+        for ts, cpu_bytes, cuda_bytes in sorted(self.memory, key=lambda m: m[0]):
+            if cpu_bytes != 0:
+                cpu_memory += cpu_bytes
+                f.write(counter_template % ("CPU memory", ts, "Memory", "bytes", cpu_memory))
+            if cuda_bytes != 0:
+                cuda_memory += cuda_bytes
+                f.write(counter_template % ("CUDA memory", ts, "Memory", "bytes", cuda_memory))
+
 
 class profile(object):
     """Context manager that manages autograd profiler state and holds a summary of results.
@@ -260,6 +450,12 @@ class profile(object):
 
         profile_memory (bool, optional): Whether to report memory usage, default: ``False``
 
+        record_tracks (bool, optional): Also record the intra-op and inter-op thread
+            pool tasks and the depth of the autograd ready queue, which
+            :meth:`export_chrome_trace` exports as separate tracks, together with the
+            memory usage when ``profile_memory`` is set. They are not part of the
+            tables. Default: ``False``
+
     .. warning:
         Enabling memory profiling incurs additional profiler overhead
 
@@ -297,7 +493,8 @@ class profile(object):
             enabled=True,
             use_cuda=False,
             record_shapes=False,
-            profile_memory=False):
+            profile_memory=False,
+            record_tracks=False):
         self.enabled = enabled
         self.use_cuda = use_cuda
         self.function_events = None
@@ -306,6 +503,7 @@ class profile(object):
         self.entered = False
         self.record_shapes = record_shapes
         self.profile_memory = profile_memory
+        self.record_tracks = record_tracks
 
     def __enter__(self):
         if not self.enabled:
@@ -316,7 +514,8 @@ class profile(object):
         profiler_kind = torch.autograd.ProfilerState.CUDA if self.use_cuda \
             else torch.autograd.ProfilerState.CPU
 
-        config = torch.autograd.ProfilerConfig(profiler_kind, self.record_shapes, self.profile_memory)
+        config = torch.autograd.ProfilerConfig(
+            profiler_kind, self.record_shapes, self.profile_memory, self.record_tracks)
         torch.autograd._enable_profiler(config)
         return self
 
@@ -324,10 +523,14 @@ class profile(object):
         if not self.enabled:
             return
         records = torch.autograd._disable_profiler()
+        tracks = Tracks() if self.record_tracks else None
+        memory_events = [] if self.profile_memory else None
         self.function_events = EventList(
-            parse_cpu_trace(records),
+            parse_cpu_trace(records, tracks, memory_events),
             use_cuda=self.use_cuda,
-            profile_memory=self.profile_memory)
+            profile_memory=self.profile_memory,
+            tracks=tracks,
+            memory_events=memory_events)
         return False
 
     def __repr__(self):
@@ -367,6 +570,16 @@ class profile(object):
         return self.function_events.total_average()
     total_average.__doc__ = EventList.total_average.__doc__
 
+    def memory_timeline(self, device='cpu'):
+        self._check_finish()
+        return self.function_events.memory_timeline(device)
+    memory_timeline.__doc__ = EventList.memory_timeline.__doc__
+
+    def peak_memory(self, device='cpu', group_by='op'):
+        self._check_finish()
+        return self.function_events.peak_memory(device, group_by)
+    peak_memory.__doc__ = EventList.peak_memory.__doc__
+
     @property
     def self_cpu_time_total(self):
         """ Returns total time spent on CPU obtained as a sum of
@@ -563,6 +776,53 @@ class emit_nvtx(object):
         return False
 
 
+SampledRange = namedtuple('SampledRange', ['name', 'thread', 'start_us', 'end_us'])
+
+
+class sampled_profile(object):
+    """Context manager that records a random sample of the operator calls and
+    ``record_function`` ranges of all threads, with a low overhead.
+
+    Unlike :class:`profile`, which records everything with a noticeable
+    overhead, this profiler is meant to be left enabled in production. Each
+    thread records fixed size events into its own buffer, without locking or
+    allocating, and a background thread collects them periodically. Events
+    recorded while a buffer is full are dropped, which is reported by
+    ``dropped_events``.
+
+    Only one sampled profiler can be enabled at a time, and it should be
+    enabled and disabled while no other thread is running operators.
+
+    Arguments:
+        sampling_prob (float): probability of recording any given range.
+            Default: ``1.0``
+        buffer_capacity (int): number of events each thread can buffer
+            between two collections. Default: ``16384``
+
+    Example:
+        >>> with torch.autograd.profiler.sampled_profile(sampling_prob=0.01) as prof:
+        ...     for _ in range(1000):
+        ...         torch.mm(torch.randn(10, 10), torch.randn(10, 10))
+        >>> len(prof.ranges)  # about 1% of the randn and mm calls
+        31
+    """
+    def __init__(self, sampling_prob=1.0, buffer_capacity=1 << 14):
+        self.sampling_prob = sampling_prob
+        self.buffer_capacity = buffer_capacity
+        self.ranges = None
+        self.dropped_events = None
+
+    def __enter__(self):
+        torch.autograd._enable_sampled_profiler(self.sampling_prob, self.buffer_capacity)
+        return self
+
+    def __exit__(self, exc_type, exc_val, exc_tb):
+        ranges, self.dropped_events = torch.autograd._disable_sampled_profiler()
+        self.ranges = [SampledRange(name, thread, start_ns / 1000., end_ns / 1000.)
+                       for name, thread, start_ns, end_ns in ranges]
+        return False
+
+
 def load_nvprof(path):
     """Opens an nvprof trace file and parses autograd annotations.
 
@@ -647,7 +907,8 @@ class FunctionEvent(FormattedTimesMixin):
     """Profiling information about a single function."""
     def __init__(
             self, id, node_id, name, thread, cpu_start, cpu_end, input_shapes=None,
-            cpu_memory_usage=0, cuda_memory_usage=0, is_async=False, is_remote=True):
+            cpu_memory_usage=0, cuda_memory_usage=0, is_async=False, is_remote=True,
+            sequence_nr=-1, scope=None):
         self.id = id
         self.node_id = node_id
         self.name = name
@@ -661,6 +922,8 @@ class FunctionEvent(FormattedTimesMixin):
         self.cuda_memory_usage = cuda_memory_usage
         self.is_async = is_async
         self.is_remote = is_remote
+        self.sequence_nr = sequence_nr
+        self.scope = scope
 
     def append_kernel(self, name, device, start, end):
         self.kernels.append(Kernel(name, device, Interval(start, end)))
@@ -810,7 +1073,11 @@ class StringTable(defaultdict):
 ################################################################################
 # CPU checkpoints
 
-def parse_cpu_trace(thread_records):
+def parse_cpu_trace(thread_records, tracks=None, memory_events=None):
+    """Returns the FunctionEvents of the ranges in ``thread_records``. The thread
+    pool tasks, counters and memory events are added to ``tracks``, if given,
+    and the memory events to ``memory_events`` as MemoryEvents, if given.
+    """
     def get_record_key(record):
         """
         Returns a tuple to be used by parse_cpu_trace for correlating start and
@@ -858,6 +1125,15 @@ def parse_cpu_trace(thread_records):
 
     assert start_record is not None and not start_record.is_remote()
 
+    task_scopes = (
+        torch.autograd.RecordScope.INTRAOP_TASK,
+        torch.autograd.RecordScope.INTEROP_TASK,
+    )
+    scope_kinds = (
+        torch.autograd.RecordScope.USER_SCOPE,
+        torch.autograd.RecordScope.TORCHSCRIPT_FUNCTION,
+    )
+
     for thread_record_list in thread_records:
         # accumulated memory allocations per handle
         cpu_memory_allocs = {}
@@ -869,7 +1145,9 @@ def parse_cpu_trace(thread_records):
         prev_record = None
         for record in thread_record_list:
             record_key = get_record_key(record)
-            if (record.name() in filtered_out_names or
+            # memory events are named after the op that allocated them
+            if record.kind() != 'memory_alloc' and (
+                    record.name() in filtered_out_names or
                     record_key in filtered_handles):
                 filtered_handles.add(record_key)
                 continue
@@ -917,6 +1195,8 @@ def parse_cpu_trace(thread_records):
                     cuda_memory_usage=cuda_memory_usage,
                     is_async=is_async,
                     is_remote=is_remote_event,
+                    sequence_nr=start.sequence_nr(),
+                    scope=start.scope(),
                 )
                 # note: async events have only cpu total time
                 if not is_async and start.has_cuda():
@@ -927,7 +1207,13 @@ def parse_cpu_trace(thread_records):
                         start.device(),
                         cuda_start,
                         cuda_end)
-                functions.append(fe)
+                if fe.scope in task_scopes:
+                    # thread pool tasks are not functions, and would change
+                    # the self times of the ops they run
+                    if tracks is not None:
+                        tracks.tasks.append(fe)
+                else:
+                    functions.append(fe)
                 del range_starts[record_key]
                 del cpu_memory_allocs[record_key]
                 del cuda_memory_allocs[record_key]
@@ -936,6 +1222,37 @@ def parse_cpu_trace(thread_records):
                     cpu_memory_allocs[handle] += record.cpu_memory_usage()
                 for handle in cuda_memory_allocs.keys():
                     cuda_memory_allocs[handle] += record.cuda_memory_usage()
+                if tracks is not None:
+                    tracks.memory.append((
+                        start_record.cpu_elapsed_us(record),
+                        record.cpu_memory_usage(),
+                        record.cuda_memory_usage()))
+                if memory_events is not None:
+                    scope = None
+                    if record.name():
+                        # innermost record_function range or TorchScript
+                        # function open on this thread
+                        scope_starts = [
+                            start for start in range_starts.values()
+                            if start.scope() in scope_kinds]
+                        if scope_starts:
+                            scope = string_table[max(
+                                scope_starts, key=start_record.cpu_elapsed_us).name()]
+                    is_cuda = record.cuda_memory_usage() != 0
+                    memory_events.append(MemoryEvent(
+                        time=start_record.cpu_elapsed_us(record),
+                        ptr=record.alloc_ptr(),
+                        bytes=record.cuda_memory_usage() if is_cuda else record.cpu_memory_usage(),
+                        device='cuda' if is_cuda else 'cpu',
+                        op=string_table[record.name()] if record.name() else None,
+                        scope=scope,
+                        source=record.source_location() or None))
+            elif record.kind() == 'counter':
+                if tracks is not None:
+                    tracks.counters.append((
+                        record.name(),
+                        start_record.cpu_elapsed_us(record),
+                        record.counter_value()))
             prev_record = record
 
     # Sort functions by start time then by end time ascending.
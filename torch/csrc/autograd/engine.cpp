@@ -4,7 +4,9 @@
 #include <torch/csrc/autograd/function.h>
 #include <torch/csrc/autograd/functions/basic_ops.h>
 #include <torch/csrc/autograd/grad_mode.h>
+#include <torch/csrc/autograd/profiler.h>
 #include <torch/csrc/autograd/anomaly_mode.h>
+#include <torch/csrc/autograd/saved_variable_hooks.h>
 #include <torch/csrc/autograd/variable.h>
 #include <torch/csrc/utils/memory.h>
 
@@ -156,6 +158,36 @@ static thread_local std::shared_ptr<ReadyQueue> local_ready_queue = nullptr;
 // the leaf streams with the default streams is sufficient to implement
 // the historic behavior.
 
+// Note [Parallel CPU backward]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// By default, all the CPU nodes of a backward pass run on the thread that
+// called backward(), one at a time, which leaves wide graphs (multi-tower
+// models, ensembles) with no inter-op parallelism. When the engine is given
+// CPU workers (Engine::set_num_cpu_workers), a GraphTask started from a CPU
+// thread is marked parallel_cpu_ and that many threads from cpu_worker_pool_
+// service its cpu_ready_queue_ together with the owning thread, so independent
+// branches of the graph execute concurrently. Dependencies, input buffers and
+// captured grads are all updated under GraphTask::mutex_ as before, only the
+// node bodies run concurrently.
+//
+// thread_main assumes that it is the only consumer of its ready queue: it
+// leaves as soon as any CPU GraphTask completes, and it relies on dummy tasks
+// to wake up the owner of a GraphTask completed by another thread. Neither
+// holds for a shared queue, so every thread servicing a parallel GraphTask
+// runs cpu_worker_main instead, which:
+//
+//  1. pops with ReadyQueue::pop_until, and stops as soon as the GraphTask it
+//     is driving has completed, no matter which thread completed it;
+//  2. calls ReadyQueue::wake_all after completing any GraphTask, so that the
+//     thread driving it (possibly blocked in pop_until) notices.
+//
+// Reentrant backward calls made from a parallel GraphTask are parallel too.
+// They share the parent's ready queue as usual (See Note [Reentrant
+// backwards]) and the calling thread drives them with cpu_worker_main, while
+// the other workers keep helping with both the parent and the nested task.
+// Worker threads keep servicing the queue until the top-level GraphTask they
+// were started for completes, and then go back to cpu_worker_pool_.
+
 int NodeTask::getReentrantDepth() const {
   std::shared_ptr<GraphTask> graph_task = base_.lock();
   if (graph_task) {
@@ -168,7 +200,26 @@ int NodeTask::getReentrantDepth() const {
   }
 }
 
+// Samples the depth of a ready queue for the profiler, after a task of
+// `base` was pushed to it or popped from it. Counters are recorded in the
+// thread local profiler state, which worker threads only have while they run
+// a node, so it is taken from the GraphTask instead.
+static void record_queue_depth(const std::weak_ptr<GraphTask>& base, size_t depth) {
+  std::shared_ptr<GraphTask> graph_task = base.lock();
+  if (graph_task) {
+    at::ThreadLocalStateGuard tls_guard(graph_task->thread_locals_);
+    profiler::recordCounter("autograd::ReadyQueue", depth);
+  }
+}
+
 auto ReadyQueue::push(NodeTask item, bool incrementOutstandingTasks) -> void {
+  // Only pay for the copy when the queue depth may be recorded
+  const bool record_depth = profiler::profilerTracksEnabled();
+  std::weak_ptr<GraphTask> base;
+  if (C10_UNLIKELY(record_depth)) {
+    base = item.base_;
+  }
+  size_t depth = 0;
   {
     // Lock mutex for writing to heap_
     std::lock_guard<std::mutex> lock(mutex_);
@@ -178,8 +229,12 @@ auto ReadyQueue::push(NodeTask item, bool incrementOutstandingTasks) -> void {
       ++graph_task->outstanding_tasks_;
     }
     heap_.push(std::move(item));
+    depth = heap_.size();
   }
   not_empty_.notify_one();
+  if (C10_UNLIKELY(record_depth)) {
+    record_queue_depth(base, depth);
+  }
 }
 
 auto ReadyQueue::pushShutdownTask() -> void {
@@ -202,16 +257,47 @@ auto ReadyQueue::pop() -> NodeTask {
   not_empty_.wait(lock, [this]{ return !heap_.empty(); });
   // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
   auto task = std::move(const_cast<NodeTask&>(heap_.top())); heap_.pop();
+  if (C10_UNLIKELY(profiler::profilerTracksEnabled())) {
+    size_t depth = heap_.size();
+    lock.unlock();
+    record_queue_depth(task.base_, depth);
+  }
+  return task;
+}
+
+auto ReadyQueue::pop_until(const std::function<bool()>& stop) -> c10::optional<NodeTask> {
+  // Lock mutex for accesses to heap_
+  std::unique_lock<std::mutex> lock(mutex_);
+  not_empty_.wait(lock, [this, &stop]{ return stop() || !heap_.empty(); });
+  if (stop()) {
+    return c10::nullopt;
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  auto task = std::move(const_cast<NodeTask&>(heap_.top())); heap_.pop();
+  if (C10_UNLIKELY(profiler::profilerTracksEnabled())) {
+    size_t depth = heap_.size();
+    lock.unlock();
+    record_queue_depth(task.base_, depth);
+  }
   return task;
 }
 
+auto ReadyQueue::wake_all() -> void {
+  {
+    // Taking the lock orders the wake up after any state the waiters' `stop`
+    // predicates read, so that they can't miss it.
+    std::lock_guard<std::mutex> lock(mutex_);
+  }
+  not_empty_.notify_all();
+}
+
 bool ReadyQueue::empty() const {
   // Lock mutex for accesses to heap_
   std::unique_lock<std::mutex> lock(mutex_);
   return heap_.empty();
 }
 
-Engine::Engine() : max_recursion_depth_(MAX_DEPTH), non_reentrant_device_thread_count_(0) {}
+Engine::Engine() : max_recursion_depth_(MAX_DEPTH), num_cpu_workers_(0), non_reentrant_device_thread_count_(0) {}
 
 // Send shutdown tasks to all device_ready_queues_ if no backward tasks are running
 // Even though readyQueue should be empty, shutdown tasks have the highest priority
@@ -410,8 +496,13 @@ auto Engine::thread_main(
       if (worker_device != base_owner) {
         // Synchronize outstanding_tasks_ with queue mutex
         std::atomic_thread_fence(std::memory_order_release);
-        ready_queue_by_index(local_graph_task->cpu_ready_queue_, base_owner)
-            ->push(NodeTask(local_graph_task, nullptr, InputBuffer(0)));
+        auto owner_queue = ready_queue_by_index(local_graph_task->cpu_ready_queue_, base_owner);
+        if (local_graph_task->parallel_cpu_) {
+          // See Note [Parallel CPU backward]
+          owner_queue->wake_all();
+        } else {
+          owner_queue->push(NodeTask(local_graph_task, nullptr, InputBuffer(0)));
+        }
       }
     }
   }
@@ -443,10 +534,114 @@ void Engine::reentrant_thread_init() {
     // set the local_ready_queue to the ready queue on the graph_task->owner_ device
     local_ready_queue = ready_queue_by_index(graph_task->cpu_ready_queue_, graph_task->owner_);
     total_depth = graph_task->reentrant_depth_;
-    thread_main(graph_task, /* reentrant thread*/ true);
+    if (graph_task->parallel_cpu_) {
+      cpu_worker_main(graph_task);
+    } else {
+      thread_main(graph_task, /* reentrant thread*/ true);
+    }
   }
 }
 
+// See Note [Parallel CPU backward]
+void Engine::cpu_worker_main(const std::shared_ptr<GraphTask>& graph_task) {
+  TORCH_INTERNAL_ASSERT(graph_task->parallel_cpu_);
+  TORCH_INTERNAL_ASSERT(local_ready_queue != nullptr);
+  auto stop = [&graph_task]() { return graph_task->completed(); };
+  while (true) {
+    std::shared_ptr<GraphTask> local_graph_task;
+    {
+      // Scope this block of execution since NodeTask is not needed after this
+      // block and can be deallocated (release any references to grad tensors
+      // as part of inputs_).
+      c10::optional<NodeTask> task = local_ready_queue->pop_until(stop);
+      if (!task) {
+        break;
+      }
+
+      if (!(local_graph_task = task->base_.lock())) {
+        // GraphTask for function is no longer valid, skipping further
+        // execution.
+        continue;
+      }
+
+      if (task->fn_ && !local_graph_task->has_error_.load()) {
+        AutoGradMode grad_mode(local_graph_task->grad_mode_);
+        try {
+          GraphTaskGuard guard(local_graph_task);
+          evaluate_function(local_graph_task, task->fn_.get(), task->inputs_, local_graph_task->cpu_ready_queue_);
+        } catch (std::exception& e) {
+          thread_on_exception(local_graph_task, task->fn_, e);
+        }
+      }
+    }
+
+    // Decrement the outstanding tasks.
+    --local_graph_task->outstanding_tasks_;
+
+    if (local_graph_task->completed()) {
+      local_graph_task->mark_as_completed_and_run_post_processing();
+      // The thread driving local_graph_task may be waiting in pop_until()
+      local_ready_queue->wake_all();
+    }
+  }
+  // graph_task may have been completed by another thread that is still running
+  // its post processing; this waits for it to finish.
+  graph_task->mark_as_completed_and_run_post_processing();
+}
+
+void Engine::cpu_worker_thread_init() {
+  at::init_num_threads();
+  auto pool = cpu_worker_pool_;
+  while(true) {
+    std::unique_lock<std::mutex> lk(pool->mutex_);
+    ++pool->num_workers_;
+    pool->work_.wait(lk, [&pool]{ return !pool->graphtasks_queue_.empty();});
+    --pool->num_workers_;
+    auto task = pool->graphtasks_queue_.front();
+    pool->graphtasks_queue_.pop();
+    lk.unlock();
+    std::shared_ptr<GraphTask> graph_task;
+    if (!(graph_task = task.lock())) {
+      continue;
+    }
+    // Service the GraphTask's ready queue as if we were its owning CPU thread,
+    // so that reentrant backward calls made from here behave the same.
+    set_device(CPU_DEVICE);
+    local_ready_queue = graph_task->cpu_ready_queue_;
+    total_depth = graph_task->reentrant_depth_;
+    cpu_worker_main(graph_task);
+    local_ready_queue = nullptr;
+    worker_device = NO_DEVICE;
+  }
+}
+
+void Engine::add_cpu_worker_tasks(const std::shared_ptr<GraphTask>& graph_task, int num_workers) {
+  std::unique_lock<std::mutex> lck(cpu_worker_pool_->mutex_);
+  // Idle workers may already be claimed by GraphTasks queued by other threads
+  size_t queued = cpu_worker_pool_->graphtasks_queue_.size();
+  size_t available = cpu_worker_pool_->num_workers_ > queued ? cpu_worker_pool_->num_workers_ - queued : 0;
+  size_t num_new_threads = static_cast<size_t>(num_workers) > available ? num_workers - available : 0;
+  for (int i = 0; i < num_workers; ++i) {
+    cpu_worker_pool_->graphtasks_queue_.push(graph_task);
+  }
+  // Don't need to be holding the lock while actually creating the threads
+  lck.unlock();
+  for (size_t i = 0; i < num_new_threads; ++i) {
+    std::thread t(&Engine::cpu_worker_thread_init, this);
+    t.detach();
+  }
+  cpu_worker_pool_->work_.notify_all();
+}
+
+void Engine::set_num_cpu_workers(int num_workers) {
+  TORCH_CHECK(num_workers >= 0, "number of autograd CPU workers must be non-negative, got ", num_workers);
+  num_cpu_workers_.store(num_workers);
+}
+
+int Engine::num_cpu_workers() const {
+  return num_cpu_workers_.load();
+}
+
 void Engine::thread_on_exception(
     std::shared_ptr<GraphTask> graph_task,
     const std::shared_ptr<Node>& fn,
@@ -761,8 +956,14 @@ void Engine::evaluate_function(
     }
   }
 
+  // Functions that just got their first gradient but still wait for others.
+  // When saved tensors may have been packed (e.g. spilled to disk), we let them
+  // start bringing those back now, so that it's done by the time they run.
+  std::vector<std::shared_ptr<Node>> to_prefetch;
+  const bool prefetch = saved_tensor_hooks_were_used();
+
   // Lock mutex for the accesses to GraphTask dependencies_, not_ready_ and cpu_ready_queue_ below
-  std::lock_guard<std::mutex> lock(graph_task->mutex_);
+  std::unique_lock<std::mutex> lock(graph_task->mutex_);
   for (int i = 0; i < num_outputs; ++i) {
     auto& output = outputs[i];
     const auto& next = fn.next_edge(i);
@@ -808,6 +1009,9 @@ void Engine::evaluate_function(
             NodeTask(graph_task, next.function, std::move(input_buffer)));
       } else {
         not_ready.emplace(next.function.get(), std::move(input_buffer));
+        if (prefetch) {
+          to_prefetch.push_back(next.function);
+        }
       }
     } else {
       // The function already has a buffer
@@ -827,6 +1031,11 @@ void Engine::evaluate_function(
       }
     }
   }
+  lock.unlock();
+
+  for (auto& next_fn : to_prefetch) {
+    next_fn->prefetch_saved_variables();
+  }
 }
 
 /* Computes the number of dependencies for each function which requires grad */
@@ -872,6 +1081,11 @@ auto Engine::execute(const edge_list& roots,
       /* create_graph */ create_graph,
       /* depth */ not_reentrant_backward_call ? 0 : total_depth + 1,
       /* cpu_ready_queue */ local_ready_queue);
+  // Reentrant calls share their parent's ready queue, so they have to be
+  // parallel exactly when their parent is. See Note [Parallel CPU backward]
+  graph_task->parallel_cpu_ = not_reentrant_backward_call
+      ? num_cpu_workers_.load() > 0
+      : worker_device == CPU_DEVICE && current_graph_task && current_graph_task->parallel_cpu_;
 
   // Now compute the dependencies for all executable functions and queue the root
   auto graph_root = std::make_shared<GraphRoot>(roots, inputs);
@@ -916,7 +1130,13 @@ std::shared_ptr<FutureVariableList> Engine::execute_with_graph_task(
     // The owning thread start to drive the engine execution with the GraphTask
     // that has already been pushed to the current CPU thread's ready_queue
     lock.unlock();
-    thread_main(nullptr, false);
+    if (graph_task->parallel_cpu_) {
+      // See Note [Parallel CPU backward]
+      add_cpu_worker_tasks(graph_task, num_cpu_workers_.load());
+      cpu_worker_main(graph_task);
+    } else {
+      thread_main(nullptr, false);
+    }
     TORCH_INTERNAL_ASSERT(graph_task->future_result_->completed());
     // reset the worker_device after the completion of the graph_task, this is so
     // that the initial state of the engine remains the same across every backward()
@@ -942,7 +1162,11 @@ std::shared_ptr<FutureVariableList> Engine::execute_with_graph_task(
       // complete!
       ++current_depth;
       lock.unlock();
-      thread_main(graph_task, /* reentrant_thread */ true);
+      if (graph_task->parallel_cpu_) {
+        cpu_worker_main(graph_task);
+      } else {
+        thread_main(graph_task, /* reentrant_thread */ true);
+      }
       --current_depth;
       --total_depth;
 
@@ -1052,6 +1276,7 @@ auto Engine::start_device_threads() -> void {
   }
 
   thread_pool_shared_ = std::make_shared<ThreadPoolShared>();
+  cpu_worker_pool_ = std::make_shared<ThreadPoolShared>();
 
   for (int i = 0; i < num_devices; ++i) {
     std::thread t(&Engine::thread_init, this, i, device_ready_queues_[i], true);
@@ -11,6 +11,7 @@
 #include <torch/csrc/autograd/functions/basic_ops.h>
 #include <torch/csrc/autograd/input_buffer.h>
 #include <torch/csrc/utils/future.h>
+#include <c10/util/Optional.h>
 
 #include <deque>
 #include <exception>
@@ -139,6 +140,11 @@ struct GraphTask: std::enable_shared_from_this<GraphTask> {
   // 'future_result_' completed with an appropriate exception.
   void set_exception_without_signal(const std::shared_ptr<Node>& fn);
 
+  // Whether the CPU work of this GraphTask is shared between its owning thread
+  // and the engine's CPU worker threads. See Note [Parallel CPU backward].
+  // Set before execution starts and safe to read without synchronization.
+  bool parallel_cpu_ = false;
+
   // Whether or not to stop execution for this GraphTask when an error is
   // encountered. When set to true, this would cause Engine::execute() to throw
   // an exception as soon as the autograd engine receives an exception.
@@ -251,6 +257,11 @@ struct ReadyQueue {
   void push(NodeTask item, bool incrementOutstandingTasks = true);
   void pushShutdownTask();
   NodeTask pop();
+  // Like pop(), but returns c10::nullopt instead of a task as soon as `stop`
+  // returns true. `stop` is re-evaluated whenever the queue is woken up, so
+  // whoever makes it true must call wake_all() afterwards.
+  c10::optional<NodeTask> pop_until(const std::function<bool()>& stop);
+  void wake_all();
   bool empty() const;
   size_t size() const;
 };
@@ -312,6 +323,12 @@ struct TORCH_API Engine {
   // Should be called after fork to notify that worker threads are gone
   void release_workers();
 
+  // Sets the number of extra threads that execute the CPU nodes of a backward
+  // pass together with the thread that called it. 0 (the default) runs every
+  // CPU node on the calling thread. See Note [Parallel CPU backward].
+  void set_num_cpu_workers(int num_workers);
+  int num_cpu_workers() const;
+
  protected:
   Engine();
   void compute_dependencies(Node* root, GraphTask& task);
@@ -340,6 +357,11 @@ struct TORCH_API Engine {
       bool reentrant_thread);
   void reentrant_thread_init();
   void add_thread_pool_task(const std::weak_ptr<GraphTask>& graph_task);
+  // Drives a GraphTask with parallel_cpu_ set until it completes. Unlike
+  // thread_main, this can share its ready queue with other threads.
+  void cpu_worker_main(const std::shared_ptr<GraphTask>& graph_task);
+  void cpu_worker_thread_init();
+  void add_cpu_worker_tasks(const std::shared_ptr<GraphTask>& graph_task, int num_workers);
 
   // Ensures device_ready_queues_ are initialized only once
   std::once_flag start_device_threads_flag_;
@@ -376,6 +398,11 @@ struct TORCH_API Engine {
  // for the graphtasks_queue_ to be nonempty.
  std::shared_ptr<ThreadPoolShared> thread_pool_shared_;
 
+ // Idle CPU worker threads wait here for GraphTasks to help with.
+ // See Note [Parallel CPU backward]
+ std::shared_ptr<ThreadPoolShared> cpu_worker_pool_;
+ std::atomic<int> num_cpu_workers_;
+
 private:
   // Number of non-reentrant threads
   std::atomic<uint32_t> non_reentrant_device_thread_count_;
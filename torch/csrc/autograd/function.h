@@ -112,8 +112,11 @@ struct TORCH_API Node : std::enable_shared_from_this<Node> {
   /// Evaluates the function on the given inputs and returns the result of the
   /// function call.
   variable_list operator()(variable_list&& inputs) {
-    RECORD_FUNCTION(
-        name(), std::vector<c10::IValue>(inputs.begin(), inputs.end()), sequence_nr());
+    RECORD_FUNCTION_WITH_SCOPE(
+        at::RecordScope::BACKWARD_FUNCTION,
+        name(),
+        std::vector<c10::IValue>(inputs.begin(), inputs.end()),
+        sequence_nr());
     // In the first iteration of named tensors, autograd ignores names and
     // operates on unnamed tensors. In the long term, autograd should
     // probably operate with names.
@@ -306,6 +309,11 @@ struct TORCH_API Node : std::enable_shared_from_this<Node> {
   /// Releases saved variables if the operation won't be reused.
   virtual void release_variables() {}
 
+  /// Called by the engine when this node is expected to run soon, so that
+  /// saved variables packed by `SavedTensorHooks` (e.g. spilled to disk) can
+  /// start being brought back before `apply()` unpacks them.
+  virtual void prefetch_saved_variables() {}
+
   /// Called before an apply if `release_variables()` is going to be called.
   /// Allows larger ops like `InterpreterAutogradFunction` to incrementally
   /// release variables as they run.
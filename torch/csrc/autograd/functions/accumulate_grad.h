@@ -1,6 +1,7 @@
 #pragma once
 
 #include <torch/csrc/autograd/function.h>
+#include <torch/csrc/autograd/input_buffer.h>
 #include <torch/csrc/autograd/variable.h>
 #include <torch/csrc/WindowsTorchApiMacro.h>
 
@@ -36,6 +37,11 @@ struct TORCH_API AccumulateGrad : public Node {
   // update_grad: Function that is used to update grad for the variable.
   //              The argument to the function is a Tensor which
   //              is used to set a new value for the grad.
+  //
+  // The outcome is counted in grad_accumulation_stats(). Gradients
+  // accumulated into a preallocated .grad (e.g. a view of a gradient arena,
+  // see torch.nn.utils.allocate_grad_arena) never allocate when
+  // GradMode is disabled.
   template <typename T>
   static void accumulateGrad(
       const Variable& variable,
@@ -57,6 +63,7 @@ struct TORCH_API AccumulateGrad : public Node {
         // holding references to the Tensor and that is fine since these are not
         // exposed to the user.
         update_grad(new_grad.detach());
+        impl::record_grad_accumulation(impl::GradAccumulation::Stolen);
       } else if (
           !GradMode::is_enabled() && new_grad.is_sparse() &&
           new_grad._indices().is_contiguous() &&
@@ -80,12 +87,14 @@ struct TORCH_API AccumulateGrad : public Node {
             new_grad._values(),
             new_grad.sizes(),
             new_grad.options()));
+        impl::record_grad_accumulation(impl::GradAccumulation::Stolen);
       } else {
         if (new_grad.is_sparse()) {
           update_grad(new_grad.clone());
         } else {
           update_grad(new_grad.clone(at::MemoryFormat::Contiguous));
         }
+        impl::record_grad_accumulation(impl::GradAccumulation::Allocated);
       }
     } else if (!GradMode::is_enabled()) {
       // This case is not strictly necessary, but it makes the first-order only
@@ -97,6 +106,7 @@ struct TORCH_API AccumulateGrad : public Node {
         // TensorImpl type of a tensor requires changing the tensor itself, and
         // thus in this case we have to change the grad tensor.
         update_grad(new_grad + variable_grad);
+        impl::record_grad_accumulation(impl::GradAccumulation::Allocated);
       } else {
         // In this case we can avoid changing the grad tensor. There are three
         // scenarios when we'll hit this case:
@@ -110,9 +120,11 @@ struct TORCH_API AccumulateGrad : public Node {
         // place. `variable_grad` is thus still referring to the same tensor
         // after the operation.
         variable_grad += new_grad;
+        impl::record_grad_accumulation(impl::GradAccumulation::InPlace);
       }
     } else {
       update_grad(variable_grad + new_grad);
+      impl::record_grad_accumulation(impl::GradAccumulation::Allocated);
     }
   }
 
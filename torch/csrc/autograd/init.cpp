@@ -5,8 +5,66 @@
 #include <torch/csrc/autograd/grad_mode.h>
 #include <ATen/autocast_mode.h>
 #include <torch/csrc/autograd/profiler.h>
+#include <torch/csrc/autograd/profiler_sampled.h>
 #include <torch/csrc/autograd/python_function.h>
 #include <torch/csrc/autograd/function.h>
+#include <torch/csrc/autograd/input_buffer.h>
+#include <torch/csrc/autograd/saved_variable_hooks.h>
+
+namespace {
+
+using torch::autograd::PackedTensor;
+using torch::autograd::SavedTensorHooks;
+
+// Saved tensor packed by a Python pack_hook. Can be unpacked and destroyed by
+// the autograd engine threads, which don't hold the GIL.
+struct PyPackedTensor : PackedTensor {
+  PyPackedTensor(py::object packed, py::object unpack_hook)
+      : packed_(std::move(packed)), unpack_hook_(std::move(unpack_hook)) {}
+
+  ~PyPackedTensor() override {
+    pybind11::gil_scoped_acquire gil;
+    packed_ = py::object();
+    unpack_hook_ = py::object();
+  }
+
+  at::Tensor unpack() override {
+    pybind11::gil_scoped_acquire gil;
+    py::object result = unpack_hook_(packed_);
+    TORCH_CHECK(
+        THPVariable_Check(result.ptr()),
+        "unpack_hook should return a Tensor, but got ",
+        Py_TYPE(result.ptr())->tp_name);
+    return result.cast<at::Tensor>();
+  }
+
+ private:
+  py::object packed_;
+  py::object unpack_hook_;
+};
+
+struct PySavedTensorHooks : SavedTensorHooks {
+  PySavedTensorHooks(py::object pack_hook, py::object unpack_hook)
+      : pack_hook_(std::move(pack_hook)), unpack_hook_(std::move(unpack_hook)) {}
+
+  ~PySavedTensorHooks() override {
+    pybind11::gil_scoped_acquire gil;
+    pack_hook_ = py::object();
+    unpack_hook_ = py::object();
+  }
+
+  std::shared_ptr<PackedTensor> pack(const at::Tensor& tensor) override {
+    pybind11::gil_scoped_acquire gil;
+    py::object packed = pack_hook_(tensor);
+    return std::make_shared<PyPackedTensor>(std::move(packed), unpack_hook_);
+  }
+
+ private:
+  py::object pack_hook_;
+  py::object unpack_hook_;
+};
+
+} // namespace
 
 PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
   using namespace torch::autograd::profiler;
@@ -37,7 +95,16 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
       .value("NVTX", ProfilerState::NVTX);
 
   py::class_<ProfilerConfig>(m, "ProfilerConfig")
-      .def(py::init<ProfilerState, bool, bool>());
+      .def(py::init<ProfilerState, bool, bool>())
+      .def(py::init<ProfilerState, bool, bool, bool>());
+
+  py::enum_<at::RecordScope>(m, "RecordScope")
+      .value("FUNCTION", at::RecordScope::FUNCTION)
+      .value("TORCHSCRIPT_FUNCTION", at::RecordScope::TORCHSCRIPT_FUNCTION)
+      .value("USER_SCOPE", at::RecordScope::USER_SCOPE)
+      .value("BACKWARD_FUNCTION", at::RecordScope::BACKWARD_FUNCTION)
+      .value("INTRAOP_TASK", at::RecordScope::INTRAOP_TASK)
+      .value("INTEROP_TASK", at::RecordScope::INTEROP_TASK);
 
   py::class_<Event>(m, "ProfilerEvent")
       .def("kind", &Event::kind)
@@ -52,7 +119,12 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
       .def("cuda_memory_usage", &Event::cuda_memory_usage)
       .def("handle", &Event::handle)
       .def("node_id", &Event::node_id)
-      .def("is_remote", &Event::isRemote);
+      .def("is_remote", &Event::isRemote)
+      .def("scope", &Event::scope)
+      .def("sequence_nr", &Event::sequence_nr)
+      .def("counter_value", &Event::counter_value)
+      .def("alloc_ptr", &Event::alloc_ptr)
+      .def("source_location", &Event::source_location);
 
   m.def("_enable_profiler", enableProfiler);
   m.def("_disable_profiler", disableProfiler);
@@ -60,6 +132,62 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
   m.def("_enable_record_function", [](bool enable) {
     at::enableRecordFunction(enable);
   });
+  m.def(
+      "_enable_sampled_profiler",
+      [](double sampling_prob, size_t buffer_capacity) {
+        SampledProfilerConfig config;
+        config.sampling_prob = sampling_prob;
+        config.buffer_capacity = buffer_capacity;
+        enableSampledProfiler(std::move(config));
+      });
+  m.def("_disable_sampled_profiler", []() {
+    auto events = disableSampledProfiler();
+    py::list ranges;
+    for (const auto& range : sampledRanges(events)) {
+      ranges.append(py::make_tuple(
+          sampledEventName(range.name_id),
+          range.thread_id,
+          range.start_ns,
+          range.end_ns));
+    }
+    return py::make_tuple(ranges, sampledProfilerDroppedEvents());
+  });
+
+  using torch::autograd::SavedTensorHooks;
+  py::class_<SavedTensorHooks, std::shared_ptr<SavedTensorHooks>>(
+      m, "_SavedTensorHooks");
+  m.def("_python_saved_tensors_hooks",
+        [](py::object pack_hook, py::object unpack_hook)
+            -> std::shared_ptr<SavedTensorHooks> {
+          return std::make_shared<PySavedTensorHooks>(
+              std::move(pack_hook), std::move(unpack_hook));
+        });
+  m.def("_compress_saved_tensors_hooks",
+        [](bool quantize, int64_t min_numel)
+            -> std::shared_ptr<SavedTensorHooks> {
+          return std::make_shared<torch::autograd::CompressSavedTensors>(
+              quantize ? at::kQUInt8 : at::kBFloat16, min_numel);
+        });
+  m.def("_spill_saved_tensors_hooks",
+        [](std::string directory, int64_t min_numel)
+            -> std::shared_ptr<SavedTensorHooks> {
+          return std::make_shared<torch::autograd::SpillSavedTensors>(
+              std::move(directory), min_numel);
+        });
+  m.def("_get_saved_tensors_hooks", torch::autograd::get_saved_tensor_hooks);
+  m.def("_set_saved_tensors_hooks", torch::autograd::set_saved_tensor_hooks);
+
+  m.def("_grad_accumulation_stats", []() {
+    auto stats = torch::autograd::grad_accumulation_stats();
+    py::dict result;
+    result["in_place"] = stats.in_place;
+    result["stolen"] = stats.stolen;
+    result["allocated"] = stats.allocated;
+    return result;
+  });
+  m.def(
+      "_reset_grad_accumulation_stats",
+      torch::autograd::reset_grad_accumulation_stats);
 
   Py_RETURN_TRUE;
 }
@@ -1,35 +1,107 @@
 #include <torch/csrc/autograd/input_buffer.h>
 
+#include <torch/csrc/autograd/grad_mode.h>
+
 #include <c10/core/DeviceGuard.h>
 #include <c10/core/StreamGuard.h>
 #include <c10/core/Event.h>
 #include <c10/util/Optional.h>
 
+#include <atomic>
 #include <cstddef>
 #include <utility>
 #include <vector>
 
 namespace torch { namespace autograd {
 
+  namespace {
+
+  std::atomic<uint64_t> num_in_place{0};
+  std::atomic<uint64_t> num_stolen{0};
+  std::atomic<uint64_t> num_allocated{0};
+
+  // Whether `dst.add_(src)` gives the same result as `dst + src` without
+  // anybody noticing: dst must be referenced by the engine only (the tensor
+  // and its storage, so that it isn't a view of or viewed by anything else),
+  // and must not need to be promoted or broadcast. Modifying it in place is
+  // only fine when the backward isn't recorded for higher order gradients.
+  // Tensors without a strided storage (sparse, mkldnn, batched, ...) are
+  // always added out of place.
+  bool can_accumulate_in_place(const Variable& dst, const Variable& src) {
+    return !GradMode::is_enabled() && dst.layout() == c10::kStrided &&
+        src.layout() == c10::kStrided && dst.has_storage() &&
+        dst.use_count() == 1 && dst.storage().use_count() == 1 &&
+        dst.unsafeGetTensorImpl()->is_non_overlapping_and_dense() &&
+        dst.scalar_type() == src.scalar_type() &&
+        dst.device() == src.device() && dst.sizes().equals(src.sizes());
+  }
+
+  } // namespace
+
+  namespace impl {
+
+  void record_grad_accumulation(GradAccumulation kind) {
+    switch (kind) {
+      case GradAccumulation::InPlace:
+        num_in_place.fetch_add(1, std::memory_order_relaxed);
+        break;
+      case GradAccumulation::Stolen:
+        num_stolen.fetch_add(1, std::memory_order_relaxed);
+        break;
+      case GradAccumulation::Allocated:
+        num_allocated.fetch_add(1, std::memory_order_relaxed);
+        break;
+    }
+  }
+
+  } // namespace impl
+
+  GradAccumulationStats grad_accumulation_stats() {
+    GradAccumulationStats stats;
+    stats.in_place = num_in_place.load(std::memory_order_relaxed);
+    stats.stolen = num_stolen.load(std::memory_order_relaxed);
+    stats.allocated = num_allocated.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+  void reset_grad_accumulation_stats() {
+    num_in_place.store(0, std::memory_order_relaxed);
+    num_stolen.store(0, std::memory_order_relaxed);
+    num_allocated.store(0, std::memory_order_relaxed);
+  }
+
   static void accumulate(std::vector<Variable>& buffer,
                          const size_t pos,
                          Variable&& var) {
     TORCH_INTERNAL_ASSERT(pos < buffer.size());
     auto& old_var = buffer[pos];
+    using impl::GradAccumulation;
     // ATen doesn't route sparse additions correctly...
     // do dense + sparse in-place if possible
     if (old_var.is_sparse()) {
       //storage use_count is a big hammer, but for anything lighter there's an adversarial example with unexpected inplace modification
       if (!var.is_sparse() && var.is_contiguous() && var.storage().use_count() == 1) {
           buffer[pos] = var.add_(old_var);
+          impl::record_grad_accumulation(GradAccumulation::InPlace);
       } else {
           buffer[pos] = var + old_var;
+          impl::record_grad_accumulation(GradAccumulation::Allocated);
       }
     } else {
       if (var.is_sparse() && !old_var.is_sparse() && old_var.is_contiguous() && old_var.storage().use_count() == 1) {
           buffer[pos] = old_var.add_(var);
+          impl::record_grad_accumulation(GradAccumulation::InPlace);
+      } else if (can_accumulate_in_place(old_var, var)) {
+          // Fan-out: the gradients of every use of a value are summed here, so
+          // summing into the first one saves a temporary per use.
+          old_var.add_(var);
+          impl::record_grad_accumulation(GradAccumulation::InPlace);
+      } else if (can_accumulate_in_place(var, old_var)) {
+          buffer[pos] = var.add_(old_var);
+          impl::record_grad_accumulation(GradAccumulation::InPlace);
       } else {
           buffer[pos] = old_var + var;
+          impl::record_grad_accumulation(GradAccumulation::Allocated);
       }
     }
   }
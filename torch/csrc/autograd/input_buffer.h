@@ -5,11 +5,13 @@
 // values in-place (adding an input twice will accumulate the result).
 // This behaviour is needed and used only in backward graphs.
 
+#include <cstdint>
 #include <vector>
 #include <utility>
 #include <memory>
 #include <ATen/ATen.h>
 
+#include <torch/csrc/WindowsTorchApiMacro.h>
 #include <torch/csrc/autograd/variable.h>
 #include <c10/util/Optional.h>
 #include <c10/core/Stream.h>
@@ -26,6 +28,8 @@ struct InputBuffer {
   // Accumulates the variable at a specified index.
   // The optional CUDA streams determine which stream the accumulation
   // is run on and how the addition is synchronized.
+  // When the backward isn't differentiated, dense gradients are summed in
+  // place into whichever of the two is uniquely owned by the engine.
   void add(size_t pos,
            Variable&& var,
            const c10::optional<c10::Stream>& opt_producer_stream,
@@ -42,4 +46,27 @@ private:
   std::vector<Variable> buffer;
 };
 
+// Counts how the gradients received by functions were accumulated, in
+// InputBuffer and AccumulateGrad, since the last reset. Only `allocated`
+// needed a new tensor.
+struct GradAccumulationStats {
+  // summed in place into one of the gradients
+  uint64_t in_place = 0;
+  // taken as the .grad of a leaf without a copy
+  uint64_t stolen = 0;
+  // summed or copied into a new tensor
+  uint64_t allocated = 0;
+};
+
+TORCH_API GradAccumulationStats grad_accumulation_stats();
+TORCH_API void reset_grad_accumulation_stats();
+
+namespace impl {
+
+enum class GradAccumulation { InPlace, Stolen, Allocated };
+
+TORCH_API void record_grad_accumulation(GradAccumulation kind);
+
+} // namespace impl
+
 }}  // namespace torch::autograd
@@ -2,16 +2,20 @@
 #include <torch/csrc/autograd/function.h>
 #include <torch/csrc/jit/frontend/code_template.h>
 
+#include <torch/csrc/jit/runtime/interpreter.h>
 #include <torch/csrc/jit/runtime/operator.h>
 
 #include <ATen/core/op_registration/op_registration.h>
 #include <torch/library.h>
 
+#include <atomic>
 #include <fstream>
 #include <list>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <ATen/record_function.h>
@@ -24,8 +28,8 @@ namespace torch { namespace autograd { namespace profiler {
 
 namespace {
 
-  constexpr auto kProfilerConfigIValuesSize = 3;
-  constexpr auto kEventIValuesSize = 11;
+  constexpr auto kProfilerConfigIValuesSize = 4;
+  constexpr auto kEventIValuesSize = 14;
   enum EventIValueIdx {
     KIND = 0,
     NAME,
@@ -37,13 +41,17 @@ namespace {
     CUDA_RECORDED,
     CUDA_MEM_USAGE,
     CUDA_DEVICE,
-    CUDA_US
+    CUDA_US,
+    SCOPE,
+    SEQUENCE_NR,
+    COUNTER_VALUE
   };
 
   enum ProfilerIValueIdx {
     STATE = 0,
     REPORT_INPUT_SHAPES,
     PROFILE_MEMORY,
+    RECORD_TRACKS,
   };
 
 CUDAStubs default_stubs;
@@ -115,6 +123,9 @@ static CUDAStubs* cuda_stubs = default_stubs_addr;
 //  - c10/ATen ops
 //  - TorchScript functions/methods
 //  - user defined named ranges (see `record_function` python context manager)
+//  - autograd nodes
+//  - with record_tracks, intra-op (at::parallel_for) and inter-op
+//    (at::launch) thread pool tasks
 //
 // Profiler setups a pair of callbacks that record profiling events and save them
 // into the thread local profiler struct (ThreadLocalDebugInfo, PROFILER_STATE slot)
@@ -206,7 +217,8 @@ struct ProfilerThreadLocalState
       const char* msg = "",
       int64_t sequence_nr = -1,
       std::vector<std::vector<int64_t>>&& shapes = {},
-      at::RecordFunctionHandle handle = 0) {
+      at::RecordFunctionHandle handle = 0,
+      at::RecordScope scope = at::RecordScope::FUNCTION) {
     if (config_.state == ProfilerState::Disabled) {
       return;
     }
@@ -214,7 +226,7 @@ struct ProfilerThreadLocalState
       cuda_stubs->nvtxRangePushA(getNvtxStr(
           name, msg, sequence_nr, shapes).c_str());
     } else {
-      getEventList().record(
+      Event evt(
           EventKind::PushRange,
           name,
           at::RecordFunction::currentThreadId(),
@@ -222,6 +234,9 @@ struct ProfilerThreadLocalState
           handle,
           std::move(shapes),
           at::RecordFunction::getDefaultNodeId());
+      evt.setScope(scope);
+      evt.setSequenceNr(sequence_nr);
+      getEventList().record(std::move(evt));
     }
   }
 
@@ -246,6 +261,21 @@ struct ProfilerThreadLocalState
     }
   }
 
+  void recordCounter(const char* name, int64_t value) {
+    if (!config_.record_tracks || config_.state == ProfilerState::Disabled ||
+        config_.state == ProfilerState::NVTX) {
+      return;
+    }
+    Event evt(
+        EventKind::Counter,
+        at::StringView(name),
+        at::RecordFunction::currentThreadId(),
+        /* record_cuda */ false);
+    evt.setCounterValue(value);
+    evt.setNodeId(at::RecordFunction::getDefaultNodeId());
+    getEventList().record(std::move(evt));
+  }
+
   void setCallbackHandle(at::CallbackHandle handle) {
     handle_ = handle;
   }
@@ -255,16 +285,28 @@ struct ProfilerThreadLocalState
   }
 
   void reportMemoryUsage(
-      void* /* unused */, int64_t alloc_size, c10::Device device) override {
+      void* ptr, int64_t alloc_size, c10::Device device) override {
     if (config_.profile_memory && config_.state != ProfilerState::Disabled) {
       uint64_t thread_id = at::RecordFunction::currentThreadId();
+      // Allocations are attributed to the outermost op running on this
+      // thread (the innermost one is usually a factory like empty) and to the
+      // TorchScript source that made them. Frees are matched with their
+      // allocation through ptr.
+      at::RecordFunction* op = at::RecordFunction::current();
+      while (op && op->parent()) {
+        op = op->parent();
+      }
       Event evt(
           EventKind::MemoryAlloc,
-          at::StringView(""),
+          alloc_size > 0 && op ? op->name() : at::StringView(""),
           thread_id,
           config_.state == ProfilerState::CUDA);
       evt.updateMemoryStats(alloc_size, device);
-      getEventList(thread_id).record(evt);
+      evt.setAllocPtr(ptr);
+      if (alloc_size > 0) {
+        evt.setSourceLocation(jit::currentInterpreterSourceLocation());
+      }
+      getEventList(thread_id).record(std::move(evt));
     }
   }
 
@@ -341,6 +383,24 @@ ProfilerThreadLocalState* getProfilerTLSState() {
   return dynamic_cast<ProfilerThreadLocalState*>(state.get());
 }
 
+std::unordered_set<at::RecordScope, std::hash<at::RecordScope>> profiledScopes(
+    const ProfilerConfig& config) {
+  if (config.record_tracks) {
+    // empty means all the scopes
+    return {};
+  }
+  // Thread pool tasks would show up as the parents of the ops they run, and
+  // change their self times, so only record them when they are exported
+  return {
+      at::RecordScope::FUNCTION,
+      at::RecordScope::TORCHSCRIPT_FUNCTION,
+      at::RecordScope::USER_SCOPE,
+      at::RecordScope::BACKWARD_FUNCTION};
+}
+
+// Number of profiling runs with record_tracks
+std::atomic<int> tracks_enabled_count{0};
+
 void pushProfilingCallbacks() {
   auto state_ptr = getProfilerTLSState();
   TORCH_INTERNAL_ASSERT(state_ptr, "Expected profiler state set");
@@ -368,9 +428,15 @@ void pushProfilingCallbacks() {
             }
           }
           state_ptr->pushRange(
-              fn.name(), msg, fn.seqNr(), std::move(inputSizes), fn.handle());
+              fn.name(),
+              msg,
+              fn.seqNr(),
+              std::move(inputSizes),
+              fn.handle(),
+              fn.scope());
         } else {
-          state_ptr->pushRange(fn.name(), msg, fn.seqNr(), {}, fn.handle());
+          state_ptr->pushRange(
+              fn.name(), msg, fn.seqNr(), {}, fn.handle(), fn.scope());
         }
       },
       [](const at::RecordFunction& fn) {
@@ -381,7 +447,8 @@ void pushProfilingCallbacks() {
         state_ptr->popRange(fn.getStartCallbacksThreadId(), fn.handle());
       })
     .needsInputs(state_ptr->config().report_input_shapes)
-    .needsIds(true));
+    .needsIds(true)
+    .scopes(profiledScopes(state_ptr->config())));
   state_ptr->setCallbackHandle(handle);
 }
 
@@ -404,6 +471,7 @@ at::IValue ProfilerConfig::toIValue() const {
   eventIValueList.emplace_back(static_cast<int64_t>(state));
   eventIValueList.emplace_back(report_input_shapes);
   eventIValueList.emplace_back(profile_memory);
+  eventIValueList.emplace_back(record_tracks);
   return eventIValueList;
 }
 
@@ -422,7 +490,8 @@ ProfilerConfig ProfilerConfig::fromIValue(
   return ProfilerConfig(
       static_cast<ProfilerState>(ivalues.get(ProfilerIValueIdx::STATE).toInt()),
       ivalues.get(ProfilerIValueIdx::REPORT_INPUT_SHAPES).toBool(),
-      ivalues.get(ProfilerIValueIdx::PROFILE_MEMORY).toBool());
+      ivalues.get(ProfilerIValueIdx::PROFILE_MEMORY).toBool(),
+      ivalues.get(ProfilerIValueIdx::RECORD_TRACKS).toBool());
 }
 
 ProfilerConfig getProfilerConfig() {
@@ -433,6 +502,17 @@ ProfilerConfig getProfilerConfig() {
   return state_ptr->config();
 }
 
+void recordCounter(const char* name, int64_t value) {
+  auto state_ptr = getProfilerTLSState();
+  if (state_ptr) {
+    state_ptr->recordCounter(name, value);
+  }
+}
+
+bool profilerTracksEnabled() {
+  return tracks_enabled_count.load(std::memory_order_relaxed) > 0;
+}
+
 bool profilerEnabled() {
   auto state_ptr = getProfilerTLSState();
   return state_ptr && state_ptr->config().state != ProfilerState::Disabled;
@@ -450,6 +530,9 @@ void enableProfiler(const ProfilerConfig& new_config) {
 
   pushProfilingCallbacks();
   g_.emplace_back(std::make_shared<at::RecordFunctionGuard>());
+  if (new_config.record_tracks) {
+    ++tracks_enabled_count;
+  }
 
   if (new_config.state == ProfilerState::CUDA) {
     // event recording appears to have some startup overhead, so we need to
@@ -480,6 +563,9 @@ thread_event_lists disableProfiler() {
 
   g_.pop_back();
   at::removeCallback(state_ptr->callbackHandle());
+  if (state_ptr->config().record_tracks) {
+    --tracks_enabled_count;
+  }
 
   if (state_ptr->config().state == ProfilerState::NVTX) {
     return thread_event_lists();
@@ -532,6 +618,10 @@ void Event::record(bool record_cuda) {
       ivalues.get(EventIValueIdx::CUDA_DEVICE).toInt(), // device
       ivalues.get(EventIValueIdx::CUDA_US).toInt() // cuda_us
   );
+  evt.setScope(static_cast<at::RecordScope>(
+      ivalues.get(EventIValueIdx::SCOPE).toInt()));
+  evt.setSequenceNr(ivalues.get(EventIValueIdx::SEQUENCE_NR).toInt());
+  evt.setCounterValue(ivalues.get(EventIValueIdx::COUNTER_VALUE).toInt());
   return evt;
 }
 
@@ -551,6 +641,9 @@ at::IValue Event::toIValue() const {
   eventIValueList.emplace_back(static_cast<int64_t>(cuda_memory_usage_));
   eventIValueList.emplace_back(device_);
   eventIValueList.emplace_back(cuda_us_);
+  eventIValueList.emplace_back(static_cast<int64_t>(scope_));
+  eventIValueList.emplace_back(sequence_nr_);
+  eventIValueList.emplace_back(counter_value_);
   return at::IValue(eventIValueList);
 }
 
@@ -578,10 +671,50 @@ static jit::CodeTemplate event_template(R"(
   "ts": ${ts},
   "dur": ${dur},
   "tid": ${tid},
-  "pid": "CPU Functions",
+  "pid": "${pid}",
   "args": {}
 })");
 
+static jit::CodeTemplate counter_template(R"(
+{
+  "name": "${name}",
+  "ph": "C",
+  "ts": ${ts},
+  "pid": "${pid}",
+  "args": {"${series}": ${value}}
+})");
+
+// 's' and 'f' draw a flow arrow between the slices enclosing them
+static jit::CodeTemplate flow_template(R"(
+{
+  "name": "${name}",
+  "ph": "${ph}",
+  "ts": ${ts},
+  "tid": ${tid},
+  "pid": "${pid}",
+  "id": ${id},
+  "cat": "forward_backward",
+  "bp": "e",
+  "args": {}
+})");
+
+namespace {
+
+// Thread pool tasks go to their own process in the trace, so that they are
+// shown as separate tracks
+const char* tracePid(at::RecordScope scope) {
+  switch (scope) {
+    case at::RecordScope::INTRAOP_TASK:
+      return "Intra-op pool";
+    case at::RecordScope::INTEROP_TASK:
+      return "Inter-op pool";
+    default:
+      return "CPU Functions";
+  }
+}
+
+} // namespace
+
 void writeProfilerEventsToStream(std::ostream& out, const std::vector<Event*>& events) {
   TORCH_CHECK(out, "Could not open file");
   Event* profiler_start = nullptr;
@@ -600,29 +733,122 @@ void writeProfilerEventsToStream(std::ostream& out, const std::vector<Event*>& e
     }
   };
   std::unordered_map<std::pair<at::RecordFunctionHandle, int64_t>, Event*, PairHash> events_map;
+  std::vector<std::pair<Event*, Event*>> ranges;
+  std::vector<Event*> memory_events;
+  std::vector<Event*> counter_events;
+  for (Event* evt : events) {
+    switch (evt->eventKind()) {
+      case EventKind::PushRange:
+        events_map[std::make_pair(evt->handle(), evt->node_id())] = evt;
+        break;
+      case EventKind::PopRange: {
+        auto it = events_map.find(std::make_pair(evt->handle(), evt->node_id()));
+        TORCH_CHECK(it != events_map.end(), "Unmatched pop event");
+        ranges.emplace_back(it->second, evt);
+        events_map.erase(it);
+        break;
+      }
+      case EventKind::MemoryAlloc:
+        memory_events.push_back(evt);
+        break;
+      case EventKind::Counter:
+        counter_events.push_back(evt);
+        break;
+      default:
+        break;
+    }
+  }
+
   out << "[\n";
   bool first = true;
-  for (Event* evt : events) {
-    if (evt->kind() == "push") {
-      events_map[std::make_pair(evt->handle(), evt->node_id())] = evt;
-    } else if (evt->kind() == "pop") {
-      if (!first) {
-        out << ",\n";
+  auto write = [&](const jit::CodeTemplate& event_template, const jit::TemplateEnv& env) {
+    if (!first) {
+      out << ",\n";
+    }
+    first = false;
+    out << event_template.format(env);
+  };
+
+  std::stable_sort(
+      ranges.begin(), ranges.end(),
+      [](const std::pair<Event*, Event*>& a, const std::pair<Event*, Event*>& b) {
+        return a.first->cpu_us() < b.first->cpu_us();
+      });
+  // Latest forward op seen with each sequence number, which is the one that
+  // created the autograd node with that number (the ops nested in it, and the
+  // following ops that don't create a node, see the next number).
+  std::unordered_map<int64_t, Event*> forward_ops;
+  int64_t next_flow_id = 0;
+  for (const auto& range : ranges) {
+    Event* evt_start = range.first;
+    jit::TemplateEnv env;
+    env.s("name", evt_start->name());
+    env.d("ts", profiler_start->cpu_elapsed_us(*evt_start));
+    env.d("dur", evt_start->cpu_elapsed_us(*range.second));
+    env.d("tid", evt_start->thread_id());
+    env.s("pid", tracePid(evt_start->scope()));
+    write(event_template, env);
+
+    if (evt_start->sequence_nr() < 0) {
+      continue;
+    }
+    if (evt_start->scope() == at::RecordScope::FUNCTION) {
+      forward_ops[evt_start->sequence_nr()] = evt_start;
+    } else if (evt_start->scope() == at::RecordScope::BACKWARD_FUNCTION) {
+      auto it = forward_ops.find(evt_start->sequence_nr());
+      if (it == forward_ops.end()) {
+        continue;
       }
-      first = false;
-      auto it = events_map.find(std::make_pair(evt->handle(), evt->node_id()));
-      TORCH_CHECK(it != events_map.end(), "Unmatched pop event");
-      Event* evt_start = it->second;
-      events_map.erase(it);
-
-      jit::TemplateEnv env;
-      env.s("name", evt_start->name());
-      env.d("ts", profiler_start->cpu_elapsed_us(*evt_start));
-      env.d("dur", evt_start->cpu_elapsed_us(*evt));
-      env.d("tid", evt_start->thread_id());
-      out << event_template.format(env);
+      for (Event* flow_evt : {it->second, evt_start}) {
+        jit::TemplateEnv flow_env;
+        flow_env.s("name", flow_evt->name());
+        flow_env.s("ph", flow_evt == evt_start ? "f" : "s");
+        flow_env.d("ts", profiler_start->cpu_elapsed_us(*flow_evt));
+        flow_env.d("tid", flow_evt->thread_id());
+        flow_env.s("pid", tracePid(flow_evt->scope()));
+        flow_env.d("id", next_flow_id);
+        write(flow_template, flow_env);
+      }
+      ++next_flow_id;
+      forward_ops.erase(it);
     }
   }
+
+  // Memory usage, relative to the start of the profiling
+  std::stable_sort(
+      memory_events.begin(), memory_events.end(),
+      [](Event* a, Event* b) { return a->cpu_us() < b->cpu_us(); });
+  int64_t cpu_memory = 0;
+  int64_t cuda_memory = 0;
+  for (Event* evt : memory_events) {
+    jit::TemplateEnv env;
+    env.d("ts", profiler_start->cpu_elapsed_us(*evt));
+    env.s("pid", "Memory");
+    env.s("series", "bytes");
+    if (evt->cpu_memory_usage() != 0) {
+      cpu_memory += evt->cpu_memory_usage();
+      env.s("name", "CPU memory");
+      env.d("value", cpu_memory);
+    } else {
+      cuda_memory += evt->cuda_memory_usage();
+      env.s("name", "CUDA memory");
+      env.d("value", cuda_memory);
+    }
+    write(counter_template, env);
+  }
+
+  std::stable_sort(
+      counter_events.begin(), counter_events.end(),
+      [](Event* a, Event* b) { return a->cpu_us() < b->cpu_us(); });
+  for (Event* evt : counter_events) {
+    jit::TemplateEnv env;
+    env.s("name", evt->name());
+    env.d("ts", profiler_start->cpu_elapsed_us(*evt));
+    env.s("pid", "Counters");
+    env.s("series", "value");
+    env.d("value", evt->counter_value());
+    write(counter_template, env);
+  }
   out << "]\n";
 }
 
@@ -641,7 +867,8 @@ void RecordProfile::init() {
   enableProfiler(ProfilerConfig(
       ProfilerState::CPU,
       /* report_input_shapes */ false,
-      /* profile_memory */ false));
+      /* profile_memory */ true,
+      /* record_tracks */ true));
 }
 
 RecordProfile::~RecordProfile() {
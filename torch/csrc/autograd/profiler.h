@@ -104,14 +104,20 @@ struct TORCH_API ProfilerConfig {
   ProfilerConfig(
       ProfilerState state,
       bool report_input_shapes,
-      bool profile_memory)
+      bool profile_memory,
+      bool record_tracks = false)
       : state(state),
         report_input_shapes(report_input_shapes),
-        profile_memory(profile_memory) {}
+        profile_memory(profile_memory),
+        record_tracks(record_tracks) {}
   ~ProfilerConfig();
   ProfilerState state;
   bool report_input_shapes;
   bool profile_memory;
+  // Also record the thread pool tasks (RecordScope::INTRAOP_TASK and
+  // INTEROP_TASK ranges) and the counters (see recordCounter), which are
+  // exported as separate tracks of the trace.
+  bool record_tracks;
 
   // Returns IValues corresponding to ProfilerConfig struct, to be used for
   // serialization.
@@ -127,6 +133,7 @@ enum class TORCH_API EventKind : uint16_t {
   PushRange,
   PopRange,
   MemoryAlloc,
+  Counter,
 };
 #ifndef _MSC_VER
 #  pragma GCC diagnostic pop
@@ -199,6 +206,7 @@ struct TORCH_API Event final {
       case EventKind::PushRange: return "push";
       case EventKind::PopRange: return "pop";
       case EventKind::MemoryAlloc: return "memory_alloc";
+      case EventKind::Counter: return "counter";
     }
     throw std::runtime_error("unknown EventKind");
   }
@@ -280,6 +288,56 @@ struct TORCH_API Event final {
     cuda_us_ = cuda_us;
 }
 
+  // Scope of the RecordFunction that pushed this range.
+  at::RecordScope scope() const {
+    return scope_;
+  }
+
+  void setScope(at::RecordScope scope) {
+    scope_ = scope;
+  }
+
+  // Sequence number of the RecordFunction that pushed this range, which
+  // matches forward ops with the autograd nodes that compute their backward,
+  // or -1.
+  int64_t sequence_nr() const {
+    return sequence_nr_;
+  }
+
+  void setSequenceNr(int64_t sequence_nr) {
+    sequence_nr_ = sequence_nr;
+  }
+
+  // Value of a counter event.
+  int64_t counter_value() const {
+    return counter_value_;
+  }
+
+  void setCounterValue(int64_t value) {
+    counter_value_ = value;
+  }
+
+  // Address of the memory allocated or freed by a memory event, which
+  // matches allocations with their frees.
+  int64_t alloc_ptr() const {
+    return alloc_ptr_;
+  }
+
+  void setAllocPtr(void* ptr) {
+    alloc_ptr_ = reinterpret_cast<int64_t>(ptr);
+  }
+
+  // TorchScript source ("file:line") that was running when a memory event
+  // was recorded, if any. The name of a memory allocation is the outermost
+  // op that was running on its thread.
+  const std::string& source_location() const {
+    return source_location_;
+  }
+
+  void setSourceLocation(std::string source_location) {
+    source_location_ = std::move(source_location);
+  }
+
 private:
   // signed to allow for negative intervals, initialized for safety.
   int64_t cpu_ns_ = 0;
@@ -295,6 +353,11 @@ private:
   int node_id_ = 0;
   bool is_remote_ = false;
   int64_t cuda_us_ = -1;
+  at::RecordScope scope_ = at::RecordScope::FUNCTION;
+  int64_t sequence_nr_ = -1;
+  int64_t counter_value_ = 0;
+  int64_t alloc_ptr_ = 0;
+  std::string source_location_;
 };
 
 // a linked-list of fixed sized vectors, to avoid
@@ -348,6 +411,12 @@ TORCH_API void addEventList(std::vector<Event>&& profiledEvents);
 TORCH_API bool profilerEnabled();
 // Retrieve the thread_local ProfilerConfig.
 TORCH_API ProfilerConfig getProfilerConfig();
+// Records the current value of the counter `name` (e.g. the depth of a
+// queue), if the profiler is enabled on the current thread with record_tracks.
+TORCH_API void recordCounter(const char* name, int64_t value);
+// Returns whether any thread is profiled with record_tracks. It is a cheap
+// check for code that needs some work to find out what to record.
+TORCH_API bool profilerTracksEnabled();
 // Writes profiled events to a stream.
 TORCH_API void writeProfilerEventsToStream(std::ostream& out, const std::vector<Event*>& events);
 
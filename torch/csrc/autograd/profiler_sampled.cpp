@@ -0,0 +1,290 @@
+#include <torch/csrc/autograd/profiler_sampled.h>
+
+#include <torch/csrc/autograd/profiler.h>
+
+#include <c10/util/Exception.h>
+#include <c10/util/llvmMathExtras.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace torch { namespace autograd { namespace profiler {
+
+namespace {
+
+// Interned names. Ids are never reused, and the strings are never freed, so
+// that the thread local caches below can keep pointers to them.
+struct NameTable {
+  uint32_t intern(const char* name) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+      return it->second;
+    }
+    names_.emplace_back(name);
+    uint32_t id = names_.size() - 1;
+    ids_.emplace(names_.back(), id);
+    return id;
+  }
+
+  const std::string& name(uint32_t id) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    TORCH_CHECK(id < names_.size(), "unknown sampled event name id ", id);
+    return names_[id];
+  }
+
+ private:
+  std::mutex mutex_;
+  // deque, so that references stay valid when names are added
+  std::deque<std::string> names_;
+  std::unordered_map<std::string, uint32_t> ids_;
+};
+
+NameTable& nameTable() {
+  static NameTable table;
+  return table;
+}
+
+constexpr size_t kMaxCachedNames = 4096;
+
+// Maps the name pointers seen by this thread to their ids. The pointer alone
+// isn't enough, since a name may be freed and its memory reused for another
+// one, so a hit is confirmed by comparing the string.
+uint32_t internName(const char* name) {
+  thread_local std::unordered_map<const char*, std::pair<uint32_t, const std::string*>> cache;
+  auto it = cache.find(name);
+  if (it != cache.end() && std::strcmp(it->second.second->c_str(), name) == 0) {
+    return it->second.first;
+  }
+  if (cache.size() >= kMaxCachedNames) {
+    // Names built on the fly (e.g. by record_function) would grow it forever
+    cache.clear();
+  }
+  auto& table = nameTable();
+  uint32_t id = table.intern(name);
+  cache[name] = std::make_pair(id, &table.name(id));
+  return id;
+}
+
+// Single producer (the thread that owns it), single consumer (the flusher,
+// serialized by drain_mutex_) ring buffer.
+struct EventRing {
+  explicit EventRing(size_t capacity)
+      : events_(c10::llvm::PowerOf2Ceil(std::max<size_t>(capacity, 2))),
+        mask_(events_.size() - 1) {}
+
+  bool push(const SampledEvent& event) {
+    auto head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == events_.size()) {
+      return false;
+    }
+    events_[head & mask_] = event;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  void drain(std::vector<SampledEvent>& out) {
+    std::lock_guard<std::mutex> guard(drain_mutex_);
+    auto tail = tail_.load(std::memory_order_relaxed);
+    auto head = head_.load(std::memory_order_acquire);
+    for (; tail != head; ++tail) {
+      out.push_back(events_[tail & mask_]);
+    }
+    tail_.store(tail, std::memory_order_release);
+  }
+
+ private:
+  std::vector<SampledEvent> events_;
+  const size_t mask_;
+  std::mutex drain_mutex_;
+  // Keep the indices written by the producer and the consumer on separate
+  // cache lines.
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) std::atomic<size_t> tail_{0};
+};
+
+struct Session {
+  explicit Session(SampledProfilerConfig config)
+      : config(std::move(config)), id(next_id++) {}
+
+  // Returns the ring buffer of the current thread, creating it the first
+  // time the thread records an event in this session.
+  EventRing& localRing() {
+    struct LocalRing {
+      uint64_t session_id = 0;
+      std::shared_ptr<EventRing> ring;
+    };
+    thread_local LocalRing local;
+    if (C10_UNLIKELY(local.session_id != id)) {
+      local.ring = std::make_shared<EventRing>(config.buffer_capacity);
+      local.session_id = id;
+      std::lock_guard<std::mutex> guard(rings_mutex);
+      rings.push_back(local.ring);
+    }
+    return *local.ring;
+  }
+
+  void record(const at::RecordFunction& fn, SampledEventKind kind) {
+    SampledEvent event;
+    event.time_ns = getTime();
+    event.handle = fn.handle();
+    event.thread_id = at::RecordFunction::currentThreadId();
+    event.name_id = kind == SampledEventKind::PushRange ? internName(fn.name().str()) : 0;
+    event.kind = kind;
+    if (!localRing().push(event)) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  void flush() {
+    std::vector<std::shared_ptr<EventRing>> to_drain;
+    {
+      std::lock_guard<std::mutex> guard(rings_mutex);
+      to_drain = rings;
+    }
+    std::vector<SampledEvent> events;
+    for (auto& ring : to_drain) {
+      ring->drain(events);
+    }
+    if (events.empty()) {
+      return;
+    }
+    if (config.sink) {
+      config.sink(std::move(events));
+    } else {
+      std::lock_guard<std::mutex> guard(events_mutex);
+      kept_events.insert(kept_events.end(), events.begin(), events.end());
+    }
+  }
+
+  void flusherMain() {
+    std::unique_lock<std::mutex> lock(stop_mutex);
+    while (!stop) {
+      stop_cv.wait_for(lock, config.flush_interval);
+      lock.unlock();
+      flush();
+      lock.lock();
+    }
+  }
+
+  const SampledProfilerConfig config;
+  const uint64_t id;
+  std::atomic<uint64_t> dropped{0};
+  at::CallbackHandle callback_handle = 0;
+
+  std::mutex rings_mutex;
+  std::vector<std::shared_ptr<EventRing>> rings;
+
+  std::mutex events_mutex;
+  std::vector<SampledEvent> kept_events;
+
+  std::thread flusher;
+  std::mutex stop_mutex;
+  std::condition_variable stop_cv;
+  bool stop = false;
+
+  static std::atomic<uint64_t> next_id;
+};
+
+// 0 is the id of the thread local rings that were never used
+std::atomic<uint64_t> Session::next_id{1};
+
+std::shared_ptr<Session> current_session;
+uint64_t last_dropped = 0;
+
+} // namespace
+
+void enableSampledProfiler(SampledProfilerConfig config) {
+  TORCH_CHECK(!current_session, "The sampled profiler is already enabled");
+  TORCH_CHECK(
+      config.sampling_prob > 0 && config.sampling_prob <= 1,
+      "sampling probability should be in (0, 1], but got ",
+      config.sampling_prob);
+  auto session = std::make_shared<Session>(std::move(config));
+  session->callback_handle = at::addGlobalCallback(
+      at::RecordFunctionCallback(
+          [session](const at::RecordFunction& fn) {
+            session->record(fn, SampledEventKind::PushRange);
+          },
+          [session](const at::RecordFunction& fn) {
+            session->record(fn, SampledEventKind::PopRange);
+          })
+          .needsIds(true)
+          .samplingProb(session->config.sampling_prob));
+  session->flusher = std::thread([session]() { session->flusherMain(); });
+  current_session = std::move(session);
+}
+
+std::vector<SampledEvent> disableSampledProfiler() {
+  TORCH_CHECK(current_session, "The sampled profiler is not enabled");
+  auto session = std::move(current_session);
+  at::removeCallback(session->callback_handle);
+  {
+    std::lock_guard<std::mutex> guard(session->stop_mutex);
+    session->stop = true;
+  }
+  session->stop_cv.notify_one();
+  session->flusher.join();
+  session->flush();
+  last_dropped = session->dropped.load();
+  std::lock_guard<std::mutex> guard(session->events_mutex);
+  return std::move(session->kept_events);
+}
+
+bool sampledProfilerEnabled() {
+  return current_session != nullptr;
+}
+
+uint64_t sampledProfilerDroppedEvents() {
+  return current_session ? current_session->dropped.load() : last_dropped;
+}
+
+std::string sampledEventName(uint32_t name_id) {
+  return nameTable().name(name_id);
+}
+
+std::vector<SampledRange> sampledRanges(const std::vector<SampledEvent>& events) {
+  // Events are only ordered within a thread, and a range may end on another
+  // thread than the one it started on.
+  std::vector<const SampledEvent*> sorted;
+  sorted.reserve(events.size());
+  for (const auto& event : events) {
+    sorted.push_back(&event);
+  }
+  std::stable_sort(sorted.begin(), sorted.end(), [](const SampledEvent* a, const SampledEvent* b) {
+    return a->time_ns < b->time_ns;
+  });
+
+  std::unordered_map<at::RecordFunctionHandle, const SampledEvent*> pushes;
+  std::vector<SampledRange> ranges;
+  for (const SampledEvent* event_ptr : sorted) {
+    const SampledEvent& event = *event_ptr;
+    if (event.kind == SampledEventKind::PushRange) {
+      pushes[event.handle] = &event;
+      continue;
+    }
+    auto it = pushes.find(event.handle);
+    if (it == pushes.end()) {
+      continue;
+    }
+    const SampledEvent& push = *it->second;
+    // Like the autograd profiler, ranges belong to the thread they started
+    // on, even if they ended on another one.
+    ranges.push_back(
+        SampledRange{push.name_id, push.thread_id, push.time_ns, event.time_ns});
+    pushes.erase(it);
+  }
+  std::sort(ranges.begin(), ranges.end(), [](const SampledRange& a, const SampledRange& b) {
+    return a.start_ns < b.start_ns;
+  });
+  return ranges;
+}
+
+}}} // namespace torch::autograd::profiler
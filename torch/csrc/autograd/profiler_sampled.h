@@ -0,0 +1,81 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <ATen/record_function.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace torch { namespace autograd { namespace profiler {
+
+// A low overhead profiler meant to be left on in production, complementing
+// the one enabled with enableProfiler.
+//
+// The hot path (a sampled RecordFunction start or end callback) does not take
+// any lock or allocate: it writes a fixed size SampledEvent into a ring
+// buffer owned by the current thread. Names are interned into integer ids,
+// which is a pointer lookup in a thread local cache after the first time a
+// name is seen on a thread. A background thread drains the ring buffers every
+// `flush_interval`, and hands the events to `sink` (or keeps them for
+// disableSampledProfiler). When a ring buffer is full, the events are dropped
+// and counted rather than blocking the thread that records them.
+//
+// The profiler observes all threads (it uses a global RecordFunction
+// callback), so as with addGlobalCallback, enabling and disabling it is not
+// thread safe and should happen while no other code is running.
+
+enum class SampledEventKind : uint8_t {
+  PushRange,
+  PopRange,
+};
+
+struct SampledEvent {
+  int64_t time_ns;
+  at::RecordFunctionHandle handle;
+  uint64_t thread_id;
+  uint32_t name_id;
+  SampledEventKind kind;
+};
+
+struct TORCH_API SampledProfilerConfig {
+  // Probability of recording any given RecordFunction range
+  double sampling_prob = 1.0;
+  // Number of events each thread can buffer between two flushes, rounded up
+  // to a power of 2
+  size_t buffer_capacity = 1 << 14;
+  std::chrono::milliseconds flush_interval{100};
+  // Receives the events of each flush, on the background thread. By default
+  // they are kept in memory and returned by disableSampledProfiler.
+  std::function<void(std::vector<SampledEvent>&&)> sink;
+};
+
+// A pair of matching push and pop events.
+struct SampledRange {
+  uint32_t name_id;
+  uint64_t thread_id;
+  int64_t start_ns;
+  int64_t end_ns;
+};
+
+TORCH_API void enableSampledProfiler(SampledProfilerConfig config);
+// Flushes the remaining events, and returns the events that were not given to
+// a sink.
+TORCH_API std::vector<SampledEvent> disableSampledProfiler();
+TORCH_API bool sampledProfilerEnabled();
+// Number of events dropped because a ring buffer was full, since the profiler
+// was last enabled.
+TORCH_API uint64_t sampledProfilerDroppedEvents();
+
+// Returns the name interned as `name_id`.
+TORCH_API std::string sampledEventName(uint32_t name_id);
+// Matches push and pop events, ignoring the ones whose other half was
+// dropped. Ranges are sorted by start time.
+TORCH_API std::vector<SampledRange> sampledRanges(
+    const std::vector<SampledEvent>& events);
+
+}}} // namespace torch::autograd::profiler
@@ -11,6 +11,7 @@ namespace torch { namespace autograd {
 
 using Variable = at::Tensor;
 struct Node;
+struct PackedTensor;
 
 TORCH_API extern const char* ERR_BACKWARD_TWICE;
 
@@ -28,8 +29,13 @@ class TORCH_API SavedVariable {
   /// circular reference.
   Variable unpack(std::shared_ptr<Node> saved_for = nullptr) const;
 
+  /// Hints that the variable is about to be unpacked. Only does something when
+  /// it was packed by `SavedTensorHooks`.
+  void prefetch() const;
+
   void reset_data() {
-    return data_.reset();
+    data_.reset();
+    packed_.reset();
   }
 
   void reset_grad_function() {
@@ -38,6 +44,9 @@ class TORCH_API SavedVariable {
 
  private:
   at::Tensor data_;
+  // Set instead of data_ when the tensor was packed by the `SavedTensorHooks`
+  // installed when saving it.
+  std::shared_ptr<PackedTensor> packed_;
 
   // The gradient function associated with this node. If has_grad_fn
   // is false, then this is a leaf node. Note that the grad_fn is not saved if
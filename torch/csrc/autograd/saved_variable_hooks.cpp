@@ -0,0 +1,202 @@
+#include <torch/csrc/autograd/saved_variable_hooks.h>
+
+#include <c10/util/Exception.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace torch { namespace autograd {
+
+namespace {
+
+thread_local std::shared_ptr<SavedTensorHooks> current_hooks;
+std::atomic<bool> hooks_were_used{false};
+
+struct CastedTensor : PackedTensor {
+  CastedTensor(at::Tensor data, at::ScalarType dtype)
+      : data_(std::move(data)), dtype_(dtype) {}
+
+  at::Tensor unpack() override {
+    return data_.to(dtype_);
+  }
+
+ private:
+  at::Tensor data_;
+  at::ScalarType dtype_;
+};
+
+struct QuantizedTensor : PackedTensor {
+  QuantizedTensor(at::Tensor data, at::ScalarType dtype)
+      : data_(std::move(data)), dtype_(dtype) {}
+
+  at::Tensor unpack() override {
+    return data_.dequantize().to(dtype_);
+  }
+
+ private:
+  at::Tensor data_;
+  at::ScalarType dtype_;
+};
+
+#ifndef _WIN32
+struct SpilledTensor : PackedTensor {
+  SpilledTensor(
+      int fd,
+      void* data,
+      size_t nbytes,
+      std::vector<int64_t> sizes,
+      at::TensorOptions options)
+      : fd_(fd),
+        data_(data),
+        nbytes_(nbytes),
+        sizes_(std::move(sizes)),
+        options_(options) {}
+
+  ~SpilledTensor() override {
+    munmap(data_, nbytes_);
+    close(fd_);
+  }
+
+  at::Tensor unpack() override {
+    auto result = at::empty(sizes_, options_);
+    std::memcpy(result.data_ptr(), data_, nbytes_);
+    return result;
+  }
+
+  void prefetch() override {
+    madvise(data_, nbytes_, MADV_WILLNEED);
+  }
+
+ private:
+  int fd_;
+  void* data_;
+  size_t nbytes_;
+  std::vector<int64_t> sizes_;
+  at::TensorOptions options_;
+};
+#endif
+
+} // namespace
+
+std::shared_ptr<SavedTensorHooks> get_saved_tensor_hooks() {
+  return current_hooks;
+}
+
+void set_saved_tensor_hooks(std::shared_ptr<SavedTensorHooks> hooks) {
+  if (hooks) {
+    // Never reset, so that the engine never misses a packed tensor.
+    hooks_were_used.store(true, std::memory_order_relaxed);
+  }
+  current_hooks = std::move(hooks);
+}
+
+bool saved_tensor_hooks_were_used() {
+  return hooks_were_used.load(std::memory_order_relaxed);
+}
+
+CompressSavedTensors::CompressSavedTensors(at::ScalarType dtype, int64_t min_numel)
+    : dtype_(dtype), min_numel_(min_numel) {
+  TORCH_CHECK(
+      dtype == at::kBFloat16 || dtype == at::kQUInt8,
+      "compressing saved tensors only supports bfloat16 and quint8, but got ",
+      dtype);
+}
+
+std::shared_ptr<PackedTensor> CompressSavedTensors::pack(const at::Tensor& tensor) {
+  if (!tensor.is_floating_point() || tensor.numel() < min_numel_ ||
+      tensor.numel() == 0 || tensor.scalar_type() == at::kBFloat16 ||
+      tensor.scalar_type() == at::kHalf || tensor.is_sparse()) {
+    return nullptr;
+  }
+  if (dtype_ == at::kBFloat16) {
+    return std::make_shared<CastedTensor>(
+        tensor.to(at::kBFloat16), tensor.scalar_type());
+  }
+
+  if (!tensor.device().is_cpu()) {
+    return nullptr;
+  }
+  // The range always includes 0 so that zeros (e.g. after a relu) are exact.
+  auto data = tensor.to(at::kFloat);
+  double lo = std::min(data.min().item<double>(), 0.);
+  double hi = std::max(data.max().item<double>(), 0.);
+  if (!std::isfinite(lo) || !std::isfinite(hi)) {
+    return nullptr;
+  }
+  double scale = hi > lo ? (hi - lo) / 255. : 1.;
+  int64_t zero_point = static_cast<int64_t>(std::nearbyint(-lo / scale));
+  return std::make_shared<QuantizedTensor>(
+      at::quantize_per_tensor(data, scale, zero_point, at::kQUInt8),
+      tensor.scalar_type());
+}
+
+SpillSavedTensors::SpillSavedTensors(std::string directory, int64_t min_numel)
+    : directory_(std::move(directory)), min_numel_(min_numel) {
+#ifdef _WIN32
+  TORCH_CHECK(false, "spilling saved tensors is not supported on Windows");
+#endif
+}
+
+std::shared_ptr<PackedTensor> SpillSavedTensors::pack(const at::Tensor& tensor) {
+#ifdef _WIN32
+  return nullptr;
+#else
+  if (!tensor.device().is_cpu() || tensor.layout() != at::kStrided ||
+      tensor.is_quantized() || !tensor.is_contiguous() ||
+      tensor.numel() == 0 || tensor.numel() < min_numel_) {
+    return nullptr;
+  }
+  size_t nbytes = tensor.numel() * tensor.element_size();
+
+  std::string path = directory_ + "/torch_saved_tensor_XXXXXX";
+  int fd = mkstemp(&path[0]);
+  TORCH_CHECK(fd >= 0, "failed to create a file in ", directory_,
+              " to spill a saved tensor: ", std::strerror(errno));
+  // Nobody else needs to open it, and the space is reclaimed once closed.
+  unlink(path.c_str());
+
+  auto data = static_cast<const char*>(tensor.data_ptr());
+  size_t written = 0;
+  while (written < nbytes) {
+    ssize_t n = pwrite(fd, data + written, nbytes - written, written);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      int err = errno;
+      close(fd);
+      TORCH_CHECK(false, "failed to spill a saved tensor to ", directory_,
+                  ": ", std::strerror(err));
+    }
+    written += n;
+  }
+  // Don't keep the data we just wrote in the page cache, which would defeat
+  // the purpose. It's read back on demand, or when prefetched.
+#ifdef __linux__
+  fdatasync(fd);
+  posix_fadvise(fd, 0, nbytes, POSIX_FADV_DONTNEED);
+#endif
+
+  void* mapping = mmap(nullptr, nbytes, PROT_READ, MAP_SHARED, fd, 0);
+  if (mapping == MAP_FAILED) {
+    int err = errno;
+    close(fd);
+    TORCH_CHECK(false, "failed to map a spilled saved tensor: ",
+                std::strerror(err));
+  }
+  return std::make_shared<SpilledTensor>(
+      fd, mapping, nbytes, tensor.sizes().vec(), tensor.options());
+#endif
+}
+
+}} // namespace torch::autograd
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <ATen/ATen.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace torch { namespace autograd {
+
+/// A tensor saved for backward in a form other than the tensor itself, e.g.
+/// compressed or written to disk. Created by `SavedTensorHooks::pack`.
+struct TORCH_API PackedTensor {
+  virtual ~PackedTensor() = default;
+
+  /// Reconstructs the saved tensor. Called every time the saved variable is
+  /// unpacked, which can be more than once if the graph is retained.
+  virtual at::Tensor unpack() = 0;
+
+  /// Hint that `unpack()` is going to be called soon. The engine calls it
+  /// when the node that saved the tensor receives its first gradient, ahead
+  /// of executing it.
+  virtual void prefetch() {}
+};
+
+/// Decides how `SavedVariable` stores the tensors saved for backward, which
+/// by default keeps them alive until backward. While installed on a thread
+/// (see `SavedTensorHooksGuard`), every non-leaf tensor saved on it is given
+/// to `pack()`, and the returned `PackedTensor` is kept instead of the tensor.
+/// Leaves (parameters, inputs) are kept as is, since they are alive anyway.
+struct TORCH_API SavedTensorHooks {
+  virtual ~SavedTensorHooks() = default;
+
+  /// Returns nullptr to save `tensor` as usual.
+  virtual std::shared_ptr<PackedTensor> pack(const at::Tensor& tensor) = 0;
+};
+
+TORCH_API std::shared_ptr<SavedTensorHooks> get_saved_tensor_hooks();
+TORCH_API void set_saved_tensor_hooks(std::shared_ptr<SavedTensorHooks> hooks);
+
+/// Whether hooks were ever installed in this process. Lets the engine skip
+/// prefetching altogether when they are not used.
+TORCH_API bool saved_tensor_hooks_were_used();
+
+/// Installs `hooks` for the tensors saved on the current thread for the
+/// lifetime of the guard, and restores the previous ones afterwards.
+struct TORCH_API SavedTensorHooksGuard {
+  explicit SavedTensorHooksGuard(std::shared_ptr<SavedTensorHooks> hooks)
+      : prev_hooks_(get_saved_tensor_hooks()) {
+    set_saved_tensor_hooks(std::move(hooks));
+  }
+  ~SavedTensorHooksGuard() {
+    set_saved_tensor_hooks(std::move(prev_hooks_));
+  }
+
+ private:
+  std::shared_ptr<SavedTensorHooks> prev_hooks_;
+};
+
+/// Saves floating point tensors with at least `min_numel` elements in a
+/// smaller dtype, and converts them back when unpacked. `dtype` is either
+/// `kBFloat16`, or `kQUInt8` for 8 bit affine quantization with a per-tensor
+/// scale (CPU only). This trades gradient accuracy for activation memory.
+struct TORCH_API CompressSavedTensors : SavedTensorHooks {
+  explicit CompressSavedTensors(at::ScalarType dtype, int64_t min_numel = 0);
+  std::shared_ptr<PackedTensor> pack(const at::Tensor& tensor) override;
+
+ private:
+  at::ScalarType dtype_;
+  int64_t min_numel_;
+};
+
+/// Writes contiguous CPU tensors of at least `min_numel` elements to an
+/// unlinked file in `directory` (ideally on a local NVMe drive) and frees
+/// them. They are read back through a memory mapping of the file, and
+/// prefetched with madvise(MADV_WILLNEED). Not supported on Windows.
+struct TORCH_API SpillSavedTensors : SavedTensorHooks {
+  explicit SpillSavedTensors(std::string directory, int64_t min_numel = 0);
+  std::shared_ptr<PackedTensor> pack(const at::Tensor& tensor) override;
+
+ private:
+  std::string directory_;
+  int64_t min_numel_;
+};
+
+}} // namespace torch::autograd
@@ -4,9 +4,12 @@
 #include <torch/csrc/jit/codegen/fuser/compiler.h>
 #include <torch/csrc/jit/codegen/fuser/cpu/temp_file.h>
 #include <torch/csrc/jit/frontend/code_template.h>
+#include <torch/csrc/jit/runtime/kernel_disk_cache.h>
 #include <torch/csrc/utils/memory.h>
 
+#include <array>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -35,12 +38,14 @@ static const std::string cpp_template = temp_dir + "pytorch_fuserXXXXXX.cpp";
 static const std::string check_exists_string =
     "where \"${program}\" > nul 2> nul";
 static std::vector<std::string> env_list;
+static const std::string so_extension = "dll";
 constexpr int so_suffix_len = 4;
 constexpr int cpp_suffix_len = 4;
 #else
 static const std::string so_template = "/tmp/pytorch_fuserXXXXXX.so";
 static const std::string cpp_template = "/tmp/pytorch_fuserXXXXXX.cpp";
 static const std::string check_exists_string = "which '${program}' > /dev/null";
+static const std::string so_extension = "so";
 constexpr int so_suffix_len = 3;
 constexpr int cpp_suffix_len = 4;
 #endif
@@ -193,6 +198,8 @@ struct CompilerConfig {
   const std::string openmp_flags = "-fopenmp";
 #endif
   bool openmp = true;
+  // The output of `cxx --version`, computed on first use.
+  c10::optional<std::string> version;
 };
 
 static CompilerConfig& getConfig() {
@@ -283,6 +290,45 @@ static void disas(const std::string& so_file) {
   AT_ASSERT(r == 0);
 }
 
+#ifndef _MSC_VER
+static std::string compilerVersion(const std::string& cxx) {
+  std::string cmd = "\"" + cxx + "\" --version 2>&1";
+  std::unique_ptr<FILE, decltype(&pclose)> pipe(
+      popen(cmd.c_str(), "r"), pclose);
+  std::string version;
+  if (!pipe) {
+    return version;
+  }
+  std::array<char, 128> buffer;
+  while (fgets(buffer.data(), static_cast<int>(buffer.size()), pipe.get()) !=
+         nullptr) {
+    version += buffer.data();
+  }
+  return version;
+}
+#endif
+
+// What the shared library compiled from `code` depends on, for the kernel
+// cache.
+static std::string kernelCacheKey(const std::string& code) {
+  auto& config = getConfig();
+  if (!config.version) {
+#ifdef _MSC_VER
+    config.version = config.cxx;
+#else
+    config.version = compilerVersion(config.cxx);
+#endif
+  }
+  std::ostringstream key;
+  key << "fuser-cpu\n"
+      << config.cxx << "\n"
+      << *config.version << "\n"
+      << compile_string << "\n"
+      << (config.openmp ? config.openmp_flags : "") << "\n"
+      << code;
+  return key.str();
+}
+
 FusedKernelCPU::FusedKernelCPU(
     std::string name,
     std::string code,
@@ -299,6 +345,20 @@ FusedKernelCPU::FusedKernelCPU(
           std::move(chunk_desc),
           std::move(concat_desc),
           has_random) {
+  auto& cache = KernelDiskCache::get();
+  std::string cache_key;
+  if (cache.enabled()) {
+    cache_key = kernelCacheKey(code_);
+    if (auto cached = cache.lookup(cache_key, so_extension)) {
+      try {
+        loadKernel(*cached);
+        return;
+      } catch (const c10::Error&) {
+        // e.g. evicted by another process since the lookup
+      }
+    }
+  }
+
   TempFile so_file(so_template, so_suffix_len);
   TempFile cpp_file(cpp_template, cpp_suffix_len);
   cpp_file.write(code_);
@@ -310,7 +370,18 @@ FusedKernelCPU::FusedKernelCPU(
   runCompiler(cpp_file.name(), so_file.name());
   if (debugFuser() >= 2)
     disas(so_file.name());
-  so_lib = make_unique<at::DynamicLibrary>(so_file.name().c_str());
+  loadKernel(so_file.name());
+
+  if (!cache_key.empty()) {
+    std::ifstream so(so_file.name(), std::ios::binary);
+    std::ostringstream content;
+    content << so.rdbuf();
+    cache.store(cache_key, so_extension, content.str());
+  }
+}
+
+void FusedKernelCPU::loadKernel(const std::string& so_path) {
+  so_lib = make_unique<at::DynamicLibrary>(so_path.c_str());
 #pragma GCC diagnostic ignored "-Wpedantic"
   kernel =
       reinterpret_cast<void (*)(uint32_t, void**)>(so_lib->sym(name_.c_str()));
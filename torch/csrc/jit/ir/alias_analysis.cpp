@@ -491,6 +491,7 @@ void AliasDb::analyzeImpl(Node* node) {
     case prim::FusedConcat:
     case prim::MMTreeReduce:
     case prim::MMBatchSide:
+    case prim::MMBatchIndependent:
     case prim::BroadcastSizes:
     case prim::ChunkSizes:
     case prim::Function:
@@ -80,6 +80,14 @@ c10::AliasAnalysisKind aliasAnalysisIsSpecialCase() {
 // Tunable parameter. Set to something larger if it turns out to be better.
 static constexpr size_t min_fusion_size = 4;
 
+// Note [Independent MMs]
+// Independent mms that don't share an operand (e.g. the per-head products of
+// a multi-head attention, or the heads of a multi-task model) are batched
+// into a single bmm when all their operands have the same shape. Shapes are
+// only known at runtime, so prim::MMBatchIndependent checks them and falls
+// back to separate mms when they differ.
+static constexpr size_t min_independent_batch_size = 4;
+
 bool have_same_shape(at::TensorList inputs) {
   auto expected_sizes = inputs[0].sizes();
   return (std::all_of(
@@ -88,6 +96,13 @@ bool have_same_shape(at::TensorList inputs) {
       }));
 }
 
+bool have_same_dtype_and_device(at::TensorList inputs) {
+  return std::all_of(inputs.begin(), inputs.end(), [&](const at::Tensor& t) {
+    return t.scalar_type() == inputs[0].scalar_type() &&
+        t.device() == inputs[0].device();
+  });
+}
+
 bool should_be_transposed(at::TensorList inputs) {
   return (std::all_of(inputs.begin(), inputs.end(), [](const at::Tensor& t) {
     return t.stride(0) == 1 && t.stride(1) == t.size(0);
@@ -364,31 +379,44 @@ RegisterOperators mm_batch_side_reg({Operator(
     },
     aliasAnalysisIsSpecialCase())});
 
-std::pair<std::vector<Node*>, std::vector<Node*>> gatherIndependentMMUses(
-    Value* value,
+std::vector<Node*> filterDependentMMs(
+    std::vector<Node*> mms,
     AliasDb& alias_db) {
-  const auto postprocess = [&](std::vector<Node*> mms) {
-    if (mms.size() == 0) {
-      return mms;
-    }
-    std::sort(mms.begin(), mms.end(), [](Node* n, Node* m) {
-      return n->isBefore(m);
-    });
-    // Filter out dependent MMs. This algorithm might do very badly if e.g. you
-    // have a lot of independent MMs, that depend on the first one, but I doubt
-    // this will be a common scenario.
-    for (size_t i = 0; i < mms.size(); ++i) {
-      if (mms[i] == nullptr)
+  if (mms.size() == 0) {
+    return mms;
+  }
+  std::sort(
+      mms.begin(), mms.end(), [](Node* n, Node* m) { return n->isBefore(m); });
+  // Filter out dependent MMs. This algorithm might do very badly if e.g. you
+  // have a lot of independent MMs, that depend on the first one, but I doubt
+  // this will be a common scenario.
+  for (size_t i = 0; i < mms.size(); ++i) {
+    if (mms[i] == nullptr)
+      continue;
+    for (size_t j = i + 1; j < mms.size(); ++j) {
+      if (mms[j] == nullptr)
         continue;
-      for (size_t j = i + 1; j < mms.size(); ++j) {
-        if (mms[j] == nullptr)
-          continue;
-        if (!alias_db.couldMoveBeforeTopologically(mms[j], mms[i])) {
-          mms[j] = nullptr;
-        }
+      if (!alias_db.couldMoveBeforeTopologically(mms[j], mms[i])) {
+        mms[j] = nullptr;
       }
     }
-    return c10::filter(mms, [](Node* n) { return n != nullptr; });
+  }
+  return c10::filter(mms, [](Node* n) { return n != nullptr; });
+}
+
+// Moves the (independent) `mms` right before the last of them.
+void moveTogether(std::vector<Node*>& mms, AliasDb& alias_db) {
+  for (int64_t i = static_cast<int64_t>(mms.size()) - 2; i >= 0; --i) {
+    bool move_ok = alias_db.moveBeforeTopologicallyValid(mms[i], mms[i + 1]);
+    AT_ASSERT(move_ok);
+  }
+}
+
+std::pair<std::vector<Node*>, std::vector<Node*>> gatherIndependentMMUses(
+    Value* value,
+    AliasDb& alias_db) {
+  const auto postprocess = [&](std::vector<Node*> mms) {
+    return filterDependentMMs(std::move(mms), alias_db);
   };
 
   Block* block = value->node()->owningBlock();
@@ -412,10 +440,7 @@ void BatchMMSide(Block* block, AliasDb& alias_db) {
   static constexpr size_t how_many_is_many = 8;
   const auto batch_side = [&](std::vector<Node*>& mms, Side side) {
     AT_ASSERT(!mms.empty());
-    for (int64_t i = static_cast<int64_t>(mms.size()) - 2; i >= 0; --i) {
-      bool move_ok = alias_db.moveBeforeTopologicallyValid(mms[i], mms[i + 1]);
-      AT_ASSERT(move_ok);
-    }
+    moveTogether(mms, alias_db);
     WithInsertPoint insert_guard{mms[0]};
     Graph* graph = mms[0]->owningGraph();
     Node* batch_mm = graph->create(
@@ -455,6 +480,87 @@ void BatchMMSide(Block* block, AliasDb& alias_db) {
   }
 }
 
+bool shape_is_fast_for_bmm(const at::Tensor& lhs, const at::Tensor& rhs) {
+  // Stacking copies the operands, which only pays off when the mms are small
+  // enough for their overhead to dominate.
+  return lhs.numel() <= 256 * 256 && rhs.numel() <= 256 * 256;
+}
+
+RegisterOperators mm_batch_independent_reg({Operator(
+    prim::MMBatchIndependent,
+    [](const Node* node) -> Operation {
+      size_t num_mms = node->inputs().size() / 2;
+      return [num_mms](Stack& stack) {
+        std::vector<at::Tensor> inputs;
+        inputs.reserve(2 * num_mms);
+        for (auto it = stack.end() - 2 * num_mms; it != stack.end(); ++it) {
+          inputs.push_back(std::move(*it).toTensor());
+        }
+        drop(stack, 2 * num_mms);
+
+        auto lhs_inputs = at::TensorList(inputs).slice(0, num_mms);
+        auto rhs_inputs = at::TensorList(inputs).slice(num_mms);
+        if (lhs_inputs[0].dim() == 2 && rhs_inputs[0].dim() == 2 &&
+            have_same_shape(lhs_inputs) && have_same_shape(rhs_inputs) &&
+            have_same_dtype_and_device(inputs) &&
+            shape_is_fast_for_bmm(lhs_inputs[0], rhs_inputs[0])) {
+          auto outputs =
+              at::bmm(at::stack(lhs_inputs), at::stack(rhs_inputs)).unbind(0);
+          stack.insert(
+              stack.end(),
+              std::make_move_iterator(outputs.begin()),
+              std::make_move_iterator(outputs.end()));
+        } else {
+          for (size_t i = 0; i < num_mms; ++i) {
+            stack.emplace_back(lhs_inputs[i].mm(rhs_inputs[i]));
+          }
+        }
+        return 0;
+      };
+    },
+    aliasAnalysisIsSpecialCase())});
+
+bool isMatrix(Value* value) {
+  auto type = value->type()->cast<TensorType>();
+  return type && type->dim() && *type->dim() == 2;
+}
+
+// See Note [Independent MMs]
+void BatchMMIndependent(Block* block, AliasDb& alias_db) {
+  std::vector<Node*> mms;
+  for (Node* node : block->nodes()) {
+    if (node->matches("aten::mm(Tensor self, Tensor mat2) -> Tensor") ||
+        (node->matches("aten::matmul(Tensor self, Tensor other) -> Tensor") &&
+         isMatrix(node->inputs()[0]) && isMatrix(node->inputs()[1]))) {
+      mms.push_back(node);
+    }
+  }
+  mms = filterDependentMMs(std::move(mms), alias_db);
+  if (mms.size() >= min_independent_batch_size) {
+    moveTogether(mms, alias_db);
+    WithInsertPoint insert_guard{mms[0]};
+    Graph* graph = mms[0]->owningGraph();
+    Node* batch_mm = graph->insertNode(graph->create(
+        prim::MMBatchIndependent, /*inputs=*/{}, /*num_outputs=*/mms.size()));
+    for (Node* mm : mms) {
+      batch_mm->addInput(mm->inputs().at(0));
+    }
+    for (size_t i = 0; i < mms.size(); ++i) {
+      batch_mm->addInput(mms[i]->inputs().at(1));
+      batch_mm->outputs().at(i)->copyMetadata(mms[i]->output());
+      mms[i]->output()->replaceAllUsesWith(batch_mm->outputs().at(i));
+    }
+  }
+
+  // Nested blocks come last, so that the moves above only go through nodes
+  // that alias_db knows about.
+  for (Node* node : block->nodes()) {
+    for (Block* subblock : node->blocks()) {
+      BatchMMIndependent(subblock, alias_db);
+    }
+  }
+}
+
 bool hasMutableOperators(Block* block) {
   for (auto n : block->nodes()) {
     if (n->kind().is_aten() && n->schema().is_mutable())
@@ -476,6 +582,12 @@ void BatchMM(std::shared_ptr<Graph>& graph) {
   BatchMMTreeReduce(graph->block());
   BatchMMSide(graph->block(), alias_db);
   EliminateDeadCode(graph);
+  {
+    // The batches created above are unknown to alias_db.
+    AliasDb batched_alias_db(graph);
+    BatchMMIndependent(graph->block(), batched_alias_db);
+    EliminateDeadCode(graph);
+  }
   // It's possible that transpose rearrangements have created sequences of
   // consecutive transposes that didn't exist before.
   PeepholeOptimize(graph);
@@ -0,0 +1,194 @@
+#include <torch/csrc/jit/passes/cat_elimination.h>
+
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/utils/out_variant.h>
+
+namespace torch {
+namespace jit {
+
+// This pass rewrites
+//
+//   %a = aten::mul(%x, %y)
+//   %b = aten::sigmoid(%z)
+//   %l = prim::ListConstruct(%a, %b)
+//   %c = aten::cat(%l, %dim)
+//
+// into
+//
+//   %c = aten::empty(<sizes of %c>, <dtype>, <layout>, <device>, ...)
+//   %ca = aten::narrow(%c, %dim, 0, <size of %a along %dim>)
+//   %a = aten::mul(%x, %y, %ca)              // mul.out
+//   %cb = aten::narrow(%c, %dim, <offset>, <size of %b along %dim>)
+//   %b = aten::sigmoid(%z, %cb)              // sigmoid.out
+//
+// so that every input is written once, in place, rather than being
+// materialized and copied again by cat. Inputs whose producer cannot be
+// rewritten (no out= overload, multiple uses, graph inputs, views, ...) are
+// copied into their slice right where the cat used to be, which costs the same
+// as the cat itself.
+
+namespace {
+
+c10::optional<std::vector<int64_t>> concreteSizes(Value* v) {
+  auto type = v->type()->cast<TensorType>();
+  if (!type || !type->isComplete()) {
+    return c10::nullopt;
+  }
+  return type->sizes().concrete_sizes();
+}
+
+std::vector<int64_t> contiguousStrides(const std::vector<int64_t>& sizes) {
+  std::vector<int64_t> strides(sizes.size());
+  int64_t stride = 1;
+  for (size_t i = sizes.size(); i > 0; --i) {
+    strides[i - 1] = stride;
+    stride *= sizes[i - 1];
+  }
+  return strides;
+}
+
+bool isContiguous(const TensorTypePtr& type) {
+  auto sizes = type->sizes().concrete_sizes();
+  auto strides = type->strides().concrete_sizes();
+  if (!sizes || !strides) {
+    return false;
+  }
+  return *strides == contiguousStrides(*sizes);
+}
+
+bool eliminateCatCopies(Node* cat) {
+  Graph* graph = cat->owningGraph();
+  Node* list = cat->inputs().at(0)->node();
+  if (list->kind() != prim::ListConstruct ||
+      list->output()->uses().size() != 1 ||
+      list->owningBlock() != cat->owningBlock()) {
+    return false;
+  }
+  auto maybe_dim = constant_as<int64_t>(cat->inputs().at(1));
+  auto cat_type = cat->output()->type()->cast<TensorType>();
+  if (!maybe_dim || !cat_type || !cat_type->isComplete() ||
+      cat_type->requiresGrad() != false || !isContiguous(cat_type)) {
+    return false;
+  }
+  auto cat_sizes = *cat_type->sizes().concrete_sizes();
+  int64_t dim = *maybe_dim;
+  if (dim < 0) {
+    dim += static_cast<int64_t>(cat_sizes.size());
+  }
+  if (dim < 0 || dim >= static_cast<int64_t>(cat_sizes.size())) {
+    return false;
+  }
+
+  // Compute the slice of the output every input lands in, and find the
+  // inputs whose producers can write there directly.
+  std::vector<int64_t> offsets;
+  std::vector<int64_t> lengths;
+  std::vector<bool> writes_in_place;
+  Node* first_producer = nullptr;
+  int64_t offset = 0;
+  for (Value* input : list->inputs()) {
+    auto type = input->type()->cast<TensorType>();
+    auto sizes = concreteSizes(input);
+    if (!type || !sizes || sizes->size() != cat_sizes.size() ||
+        type->scalarType() != cat_type->scalarType() ||
+        type->device() != cat_type->device() ||
+        type->requiresGrad() != false) {
+      return false;
+    }
+    offsets.push_back(offset);
+    lengths.push_back((*sizes)[dim]);
+    offset += (*sizes)[dim];
+
+    Node* producer = input->node();
+    bool eligible = input->uses().size() == 1 &&
+        producer->owningBlock() == cat->owningBlock() &&
+        producer->kind().is_aten() && producer->outputs().size() == 1;
+    writes_in_place.push_back(eligible);
+    if (eligible && (!first_producer || producer->isBefore(first_producer))) {
+      first_producer = producer;
+    }
+  }
+  if (offset != cat_sizes[dim] || !first_producer) {
+    return false;
+  }
+
+  GRAPH_DEBUG("Eliminating copies of ", getHeader(cat));
+
+  Value* buffer = nullptr;
+  {
+    WithInsertPoint guard(first_producer);
+    buffer = graph->insert(
+        aten::empty,
+        {cat_sizes},
+        {NamedValue("dtype", *cat_type->scalarType()),
+         NamedValue("device", *cat_type->device())});
+    buffer->setType(cat_type);
+  }
+
+  // The slices are views of the buffer, so they have its strides, which
+  // aren't contiguous for their own sizes unless dim is the outermost one.
+  auto buffer_strides = contiguousStrides(cat_sizes);
+  auto insertSlice = [&](size_t i) {
+    Value* slice =
+        graph->insert(aten::narrow, {buffer, dim, offsets[i], lengths[i]});
+    auto sizes = cat_sizes;
+    sizes[dim] = lengths[i];
+    slice->setType(cat_type->withSizesStrides(sizes, buffer_strides));
+    return slice;
+  };
+
+  size_t num_in_place = 0;
+  for (size_t i = 0; i < list->inputs().size(); ++i) {
+    Value* input = list->inputs()[i];
+    if (writes_in_place[i]) {
+      Node* producer = input->node();
+      WithInsertPoint guard(producer);
+      Value* slice = insertSlice(i);
+      if (tryCreateOutVariant(producer, slice)) {
+        ++num_in_place;
+        continue;
+      }
+      slice->node()->destroy();
+    }
+    WithInsertPoint guard(cat);
+    graph->insert(aten::copy_, {insertSlice(i), input});
+  }
+
+  // The functional producers are only used by the list now, and are cleaned
+  // up by DCE once it's gone.
+  cat->output()->replaceAllUsesWith(buffer);
+  cat->destroy();
+  list->destroy();
+  GRAPH_DEBUG(
+      num_in_place, " of ", offsets.size(), " cat inputs written in place");
+  return true;
+}
+
+bool eliminateCatCopies(Block* block) {
+  bool changed = false;
+  for (auto it = block->nodes().begin(); it != block->nodes().end();) {
+    Node* node = *it;
+    ++it; // eliminateCatCopies destroys the node
+    for (Block* sub_block : node->blocks()) {
+      changed |= eliminateCatCopies(sub_block);
+    }
+    if (node->matches("aten::cat(Tensor[] tensors, int dim=0) -> Tensor")) {
+      changed |= eliminateCatCopies(node);
+    }
+  }
+  return changed;
+}
+
+} // namespace
+
+void EliminateCatCopies(std::shared_ptr<Graph>& graph) {
+  if (eliminateCatCopies(graph->block())) {
+    EliminateDeadCode(graph);
+  }
+  GRAPH_DUMP("After EliminateCatCopies: ", graph);
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Removes the copies done by `aten::cat` by preallocating its output and
+// making the producers of its inputs write directly into slices of it through
+// their out= variants. Requires complete tensor types on the cat inputs and
+// output (e.g. after shape propagation or profiling), and is a no-op for
+// anything that needs gradients.
+TORCH_API void EliminateCatCopies(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
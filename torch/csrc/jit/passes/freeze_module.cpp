@@ -2,6 +2,8 @@
 #include <torch/csrc/jit/jit_log.h>
 
 #include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/passes/constant_pooling.h>
+#include <torch/csrc/jit/passes/fuse_linear.h>
 #include <torch/csrc/jit/passes/inliner.h>
 #include <torch/csrc/jit/runtime/graph_executor_impl.h>
 
@@ -67,7 +69,13 @@ class AttributePropagator {
       Inline(*subgraph);
     };
     auto applyOptimizations = [](std::shared_ptr<Graph>& subgraph) {
+      // The paths of F.linear are rewritten into aten::linear before the
+      // transposes of the (now constant) weights get folded, so that sibling
+      // linears can then be fused.
+      ConstantPooling(subgraph);
+      FuseLinear(subgraph);
       runOptimization(subgraph, /* unroll? */ false);
+      FuseSiblingLinears(subgraph);
     };
     for (auto function : preservedMethods_) {
       GRAPH_DEBUG("Analyzing function: " + function->name());
@@ -1,6 +1,15 @@
 #include <torch/csrc/jit/passes/fuse_linear.h>
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/ir/node_hashing.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
 #include <torch/csrc/jit/passes/subgraph_rewrite.h>
 
+#include <ATen/ATen.h>
+
+#include <algorithm>
+
 namespace torch {
 namespace jit {
 
@@ -48,5 +57,269 @@ void FuseLinear(std::shared_ptr<Graph>& graph) {
       matmul_pattern, fused_linear_bias_none);
   matmul_to_linear.runOnGraph(graph);
 }
+
+namespace {
+
+Node* onlyNode(Block* block) {
+  auto nodes = block->nodes();
+  if (nodes.begin() == nodes.end() || *nodes.begin() != nodes.back()) {
+    return nullptr;
+  }
+  return *nodes.begin();
+}
+
+c10::optional<size_t> outputIndex(Node* node, Value* value) {
+  auto outputs = node->outputs();
+  auto it = std::find(outputs.begin(), outputs.end(), value);
+  if (it == outputs.end()) {
+    return c10::nullopt;
+  }
+  return it - outputs.begin();
+}
+
+// Replaces the prim::Ifs whose blocks both compute the same node with that
+// node.
+void removeIfsOfEqualBlocks(Block* block) {
+  for (auto it = block->nodes().begin(); it != block->nodes().end();) {
+    Node* node = *it++;
+    for (Block* subblock : node->blocks()) {
+      removeIfsOfEqualBlocks(subblock);
+    }
+    if (node->kind() != prim::If) {
+      continue;
+    }
+    Block* then_block = node->blocks().at(0);
+    Block* else_block = node->blocks().at(1);
+    Node* then_node = onlyNode(then_block);
+    Node* else_node = onlyNode(else_block);
+    if (!then_node || !else_node || !then_node->blocks().empty() ||
+        !EqualNode()(then_node, else_node)) {
+      continue;
+    }
+    std::vector<Value*> results;
+    for (size_t i = 0; i < node->outputs().size(); ++i) {
+      Value* then_output = then_block->outputs()[i];
+      Value* else_output = else_block->outputs()[i];
+      auto then_index = outputIndex(then_node, then_output);
+      auto else_index = outputIndex(else_node, else_output);
+      if (then_index != else_index ||
+          (!then_index && then_output != else_output)) {
+        break;
+      }
+      results.push_back(then_output);
+    }
+    if (results.size() != node->outputs().size()) {
+      continue;
+    }
+    then_node->moveBefore(node);
+    for (size_t i = 0; i < results.size(); ++i) {
+      node->outputs()[i]->replaceAllUsesWith(results[i]);
+    }
+    node->destroy();
+  }
+}
+
+c10::optional<at::Tensor> constantTensor(Value* value) {
+  auto ivalue = toIValue(value);
+  if (!ivalue || !ivalue->isTensor()) {
+    return c10::nullopt;
+  }
+  return ivalue->toTensor();
+}
+
+struct SiblingLinear {
+  Node* node;
+  at::Tensor weight;
+  // Undefined when the linear has no bias.
+  at::Tensor bias;
+};
+
+// Whether every use of `value` computes the same thing whatever its strides,
+// so that it can be a non-contiguous view. Views of it (which may be passed
+// to aten::view, or returned and viewed by the caller), ops that look at its
+// strides or write to it, and anything that isn't an aten op are assumed not
+// to.
+bool usesAreLayoutAgnostic(Value* value) {
+  for (const Use& use : value->uses()) {
+    Node* user = use.user;
+    if (!user->kind().is_aten() || user->kind() == aten::view ||
+        user->kind() == aten::flatten || user->kind() == aten::is_contiguous ||
+        user->kind() == aten::stride) {
+      return false;
+    }
+    auto schema = user->maybeSchema();
+    if (!schema || schema->is_mutable()) {
+      return false;
+    }
+    for (const auto& ret : schema->returns()) {
+      if (ret.alias_info()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool canFuse(const SiblingLinear& a, const SiblingLinear& b) {
+  return a.weight.size(1) == b.weight.size(1) &&
+      a.weight.scalar_type() == b.weight.scalar_type() &&
+      a.weight.device() == b.weight.device();
+}
+
+class SiblingLinearsFuser {
+ public:
+  explicit SiblingLinearsFuser(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)) {}
+
+  void run() {
+    {
+      AliasDb alias_db(graph_);
+      collectGroups(graph_->block(), alias_db);
+    }
+    for (auto& group : groups_) {
+      fuse(group);
+    }
+    if (!groups_.empty()) {
+      GRAPH_DUMP("After FuseSiblingLinears: ", graph_);
+    }
+  }
+
+ private:
+  c10::optional<SiblingLinear> asSiblingLinear(Node* node, AliasDb& alias_db) {
+    if (!node->matches(
+            "aten::linear(Tensor input, Tensor weight, Tensor? bias=None) -> Tensor") ||
+        alias_db.hasWriters(node->output())) {
+      return c10::nullopt;
+    }
+    auto weight = constantTensor(node->inputs()[1]);
+    auto bias = toIValue(node->inputs()[2]);
+    if (!weight || weight->dim() != 2 || weight->requires_grad() || !bias ||
+        !(bias->isNone() || bias->isTensor())) {
+      return c10::nullopt;
+    }
+    SiblingLinear linear{node, *weight, at::Tensor()};
+    if (bias->isTensor()) {
+      linear.bias = bias->toTensor();
+      if (linear.bias.dim() != 1 ||
+          linear.bias.size(0) != linear.weight.size(0) ||
+          linear.bias.scalar_type() != linear.weight.scalar_type() ||
+          linear.bias.requires_grad()) {
+        return c10::nullopt;
+      }
+    }
+    return linear;
+  }
+
+  void collectGroups(Block* block, AliasDb& alias_db) {
+    std::unordered_set<Value*> considered_inputs;
+    for (Node* node : block->nodes()) {
+      for (Block* subblock : node->blocks()) {
+        collectGroups(subblock, alias_db);
+      }
+      if (node->kind() != aten::linear) {
+        continue;
+      }
+      Value* input = node->inputs()[0];
+      // The linears are fused where the first one is, so the input must not
+      // change between them.
+      if (!considered_inputs.insert(input).second ||
+          alias_db.hasWriters(input)) {
+        continue;
+      }
+      std::vector<std::vector<SiblingLinear>> groups;
+      for (const Use& use : input->uses()) {
+        if (use.offset != 0 || use.user->owningBlock() != block) {
+          continue;
+        }
+        auto linear = asSiblingLinear(use.user, alias_db);
+        if (!linear) {
+          continue;
+        }
+        auto group = std::find_if(
+            groups.begin(),
+            groups.end(),
+            [&](const std::vector<SiblingLinear>& group) {
+              return canFuse(group[0], *linear);
+            });
+        if (group == groups.end()) {
+          groups.push_back({*linear});
+        } else {
+          group->push_back(*linear);
+        }
+      }
+      for (auto& group : groups) {
+        if (group.size() > 1) {
+          groups_.push_back(std::move(group));
+        }
+      }
+    }
+  }
+
+  void fuse(std::vector<SiblingLinear>& group) {
+    std::sort(
+        group.begin(),
+        group.end(),
+        [](const SiblingLinear& a, const SiblingLinear& b) {
+          return a.node->isBefore(b.node);
+        });
+    std::vector<at::Tensor> weights;
+    std::vector<at::Tensor> biases;
+    bool has_bias = false;
+    for (const auto& linear : group) {
+      weights.push_back(linear.weight);
+      has_bias |= linear.bias.defined();
+    }
+    if (has_bias) {
+      for (const auto& linear : group) {
+        biases.push_back(
+            linear.bias.defined()
+                ? linear.bias
+                : at::zeros({linear.weight.size(0)}, linear.weight.options()));
+      }
+    }
+
+    Node* first = group[0].node;
+    WithInsertPoint insert_guard(first);
+    Value* weight = graph_->insertConstant(at::cat(weights, 0));
+    Value* bias = has_bias ? graph_->insertConstant(at::cat(biases, 0))
+                           : graph_->insertConstant(IValue());
+    Value* fused =
+        graph_->insert(aten::linear, {first->inputs()[0], weight, bias});
+    int64_t offset = 0;
+    for (const auto& linear : group) {
+      int64_t out_features = linear.weight.size(0);
+      Value* original = linear.node->output();
+      Value* output =
+          graph_->insert(aten::narrow, {fused, -1, offset, out_features});
+      output->copyMetadata(original);
+      // The slices of the last dim aren't contiguous: their stride(-2) is
+      // the total number of out features. They're only left as views when
+      // nothing can tell, and copied into contiguous tensors otherwise.
+      if (auto type = original->type()->cast<TensorType>()) {
+        output->setType(
+            type->dimensionedOnly()->withSymbolicShapes(type->symbolic_sizes()));
+      }
+      if (!usesAreLayoutAgnostic(original)) {
+        output = graph_->insert(aten::contiguous, {output});
+        output->copyMetadata(original);
+      }
+      original->replaceAllUsesWith(output);
+      linear.node->destroy();
+      offset += out_features;
+    }
+  }
+
+  std::shared_ptr<Graph> graph_;
+  std::vector<std::vector<SiblingLinear>> groups_;
+};
+
+} // namespace
+
+void FuseSiblingLinears(std::shared_ptr<Graph>& graph) {
+  removeIfsOfEqualBlocks(graph->block());
+  SiblingLinearsFuser(graph).run();
+  // Removes the conditions of the prim::Ifs, and the unfused weights.
+  EliminateDeadCode(graph);
+}
 } // namespace jit
 } // namespace torch
@@ -13,5 +13,17 @@ namespace jit {
  * This pass can be deleted once the JIT can emit the aten::linear in the future
  */
 TORCH_API void FuseLinear(std::shared_ptr<Graph>& graph);
+
+/** \brief Fuse the sibling aten::linear of a frozen graph into a single GEMM
+ * Linears that share their input and whose weights and biases are constants
+ * (e.g. the query, key and value projections of an attention layer, or the
+ * heads of a multi-task model) are replaced by one aten::linear on the
+ * concatenation of their weights, whose output is split back with
+ * aten::narrow views (made contiguous unless all their uses are known not to
+ * depend on their strides). The prim::If that F.linear leaves once FuseLinear
+ * has rewritten both of its paths into the same aten::linear are removed
+ * first.
+ */
+TORCH_API void FuseSiblingLinears(std::shared_ptr<Graph>& graph);
 } // namespace jit
 } // namespace torch
@@ -241,7 +241,7 @@ struct GuardElimination {
     size_t i = 0;
     for (auto input : n->inputs()) {
       if ((input->node()->kind() == prim::Guard &&
-           !input->type()->expect<TensorType>()->isSummarized()) ||
+           isGuardedType(input->type()->expect<TensorType>())) ||
           input->node()->kind() == prim::Constant ||
           (allow_numbers && input->type()->isSubtypeOf(NumberType::get())) ||
           except.count(i) != 0) {
@@ -263,6 +263,20 @@ struct GuardElimination {
   }
 
  private:
+  // Whether a guard checks all the properties of `type` that `isSummarized()`
+  // requires, or all of them but the sizes, which the guards made symbolic by
+  // `MakeGuardShapesSymbolic` don't check. The types of the outputs of the
+  // nodes they guard the inputs of are then just as symbolic.
+  static bool isGuardedType(const TensorTypePtr& type) {
+    if (!type->isSummarized()) {
+      return true;
+    }
+    return type->scalarType() && type->device() &&
+        type->symbolic_sizes().rank() &&
+        type->stride_properties().isComplete() && type->requiresGrad() &&
+        type->undefined();
+  }
+
   // `removableGuard` relies on the properties checked by `isSummarized()`
   // and passes shouldn't insert nodes between a guard and its uses that
   // may alter those properties.
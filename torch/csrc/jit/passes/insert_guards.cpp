@@ -59,5 +59,60 @@ void InsertGuards(std::shared_ptr<Graph> graph) {
   gi.run();
 }
 
+static TensorTypePtr makeShapeSymbolic(const TensorTypePtr& type) {
+  auto dims = type->symbolic_sizes().sizes();
+  if (!dims) {
+    return type;
+  }
+  std::vector<c10::ShapeSymbol> symbolic_dims;
+  for (const c10::ShapeSymbol& dim : *dims) {
+    // The dims of size 1 are kept, since they may be broadcast.
+    if (dim.is_static() && dim.static_size() != 1) {
+      symbolic_dims.push_back(c10::ShapeSymbol::newSymbol());
+    } else {
+      symbolic_dims.push_back(dim);
+    }
+  }
+  // Only keep the order and contiguity of the strides.
+  c10::VaryingShape<c10::Stride> strides;
+  if (auto stride_props = type->stride_properties().sizes()) {
+    std::vector<c10::optional<c10::Stride>> props;
+    for (const c10::optional<c10::Stride>& stride : *stride_props) {
+      if (stride) {
+        props.emplace_back(c10::Stride(
+            stride->stride_index_, stride->contiguous_, c10::nullopt));
+      } else {
+        props.emplace_back(c10::nullopt);
+      }
+    }
+    strides = c10::VaryingShape<c10::Stride>(props);
+  }
+  return TensorType::create(
+      type->scalarType(),
+      type->device(),
+      c10::SymbolicShape(symbolic_dims),
+      strides,
+      type->requiresGrad(),
+      type->undefined());
+}
+
+static void makeGuardShapesSymbolic(Block* b) {
+  for (Node* n : b->nodes()) {
+    if (n->kind() == prim::Guard) {
+      auto type = n->output()->type()->cast<TensorType>();
+      if (type) {
+        n->output()->setType(makeShapeSymbolic(type));
+      }
+    }
+    for (Block* ib : n->blocks()) {
+      makeGuardShapesSymbolic(ib);
+    }
+  }
+}
+
+void MakeGuardShapesSymbolic(std::shared_ptr<Graph> graph) {
+  makeGuardShapesSymbolic(graph->block());
+}
+
 } // namespace jit
 } // namespace torch
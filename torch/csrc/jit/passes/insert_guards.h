@@ -15,5 +15,14 @@ namespace jit {
 
 TORCH_API void InsertGuards(std::shared_ptr<Graph> graph);
 
+// Relaxes the types checked by the prim::Guard's of `graph` so that they
+// accept tensors of any sizes with the same rank, dtype, device and memory
+// layout as the profiled ones: the static dims (other than the broadcast ones
+// of size 1) are replaced by new symbols and exact strides are dropped, while
+// the stride order and contiguity are kept. This lets the tensorexpr fuser
+// compile kernels for symbolic shapes instead of bailing out on every new
+// size.
+TORCH_API void MakeGuardShapesSymbolic(std::shared_ptr<Graph> graph);
+
 } // namespace jit
 } // namespace torch
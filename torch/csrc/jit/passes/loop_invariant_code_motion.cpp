@@ -0,0 +1,243 @@
+#include <torch/csrc/jit/passes/loop_invariant_code_motion.h>
+
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/ir/ir_views.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/utils/memory.h>
+
+#include <memory>
+#include <unordered_set>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+bool isPureKind(Node* node) {
+  switch (node->kind()) {
+    case prim::Constant:
+    case prim::If:
+    case prim::ListConstruct:
+    case prim::ListUnpack:
+    case prim::TupleConstruct:
+    case prim::TupleUnpack:
+    case prim::TupleIndex:
+    case prim::NumToTensor:
+    case prim::Uninitialized:
+      return true;
+    default:
+      return node->kind().is_aten() && node->kind() != aten::wait;
+  }
+}
+
+// Whether `node`, or a node in its blocks, has side effects (e.g. the
+// prim::RaiseException of an assert).
+bool hasSideEffectsIn(Node* node) {
+  if (node->hasSideEffects()) {
+    return true;
+  }
+  for (Block* block : node->blocks()) {
+    for (Node* nested : block->nodes()) {
+      if (hasSideEffectsIn(nested)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// The node of `body` that `node` is in, directly or in a nested block, or
+// nullptr if it isn't in `body`.
+Node* topLevelNodeIn(Node* node, Block* body) {
+  while (node->owningBlock() != body) {
+    Node* owner = node->owningBlock()->owningNode();
+    if (!owner) {
+      return nullptr;
+    }
+    node = owner;
+  }
+  return node;
+}
+
+class LoopInvariantHoister {
+ public:
+  explicit LoopInvariantHoister(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)) {}
+
+  void run() {
+    // Inner loops come first, so that what they hoist can then be hoisted
+    // from the loops around them.
+    std::vector<Node*> loops;
+    collectLoops(graph_->block(), loops);
+    bool changed = false;
+    for (Node* loop : loops) {
+      changed |= hoist(loop);
+    }
+    if (changed) {
+      GRAPH_DUMP("After LoopInvariantCodeMotion: ", graph_);
+    }
+  }
+
+ private:
+  void collectLoops(Block* block, std::vector<Node*>& loops) {
+    for (Node* node : block->nodes()) {
+      for (Block* subblock : node->blocks()) {
+        collectLoops(subblock, loops);
+      }
+      if (node->kind() == prim::Loop) {
+        loops.push_back(node);
+      }
+    }
+  }
+
+  // The alias analysis is rebuilt lazily once nodes have been created.
+  AliasDb& aliasDb() {
+    if (!alias_db_) {
+      alias_db_ = torch::make_unique<AliasDb>(graph_);
+    }
+    return *alias_db_;
+  }
+
+  bool isPure(Node* node) {
+    if (!isPureKind(node) || node->hasSideEffects() ||
+        node->isNondeterministic()) {
+      return false;
+    }
+    for (Block* block : node->blocks()) {
+      for (Node* nested : block->nodes()) {
+        if (!isPure(nested)) {
+          return false;
+        }
+      }
+    }
+    return !aliasDb().isMutable(node) && !aliasDb().hasWriters(node);
+  }
+
+  // Whether the values that `node` and its blocks use are all computed
+  // outside of `body`, by hoisted nodes or in the blocks of `node`.
+  bool usesOnlyInvariants(
+      Node* node,
+      Node* top_level,
+      Block* body,
+      const std::unordered_set<Node*>& hoisted) {
+    for (Value* input : node->inputs()) {
+      Node* producer = topLevelNodeIn(input->node(), body);
+      if (producer && producer != top_level && !hoisted.count(producer)) {
+        return false;
+      }
+    }
+    for (Block* block : node->blocks()) {
+      for (Node* nested : block->nodes()) {
+        if (!usesOnlyInvariants(nested, top_level, body, hoisted)) {
+          return false;
+        }
+      }
+      if (!usesOnlyInvariants(block->return_node(), top_level, body, hoisted)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool hoist(Node* loop) {
+    LoopView loop_view(loop);
+    Block* body = loop_view.bodyBlock();
+    std::vector<Node*> invariant;
+    std::unordered_set<Node*> hoisted;
+    for (Node* node : body->nodes()) {
+      // Nodes after a side effect, e.g. an assert, must not run before it, so
+      // only the nodes that come before the first one can be hoisted.
+      if (hasSideEffectsIn(node)) {
+        break;
+      }
+      if (isPure(node) && usesOnlyInvariants(node, node, body, hoisted)) {
+        invariant.push_back(node);
+        hoisted.insert(node);
+      }
+    }
+    if (invariant.empty()) {
+      return false;
+    }
+    GRAPH_DEBUG(
+        "Hoisting ", invariant.size(), " nodes out of ", getHeader(loop));
+
+    // Constants are free to compute, so they never need to be guarded.
+    std::vector<Node*> to_guard;
+    for (Node* node : invariant) {
+      if (node->kind() == prim::Constant) {
+        node->moveBefore(loop);
+      } else {
+        to_guard.push_back(node);
+      }
+    }
+    if (to_guard.empty()) {
+      return true;
+    }
+
+    c10::optional<int64_t> trip_count =
+        constant_as<int64_t>(loop_view.maxTripCount());
+    c10::optional<bool> input_cond = constant_as<bool>(loop_view.inputCond());
+    if (trip_count && *trip_count > 0 && input_cond && *input_cond) {
+      for (Node* node : to_guard) {
+        node->moveBefore(loop);
+      }
+      return true;
+    }
+    guard(loop_view, to_guard);
+    // The alias analysis doesn't know about the nodes created by guard().
+    alias_db_.reset();
+    return true;
+  }
+
+  // Moves `nodes` before `loop_view` in a prim::If that only runs them when
+  // the loop runs.
+  void guard(LoopView& loop_view, const std::vector<Node*>& nodes) {
+    WithInsertPoint insert_point_guard(loop_view.node());
+    Value* runs = graph_->insert(aten::gt, {loop_view.maxTripCount(), 0});
+    c10::optional<bool> input_cond = constant_as<bool>(loop_view.inputCond());
+    if (!input_cond || !*input_cond) {
+      runs = graph_->insert(aten::__and__, {runs, loop_view.inputCond()});
+    }
+    Node* if_node = graph_->insertNode(graph_->create(prim::If, {runs}, 0));
+    Block* then_block = if_node->addBlock();
+    Block* else_block = if_node->addBlock();
+    for (Node* node : nodes) {
+      node->moveBefore(then_block->return_node());
+    }
+
+    for (Node* node : nodes) {
+      for (Value* output : node->outputs()) {
+        std::vector<Use> outside_uses;
+        for (const Use& use : output->uses()) {
+          if (!topLevelNodeIn(use.user, then_block)) {
+            outside_uses.push_back(use);
+          }
+        }
+        if (outside_uses.empty()) {
+          continue;
+        }
+        then_block->registerOutput(output);
+        else_block->registerOutput(
+            else_block->appendNode(graph_->createUninitialized(output->type()))
+                ->output());
+        Value* guarded = if_node->addOutput()->copyMetadata(output);
+        for (const Use& use : outside_uses) {
+          use.user->replaceInput(use.offset, guarded);
+        }
+      }
+    }
+  }
+
+  std::shared_ptr<Graph> graph_;
+  std::unique_ptr<AliasDb> alias_db_;
+};
+
+} // namespace
+
+void LoopInvariantCodeMotion(std::shared_ptr<Graph>& graph) {
+  LoopInvariantHoister(graph).run();
+}
+
+} // namespace jit
+} // namespace torch
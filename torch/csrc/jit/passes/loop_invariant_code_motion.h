@@ -0,0 +1,37 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Hoists the nodes of a prim::Loop body that compute the same values at every
+// iteration out of the loop, e.g. the projections of an encoder output that a
+// scripted decoder recomputes at every step.
+//
+// A node is hoisted when its inputs are all defined outside of the loop (or
+// by other hoisted nodes), and it is pure: an aten op or a container
+// construct without side effects or randomness, or a prim::If made only of
+// such nodes, none of whose inputs or outputs are ever written to (according
+// to alias analysis), and it comes before any node of the body with side
+// effects (such as the prim::RaiseException of an assert), so that hoisting
+// it can't change which error is raised first. Inner loops are processed
+// first, so invariant code moves out of as many loops as it can.
+//
+// Unless the loop is known to run at least once, the hoisted nodes are
+// guarded by a prim::If on its trip count and initial condition, so that they
+// don't run (and can't fail) when the loop wouldn't:
+//
+//   %run : bool = aten::gt(%max_trip_count, 0)
+//   %y : Tensor = prim::If(%run)
+//     block0():
+//       %y.1 : Tensor = aten::mul(%x, %w)
+//       -> (%y.1)
+//     block1():
+//       %y.2 : Tensor = prim::Uninitialized()
+//       -> (%y.2)
+//   prim::Loop(%max_trip_count, %cond) ...
+TORCH_API void LoopInvariantCodeMotion(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
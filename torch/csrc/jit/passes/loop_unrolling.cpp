@@ -199,6 +199,19 @@ void unroll(Node* loop) {
   loop->eraseBlock(0);
   body = dest;
 
+  // For long constant-length loops, the iteration counts of both loops are
+  // known, and the epilogue runs less than kUnrollFactor times, so it can be
+  // unrolled entirely (or removed when the remainder is 0).
+  if (const_len) {
+    int64_t remainder = *const_len % kUnrollFactor;
+    loop->replaceInput(0, graph->insertConstant(*const_len / kUnrollFactor));
+    Block* epilogue_dest = loop_epilogue->addBlock();
+    repeatBody(loop_epilogue->blocks().at(0), remainder, epilogue_dest);
+    loop_epilogue->eraseBlock(0);
+    inlineBody(loop_epilogue);
+    return;
+  }
+
   // Change the iteration counts of both loops
   Value* iter_count = loop->inputs().at(0);
   Value* unrolled_iter_count = graph->insert(
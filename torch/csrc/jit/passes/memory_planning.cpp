@@ -0,0 +1,340 @@
+#include <torch/csrc/jit/passes/memory_planning.h>
+
+#include <ATen/ATen.h>
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/utils/out_variant.h>
+#include <torch/csrc/jit/runtime/custom_operator.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+constexpr size_t kSlotAlignment = 64;
+// Number of arenas kept per planned graph, i.e. of concurrent runs that don't
+// allocate.
+constexpr size_t kMaxArenas = 8;
+
+size_t alignSlot(size_t nbytes) {
+  return (nbytes + kSlotAlignment - 1) / kSlotAlignment * kSlotAlignment;
+}
+
+// Where each slot lives in an arena.
+struct ArenaLayout {
+  std::vector<size_t> offsets;
+  std::vector<size_t> capacities;
+  size_t nbytes = 0;
+};
+
+// The memory used by one run of a planned graph. The tensors of the slots
+// hold a reference to it, so it is only reused once they are all gone.
+struct MemoryArena : torch::CustomClassHolder {
+  // An arena for the first run, which records how large the slots get.
+  explicit MemoryArena(size_t num_slots) : profiled_slots(num_slots) {}
+
+  explicit MemoryArena(std::shared_ptr<const ArenaLayout> layout_)
+      : layout(std::move(layout_)),
+        buffer(c10::GetCPUAllocator()->allocate(layout->nbytes)) {}
+
+  at::Tensor slot(size_t index, at::ScalarType scalar_type);
+
+  const std::shared_ptr<const ArenaLayout> layout;
+  const at::DataPtr buffer;
+  // Without a layout, the tensor of each slot.
+  std::vector<at::Tensor> profiled_slots;
+};
+
+void releaseArena(void* arena) {
+  c10::raw::intrusive_ptr::decref(static_cast<MemoryArena*>(arena));
+}
+
+at::Tensor MemoryArena::slot(size_t index, at::ScalarType scalar_type) {
+  if (!layout) {
+    auto tensor = at::empty({0}, at::TensorOptions(at::kCPU).dtype(scalar_type));
+    profiled_slots.at(index) = tensor;
+    return tensor;
+  }
+  c10::raw::intrusive_ptr::incref(this);
+  at::DataPtr data(
+      static_cast<char*>(buffer.get()) + layout->offsets.at(index),
+      this,
+      &releaseArena,
+      at::Device(at::kCPU));
+  // Resizable, so that a tensor that outgrows its slot gets reallocated
+  // rather than spilling over the other slots.
+  at::Storage storage(
+      at::Storage::use_byte_size_t(),
+      layout->capacities[index],
+      std::move(data),
+      c10::GetCPUAllocator(),
+      /*resizable=*/true);
+  return at::detail::make_tensor<c10::TensorImpl>(
+      std::move(storage),
+      c10::DispatchKeySet(c10::DispatchKey::CPU),
+      c10::scalarTypeToTypeMeta(scalar_type));
+}
+
+// The arenas of one prim::MemoryPlanArena node.
+class MemoryPlan {
+ public:
+  MemoryPlan(std::vector<int64_t> starts, std::vector<int64_t> ends)
+      : starts_(std::move(starts)), ends_(std::move(ends)) {
+    TORCH_INTERNAL_ASSERT(starts_.size() == ends_.size());
+  }
+
+  c10::intrusive_ptr<MemoryArena> acquire() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!layout_) {
+      planFromProfiledRuns();
+    }
+    if (!layout_) {
+      auto arena = c10::make_intrusive<MemoryArena>(starts_.size());
+      if (arenas_.size() < kMaxArenas) {
+        arenas_.push_back(arena);
+      }
+      return arena;
+    }
+    for (const auto& arena : arenas_) {
+      if (arena.use_count() == 1) {
+        return arena;
+      }
+    }
+    auto arena = c10::make_intrusive<MemoryArena>(layout_);
+    if (arenas_.size() < kMaxArenas) {
+      arenas_.push_back(arena);
+    }
+    return arena;
+  }
+
+ private:
+  bool liveAtTheSameTime(size_t a, size_t b) const {
+    return starts_[a] <= ends_[b] && starts_[b] <= ends_[a];
+  }
+
+  // Computes the layout from the first profiling run that completed.
+  void planFromProfiledRuns() {
+    for (auto it = arenas_.begin(); it != arenas_.end(); ++it) {
+      const auto& slots = (*it)->profiled_slots;
+      if (it->use_count() != 1 ||
+          std::any_of(slots.begin(), slots.end(), [](const at::Tensor& t) {
+            return !t.defined();
+          })) {
+        continue;
+      }
+      std::vector<size_t> capacities;
+      for (const auto& t : slots) {
+        capacities.push_back(alignSlot(t.storage().nbytes()));
+      }
+      layout_ = computeLayout(capacities);
+      arenas_.clear();
+      return;
+    }
+  }
+
+  // Greedily places the largest slots first, each at the lowest offset that
+  // doesn't overlap a slot placed before it and live at the same time.
+  std::shared_ptr<const ArenaLayout> computeLayout(
+      const std::vector<size_t>& capacities) const {
+    auto layout = std::make_shared<ArenaLayout>();
+    layout->capacities = capacities;
+    layout->offsets.resize(capacities.size());
+    std::vector<size_t> order(capacities.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+      order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return capacities[a] > capacities[b];
+    });
+
+    std::vector<size_t> placed;
+    for (size_t slot : order) {
+      std::vector<std::pair<size_t, size_t>> taken;
+      for (size_t other : placed) {
+        if (liveAtTheSameTime(slot, other)) {
+          taken.emplace_back(
+              layout->offsets[other],
+              layout->offsets[other] + capacities[other]);
+        }
+      }
+      std::sort(taken.begin(), taken.end());
+      size_t offset = 0;
+      for (const auto& range : taken) {
+        if (offset + capacities[slot] <= range.first) {
+          break;
+        }
+        offset = std::max(offset, range.second);
+      }
+      layout->offsets[slot] = offset;
+      layout->nbytes = std::max(layout->nbytes, offset + capacities[slot]);
+      placed.push_back(slot);
+    }
+    GRAPH_DEBUG(
+        "Planned an arena of ",
+        layout->nbytes,
+        " bytes for ",
+        capacities.size(),
+        " tensors");
+    return layout;
+  }
+
+  const std::vector<int64_t> starts_;
+  const std::vector<int64_t> ends_;
+  std::mutex mutex_;
+  std::shared_ptr<const ArenaLayout> layout_;
+  std::vector<c10::intrusive_ptr<MemoryArena>> arenas_;
+};
+
+Operation createMemoryPlanArena(const Node* node) {
+  auto plan =
+      std::make_shared<MemoryPlan>(node->is(attr::starts), node->is(attr::ends));
+  return [plan](Stack& stack) {
+    push(stack, IValue::make_capsule(plan->acquire()));
+    return 0;
+  };
+}
+
+Operation createMemoryPlanSlot(const Node* node) {
+  size_t slot = node->i(attr::slot);
+  auto scalar_type = static_cast<at::ScalarType>(node->i(attr::scalar_type));
+  return [slot, scalar_type](Stack& stack) {
+    auto arena = pop(stack).toCapsule();
+    push(stack, static_cast<MemoryArena*>(arena.get())->slot(slot, scalar_type));
+    return 0;
+  };
+}
+
+RegisterOperators reg_memory_planning({
+    // Conservative, so that the arena is never treated as a constant.
+    Operator(
+        "prim::MemoryPlanArena() -> Capsule",
+        createMemoryPlanArena,
+        AliasAnalysisKind::CONSERVATIVE),
+    Operator(
+        "prim::MemoryPlanSlot(Capsule arena) -> Tensor",
+        createMemoryPlanSlot,
+        AliasAnalysisKind::FROM_SCHEMA),
+});
+
+bool canPlan(Node* node, const AliasDb& alias_db) {
+  if (!node->kind().is_aten() || node->outputs().size() != 1) {
+    return false;
+  }
+  auto type = node->output()->type()->cast<TensorType>();
+  return type && type->scalarType() && type->device() &&
+      type->device()->is_cpu() && type->requiresGrad() == false &&
+      !alias_db.escapesScope({node->output()});
+}
+
+void collectValues(Block* block, std::vector<Value*>& values) {
+  for (Value* input : block->inputs()) {
+    values.push_back(input);
+  }
+  for (Node* node : block->nodes()) {
+    for (Value* output : node->outputs()) {
+      values.push_back(output);
+    }
+    for (Block* sub_block : node->blocks()) {
+      collectValues(sub_block, values);
+    }
+  }
+}
+
+struct PlannedValue {
+  Node* node;
+  int64_t start;
+  int64_t end;
+};
+
+} // namespace
+
+void PlanMemory(std::shared_ptr<Graph>& graph) {
+  Block* block = graph->block();
+  std::unordered_map<Node*, int64_t> positions;
+  for (Node* node : block->nodes()) {
+    positions.emplace(node, positions.size());
+  }
+  positions.emplace(block->return_node(), positions.size());
+  auto position = [&](Node* node) {
+    while (node->owningBlock() != block) {
+      node = node->owningBlock()->owningNode();
+    }
+    return positions.at(node);
+  };
+
+  // The tensor of a slot must stay untouched until the last use of anything
+  // that may alias or contain it (e.g. a view, or a list it was put in), so
+  // the liveness of the value itself isn't enough.
+  std::vector<PlannedValue> planned;
+  {
+    AliasDb alias_db(graph);
+    std::vector<Value*> values;
+    collectValues(block, values);
+    for (Node* node : block->nodes()) {
+      if (!canPlan(node, alias_db)) {
+        continue;
+      }
+      int64_t end = positions.at(node);
+      for (Value* value : values) {
+        if (!alias_db.mayContainAlias(value, node->output())) {
+          continue;
+        }
+        for (const Use& use : value->uses()) {
+          end = std::max(end, position(use.user));
+        }
+      }
+      planned.push_back(PlannedValue{node, positions.at(node), end});
+    }
+  }
+  if (planned.empty()) {
+    return;
+  }
+
+  Node* arena = graph->create(prim::MemoryPlanArena, 1);
+  arena->output()->setType(CapsuleType::get());
+  arena->insertBefore(block->nodes().front());
+
+  std::vector<int64_t> starts;
+  std::vector<int64_t> ends;
+  for (const auto& value : planned) {
+    auto scalar_type =
+        *value.node->output()->type()->expect<TensorType>()->scalarType();
+    Node* slot = graph->create(prim::MemoryPlanSlot, {arena->output()}, 1);
+    slot->i_(attr::slot, static_cast<int64_t>(starts.size()))
+        ->i_(attr::scalar_type, static_cast<int64_t>(scalar_type));
+    slot->output()->setType(TensorType::get());
+    slot->insertBefore(value.node);
+    Node* out_node = tryCreateOutVariant(value.node, slot->output());
+    if (!out_node) {
+      slot->destroy();
+      continue;
+    }
+    value.node->output()->replaceAllUsesWith(out_node->output());
+    value.node->destroy();
+    starts.push_back(value.start);
+    ends.push_back(value.end);
+  }
+  if (starts.empty()) {
+    arena->destroy();
+    return;
+  }
+  arena->is_(attr::starts, starts)->is_(attr::ends, ends);
+  GRAPH_DUMP("After PlanMemory: ", graph);
+}
+
+static std::atomic<bool> memory_planning_enabled{false};
+
+void setMemoryPlanningEnabled(bool enabled) {
+  memory_planning_enabled = enabled;
+}
+
+bool memoryPlanningEnabled() {
+  return memory_planning_enabled;
+}
+
+} // namespace jit
+} // namespace torch
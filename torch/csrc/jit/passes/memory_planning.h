@@ -0,0 +1,36 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Makes the intermediate tensors of an inference graph live in one reusable
+// arena instead of being allocated on every run.
+//
+// Every top level op whose output is a CPU tensor of known dtype that doesn't
+// require grad and doesn't escape the graph, and that has an out= overload,
+// is rewritten to write into a slot of the arena:
+//
+//   %arena : Capsule = prim::MemoryPlanArena[starts=[...], ends=[...]]()
+//   ...
+//   %buf : Tensor = prim::MemoryPlanSlot[slot=0, scalar_type=6](%arena)
+//   %a : Tensor = aten::mul(%x, %y, %buf)   // mul.out
+//
+// The live range of each slot (in top level nodes, extended to the uses of
+// everything that may alias or contain its tensor) is recorded on the arena
+// node. The sizes aren't known at compile time: the first run allocates the
+// slots as usual and records how large they get, then slots whose live ranges
+// overlap are packed at different offsets of an arena allocated once and
+// reused by the following runs. A slot that outgrows its place in the arena
+// (e.g. because the input shapes changed) is moved to its own allocation by
+// the resize in the out= op.
+TORCH_API void PlanMemory(std::shared_ptr<Graph>& graph);
+
+// Whether the graph executors plan the memory of the graphs they optimize for
+// inference (i.e. when no gradient is needed).
+TORCH_API void setMemoryPlanningEnabled(bool enabled);
+TORCH_API bool memoryPlanningEnabled();
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,284 @@
+#include <torch/csrc/jit/passes/parallelize_independent_nodes.h>
+
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/jit_log.h>
+
+#include <algorithm>
+#include <atomic>
+#include <set>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// Groups with fewer nodes than this aren't worth the cost of a fork.
+constexpr size_t kMinGroupSize = 3;
+constexpr int64_t kNoGroup = -1;
+
+bool isForkable(Node* node, const AliasDb& alias_db) {
+  switch (node->kind()) {
+    case prim::ListConstruct:
+    case prim::ListUnpack:
+    case prim::TupleConstruct:
+    case prim::TupleUnpack:
+      break;
+    default:
+      if (!node->kind().is_aten() || node->kind() == aten::wait) {
+        return false;
+      }
+  }
+  return node->blocks().empty() && !node->hasSideEffects() &&
+      !node->isNondeterministic() && !alias_db.hasWriters(node);
+}
+
+// The values used by `node`, including the ones used in its blocks.
+void collectInputs(Node* node, std::vector<Value*>& inputs) {
+  for (Value* input : node->inputs()) {
+    inputs.push_back(input);
+  }
+  for (Block* block : node->blocks()) {
+    for (Node* nested : block->nodes()) {
+      collectInputs(nested, inputs);
+    }
+    collectInputs(block->return_node(), inputs);
+  }
+}
+
+struct Group {
+  std::vector<Node*> nodes;
+  // Whether a node outside of the group uses its values, after which no
+  // node can join it, so that all the users of the group come after it.
+  bool closed = false;
+  // The groups it depends on, directly or not.
+  std::set<size_t> dependencies;
+};
+
+class IndependentNodesParallelizer {
+ public:
+  explicit IndependentNodesParallelizer(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)) {}
+
+  void run() {
+    partition();
+    std::vector<size_t> to_fork;
+    for (size_t g = 0; g < groups_.size(); ++g) {
+      if (shouldFork(g)) {
+        to_fork.push_back(g);
+      }
+    }
+    // The values of a group are used after its last node, so rewriting the
+    // groups in that order only ever moves nodes that are still in place.
+    std::sort(to_fork.begin(), to_fork.end(), [&](size_t a, size_t b) {
+      return groups_[a].nodes.back()->isBefore(groups_[b].nodes.back());
+    });
+    for (size_t g : to_fork) {
+      fork(groups_[g]);
+    }
+    if (!to_fork.empty()) {
+      GRAPH_DUMP("After ParallelizeIndependentNodes: ", graph_);
+    }
+  }
+
+ private:
+  Node* topLevelNode(Node* node) const {
+    while (node->owningBlock() != graph_->block()) {
+      node = node->owningBlock()->owningNode();
+    }
+    return node;
+  }
+
+  void partition() {
+    AliasDb alias_db(graph_);
+    std::vector<Node*> nodes(
+        graph_->nodes().begin(), graph_->nodes().end());
+    std::unordered_map<Node*, size_t> positions;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      positions.emplace(nodes[i], i);
+    }
+    std::vector<int64_t> group_of(nodes.size(), kNoGroup);
+    std::vector<std::set<size_t>> dependencies(nodes.size());
+
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      Node* node = nodes[i];
+      // Constants are cloned into the forks that use them.
+      if (node->kind() == prim::Constant) {
+        continue;
+      }
+      std::vector<Value*> inputs;
+      collectInputs(node, inputs);
+      std::set<size_t> producer_groups;
+      for (Value* input : inputs) {
+        auto it = positions.find(topLevelNode(input->node()));
+        if (it == positions.end() || it->second == i) {
+          continue;
+        }
+        size_t producer = it->second;
+        dependencies[i].insert(
+            dependencies[producer].begin(), dependencies[producer].end());
+        if (group_of[producer] != kNoGroup) {
+          producer_groups.insert(group_of[producer]);
+          dependencies[i].insert(group_of[producer]);
+        }
+      }
+
+      if (isForkable(node, alias_db) && producer_groups.size() <= 1 &&
+          (producer_groups.empty() ||
+           !groups_[*producer_groups.begin()].closed)) {
+        if (producer_groups.empty()) {
+          groups_.emplace_back();
+          group_of[i] = groups_.size() - 1;
+        } else {
+          group_of[i] = *producer_groups.begin();
+        }
+      } else {
+        for (size_t g : producer_groups) {
+          groups_[g].closed = true;
+        }
+        if (isForkable(node, alias_db)) {
+          groups_.emplace_back();
+          group_of[i] = groups_.size() - 1;
+        }
+      }
+
+      if (group_of[i] != kNoGroup) {
+        Group& group = groups_[group_of[i]];
+        group.nodes.push_back(node);
+        group.dependencies.insert(
+            dependencies[i].begin(), dependencies[i].end());
+        group.dependencies.erase(group_of[i]);
+      }
+    }
+  }
+
+  bool independent(size_t a, size_t b) const {
+    return groups_[a].dependencies.count(b) == 0 &&
+        groups_[b].dependencies.count(a) == 0;
+  }
+
+  // The groups are numbered in the order of their first node, so the last
+  // of a set of independent groups runs on the calling thread.
+  bool shouldFork(size_t g) const {
+    if (groups_[g].nodes.size() < kMinGroupSize) {
+      return false;
+    }
+    for (size_t other = g + 1; other < groups_.size(); ++other) {
+      if (groups_[other].nodes.size() >= kMinGroupSize &&
+          independent(g, other)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void fork(const Group& group) {
+    std::unordered_set<Node*> in_group(group.nodes.begin(), group.nodes.end());
+    auto subgraph = std::make_shared<Graph>();
+    Node* fork_node = graph_->create(prim::fork, 1);
+    fork_node->insertBefore(group.nodes.back());
+
+    std::unordered_map<Value*, Value*> env;
+    auto value_map = [&](Value* v) {
+      auto it = env.find(v);
+      if (it != env.end()) {
+        return it->second;
+      }
+      Value* mapped = nullptr;
+      if (v->node()->kind() == prim::Constant) {
+        mapped = subgraph
+                     ->appendNode(subgraph->createClone(
+                         v->node(), [](Value* v) { return v; }))
+                     ->output();
+      } else {
+        mapped = subgraph->addInput()->copyMetadata(v);
+        fork_node->addInput(v);
+      }
+      env.emplace(v, mapped);
+      return mapped;
+    };
+
+    // The values of the group used outside of it, and the first of the
+    // nodes that use them.
+    std::vector<Value*> outputs;
+    Node* first_user = nullptr;
+    for (Node* node : group.nodes) {
+      Node* clone = subgraph->appendNode(subgraph->createClone(node, value_map));
+      for (size_t i = 0; i < node->outputs().size(); ++i) {
+        Value* output = node->outputs()[i];
+        clone->outputs()[i]->copyMetadata(output);
+        env.emplace(output, clone->outputs()[i]);
+        bool used_outside = false;
+        for (const Use& use : output->uses()) {
+          Node* user = topLevelNode(use.user);
+          if (in_group.count(user)) {
+            continue;
+          }
+          used_outside = true;
+          if (!first_user || user->isBefore(first_user)) {
+            first_user = user;
+          }
+        }
+        if (used_outside) {
+          outputs.push_back(output);
+        }
+      }
+    }
+    if (outputs.empty()) {
+      // Nothing uses the group, leave it to dead code elimination.
+      fork_node->destroy();
+      return;
+    }
+
+    if (outputs.size() == 1) {
+      subgraph->registerOutput(env.at(outputs[0]));
+    } else {
+      std::vector<Value*> elements;
+      for (Value* output : outputs) {
+        elements.push_back(env.at(output));
+      }
+      subgraph->registerOutput(
+          subgraph->appendNode(subgraph->createTuple(elements))->output());
+    }
+    TypePtr result_type = subgraph->outputs()[0]->type();
+    fork_node->output()->setType(FutureType::create(result_type));
+    fork_node->g_(attr::Subgraph, subgraph);
+
+    Node* wait = graph_->create(aten::wait, {fork_node->output()}, 1);
+    wait->insertBefore(first_user);
+    wait->output()->setType(result_type);
+    if (outputs.size() == 1) {
+      outputs[0]->replaceAllUsesWith(wait->output());
+    } else {
+      Node* unpack = graph_->createTupleUnpack(wait->output());
+      unpack->insertAfter(wait);
+      for (size_t i = 0; i < outputs.size(); ++i) {
+        outputs[i]->replaceAllUsesWith(unpack->outputs()[i]);
+      }
+    }
+    for (auto it = group.nodes.rbegin(); it != group.nodes.rend(); ++it) {
+      (*it)->destroy();
+    }
+  }
+
+  std::shared_ptr<Graph> graph_;
+  std::vector<Group> groups_;
+};
+
+} // namespace
+
+void ParallelizeIndependentNodes(std::shared_ptr<Graph>& graph) {
+  IndependentNodesParallelizer(graph).run();
+}
+
+static std::atomic<bool> inter_op_parallelization_enabled{false};
+
+void setInterOpParallelizationEnabled(bool enabled) {
+  inter_op_parallelization_enabled = enabled;
+}
+
+bool interOpParallelizationEnabled() {
+  return inter_op_parallelization_enabled;
+}
+
+} // namespace jit
+} // namespace torch
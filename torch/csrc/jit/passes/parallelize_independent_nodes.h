@@ -0,0 +1,33 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Runs the independent parts of a graph concurrently on the inter-op thread
+// pool, e.g. the towers of a multi-tower model.
+//
+// The top level nodes are partitioned into groups of nodes that only depend
+// on each other (or on values computed by the rest of the graph). Each group
+// that is large enough and has another such group independent of it later in
+// the graph is moved to the subgraph of a prim::fork, and its results are
+// aten::wait'ed for right before their first use:
+//
+//   %fut : Future(Tensor) = prim::fork_0(%x)   // the nodes of the group
+//   ...                                        // independent nodes
+//   %a : Tensor = aten::wait(%fut)
+//
+// The last group of a set of independent ones stays on the calling thread.
+// Only pure nodes (aten ops without side effects, blocks, randomness, and
+// container constructs) whose inputs and outputs are never written to are
+// moved, so that the forked nodes can't race with the rest of the graph.
+TORCH_API void ParallelizeIndependentNodes(std::shared_ptr<Graph>& graph);
+
+// Whether the graph executors parallelize the graphs they optimize for
+// inference (i.e. when no gradient is needed).
+TORCH_API void setInterOpParallelizationEnabled(bool enabled);
+TORCH_API bool interOpParallelizationEnabled();
+
+} // namespace jit
+} // namespace torch
@@ -14,6 +14,40 @@ namespace torch {
 namespace jit {
 
 namespace tensorexpr {
+// The kernels reduce float and double CPU tensors, over axes known at compile
+// time and without converting them to another dtype.
+static bool isSupportedReduction(Node* node) {
+  auto tt = node->inputs()[0]->type()->cast<TensorType>();
+  if (!tt || !tt->scalarType() || !tt->device() || !tt->device()->is_cpu() ||
+      !tt->dim() || *tt->dim() == 0) {
+    return false;
+  }
+  if (*tt->scalarType() != at::kFloat && *tt->scalarType() != at::kDouble) {
+    return false;
+  }
+  for (size_t i = 1; i < node->inputs().size(); i++) {
+    if (node->inputs()[i]->node()->kind() != prim::Constant) {
+      return false;
+    }
+  }
+  // The dtype is the last argument.
+  if (node->inputs().back()->type()->kind() != TypeKind::NoneType) {
+    return false;
+  }
+  switch (node->kind()) {
+    case aten::sum:
+    case aten::mean:
+      // Either over all the axes, or over a list of them.
+      return node->inputs().size() == 2 ||
+          (node->inputs().size() == 4 &&
+           node->inputs()[1]->type()->isSubtypeOf(ListType::ofInts()));
+    default:
+      // softmax and log_softmax, over one axis.
+      return node->inputs().size() == 3 &&
+          node->inputs()[1]->type()->isSubtypeOf(IntType::get());
+  }
+}
+
 bool isSupported(Node* node) {
   // TODO:
   switch (node->kind()) {
@@ -93,6 +127,11 @@ bool isSupported(Node* node) {
         return false;
       }
       return true;
+    case aten::sum:
+    case aten::mean:
+    case aten::softmax:
+    case aten::log_softmax:
+      return isSupportedReduction(node);
     default:
       return false;
   }
@@ -115,6 +154,15 @@ bool tensorExprFuserEnabled() {
   return true;
 }
 
+static bool texpr_dynamic_shapes_enabled_ = false;
+void setTensorExprDynamicShapesEnabled(bool val) {
+  texpr_dynamic_shapes_enabled_ = val;
+}
+
+bool tensorExprDynamicShapesEnabled() {
+  return texpr_dynamic_shapes_enabled_;
+}
+
 const Symbol& getTensorExprSymbol() {
   static Symbol s = Symbol::fromQualString("tensorexpr::Group");
   return s;
@@ -139,22 +187,41 @@ value_list sortReverseTopological(
   return result;
 }
 
-bool allShapesAreKnown(Value* v) {
-  if (!v->type()->cast<TensorType>()) {
+// With dynamic shapes, the sizes of a tensor of known rank can be symbolic
+// (unless `allowSymbolic` is false): they are passed to the kernel when it
+// runs.
+bool allShapesAreKnown(Value* v, bool allowSymbolic) {
+  auto tt = v->type()->cast<TensorType>();
+  if (!tt || v->isCompleteTensor()) {
     return true;
   }
-  return v->isCompleteTensor();
+  return allowSymbolic && tensorExprDynamicShapesEnabled() &&
+      tt->scalarType() && tt->device() && tt->symbolic_sizes().rank();
+}
+
+// Whether the lowering of `node` needs the static sizes of its values.
+bool needsStaticShapes(Node* node) {
+  switch (node->kind()) {
+    case aten::cat:
+    case aten::slice:
+    case aten::unsqueeze:
+    case prim::ConstantChunk:
+    case prim::ListConstruct:
+      return true;
+    default:
+      return false;
+  }
 }
 
 bool allShapesAreKnown(Node* node) {
-  // TODO: Relax the checks to support dynamic shapes
+  bool allowSymbolic = !needsStaticShapes(node);
   for (torch::jit::Value* output : node->outputs()) {
-    if (!allShapesAreKnown(output)) {
+    if (!allShapesAreKnown(output, allowSymbolic)) {
       return false;
     }
   }
   for (torch::jit::Value* input : node->inputs()) {
-    if (!allShapesAreKnown(input)) {
+    if (!allShapesAreKnown(input, allowSymbolic)) {
       return false;
     }
   }
@@ -195,9 +262,9 @@ bool canHandle(Node* node, AliasDb& aliasDb) {
   }
 
 bool canMerge(Node* consumer, Node* producer, AliasDb& aliasDb) {
-  // Only handle complete tensor types
+  // Only handle complete tensor types, or ones of symbolic sizes
   for (torch::jit::Value* output : consumer->outputs()) {
-    REQ(output->isCompleteTensor());
+    REQ(allShapesAreKnown(output, /*allowSymbolic=*/true));
   }
 
   // Only fuse within a block
@@ -15,6 +15,11 @@ TORCH_API void FuseTensorExprs(std::shared_ptr<Graph>& graph);
 TORCH_API void setTensorExprFuserEnabled(bool val);
 TORCH_API bool tensorExprFuserEnabled();
 
+// Whether the profiling executor lets the fuser compile kernels for symbolic
+// shapes, so that they don't need to be compiled again for new input sizes.
+TORCH_API void setTensorExprDynamicShapesEnabled(bool val);
+TORCH_API bool tensorExprDynamicShapesEnabled();
+
 namespace tensorexpr {
 TORCH_API bool isSupported(Node* node);
 }
@@ -0,0 +1,66 @@
+#include <torch/csrc/jit/passes/utils/out_variant.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// The out= variant returns `out`, so its result has the sizes of the
+// functional op but the strides of `out`, which may be a non-contiguous view
+// (e.g. a slice of a larger buffer), or unknown.
+TypePtr outVariantType(Value* functional_output, Value* out) {
+  auto type = functional_output->type()->cast<TensorType>();
+  if (!type) {
+    return functional_output->type();
+  }
+  auto out_type = out->type()->cast<TensorType>();
+  auto sizes = type->sizes().concrete_sizes();
+  if (out_type && out_type->isComplete() && sizes &&
+      out_type->sizes().concrete_sizes() == sizes) {
+    return type->withSizesStrides(
+        *sizes, *out_type->strides().concrete_sizes());
+  }
+  return type->dimensionedOnly()->withSymbolicShapes(type->symbolic_sizes());
+}
+
+} // namespace
+
+Node* tryCreateOutVariant(Node* producer, Value* out) {
+  if (!producer->kind().is_aten() || producer->outputs().size() != 1) {
+    return nullptr;
+  }
+  auto functional_schema = producer->maybeSchema();
+  if (!functional_schema || functional_schema->is_mutable() ||
+      functional_schema->returns().size() != 1 ||
+      functional_schema->returns()[0].alias_info()) {
+    return nullptr;
+  }
+
+  Graph* graph = producer->owningGraph();
+  std::vector<Value*> inputs(
+      producer->inputs().begin(), producer->inputs().end());
+  inputs.push_back(out);
+  Node* out_node = graph->create(producer->kind(), inputs, 1);
+  out_node->output()->setType(outVariantType(producer->output(), out));
+  out_node->insertBefore(producer);
+
+  // Schema matching only looks at the input types, so double check that what
+  // we've found really is the out= variant of the functional op.
+  auto out_schema = out_node->maybeSchema();
+  bool is_out_variant = out_schema &&
+      out_schema->arguments().size() == inputs.size() &&
+      out_schema->arguments().back().alias_info() &&
+      out_schema->arguments().back().alias_info()->isWrite();
+  for (size_t i = 0; is_out_variant && i < producer->inputs().size(); ++i) {
+    is_out_variant = *out_schema->arguments()[i].type() ==
+        *functional_schema->arguments()[i].type();
+  }
+  if (!is_out_variant) {
+    out_node->destroy();
+    return nullptr;
+  }
+  return out_node;
+}
+
+} // namespace jit
+} // namespace torch
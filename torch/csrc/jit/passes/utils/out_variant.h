@@ -0,0 +1,16 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Checks whether the functional aten op `producer` has an out= overload
+// taking the same arguments, and if so inserts a call to it writing into
+// `out` right before `producer`, and returns it. The caller is responsible
+// for replacing the uses of `producer` and destroying it.
+TORCH_API Node* tryCreateOutVariant(Node* producer, Value* out);
+
+} // namespace jit
+} // namespace torch
@@ -7,8 +7,10 @@
 #include <torch/csrc/jit/frontend/ir_emitter.h>
 #include <torch/csrc/jit/frontend/tracer.h>
 #include <torch/csrc/jit/ir/irparser.h>
+#include <torch/csrc/jit/passes/batch_mm.h>
 #include <torch/csrc/jit/passes/canonicalize.h>
 #include <torch/csrc/jit/passes/canonicalize_graph_fuser_ops.h>
+#include <torch/csrc/jit/passes/cat_elimination.h>
 #include <torch/csrc/jit/passes/common_subexpression_elimination.h>
 #include <torch/csrc/jit/passes/constant_pooling.h>
 #include <torch/csrc/jit/passes/constant_propagation.h>
@@ -24,9 +26,11 @@
 #include <torch/csrc/jit/passes/graph_fuser.h>
 #include <torch/csrc/jit/passes/inline_fork_wait.h>
 #include <torch/csrc/jit/passes/inliner.h>
+#include <torch/csrc/jit/passes/loop_invariant_code_motion.h>
 #include <torch/csrc/jit/passes/loop_unrolling.h>
 #include <torch/csrc/jit/passes/lower_graph.h>
 #include <torch/csrc/jit/passes/lower_tuples.h>
+#include <torch/csrc/jit/passes/memory_planning.h>
 #include <torch/csrc/jit/passes/normalize_ops.h>
 #include <torch/csrc/jit/passes/onnx.h>
 #include <torch/csrc/jit/passes/onnx/cast_all_constant_to_floating.h>
@@ -39,6 +43,7 @@
 #include <torch/csrc/jit/passes/onnx/prepare_inplace_ops_for_onnx.h>
 #include <torch/csrc/jit/passes/onnx/scalar_type_analysis.h>
 #include <torch/csrc/jit/passes/onnx/unpack_quantized_weights.h>
+#include <torch/csrc/jit/passes/parallelize_independent_nodes.h>
 #include <torch/csrc/jit/passes/peephole.h>
 #include <torch/csrc/jit/passes/quantization/dedup_module_uses.h>
 #include <torch/csrc/jit/passes/quantization/finalize.h>
@@ -67,8 +72,11 @@
 #include <torch/csrc/jit/runtime/autodiff.h>
 #include <torch/csrc/jit/runtime/graph_executor.h>
 #include <torch/csrc/jit/runtime/jit_exception.h>
+#include <torch/csrc/jit/runtime/kernel_disk_cache.h>
+#include <torch/csrc/jit/runtime/lazy_eager.h>
 #include <torch/csrc/jit/runtime/operator.h>
 #include <torch/csrc/jit/runtime/print_handler.h>
+#include <torch/csrc/jit/runtime/static_runtime.h>
 #include <torch/csrc/jit/serialization/export.h>
 #include <torch/csrc/jit/serialization/import.h>
 #include <torch/csrc/jit/tensorexpr/execution_counter.h>
@@ -239,6 +247,7 @@ void initJITBindings(PyObject* module) {
           py::arg("module"),
           py::arg("preservedAttrs") = std::vector<std::string>())
       .def("_jit_pass_fuse_linear", &FuseLinear)
+      .def("_jit_pass_fuse_sibling_linears", &FuseSiblingLinears)
       .def("_jit_pass_dedup_module_uses", &DedupModuleUses)
       .def("_jit_pass_replicate_dequantize", &ReplicateDeQuant)
       .def(
@@ -283,6 +292,25 @@ void initJITBindings(PyObject* module) {
       .def(
           "_jit_pass_create_functional_graphs",
           [](std::shared_ptr<Graph>& g) { return CreateFunctionalGraphs(g); })
+      .def(
+          "_jit_pass_eliminate_cat_copies",
+          [](std::shared_ptr<Graph>& g) { return EliminateCatCopies(g); })
+      .def(
+          "_jit_pass_plan_memory",
+          [](std::shared_ptr<Graph>& g) { return PlanMemory(g); })
+      .def("_jit_set_memory_planning_enabled", &setMemoryPlanningEnabled)
+      .def("_jit_memory_planning_enabled", &memoryPlanningEnabled)
+      .def(
+          "_jit_pass_parallelize_independent_nodes",
+          [](std::shared_ptr<Graph>& g) {
+            return ParallelizeIndependentNodes(g);
+          })
+      .def(
+          "_jit_set_inter_op_parallelization_enabled",
+          &setInterOpParallelizationEnabled)
+      .def(
+          "_jit_inter_op_parallelization_enabled",
+          &interOpParallelizationEnabled)
       .def(
           "_jit_pass_remove_mutation",
           [](std::shared_ptr<Graph>& g) {
@@ -339,6 +367,12 @@ void initJITBindings(PyObject* module) {
             return LowerGraph(*graph, self._ivalue());
           })
       .def("_jit_pass_loop_unrolling", UnrollLoops)
+      .def(
+          "_jit_pass_batch_mm",
+          [](std::shared_ptr<Graph>& g) { return BatchMM(g); })
+      .def(
+          "_jit_pass_loop_invariant_code_motion",
+          [](std::shared_ptr<Graph>& g) { return LoopInvariantCodeMotion(g); })
       .def(
           "_jit_pass_constant_propagation",
           [](std::shared_ptr<Graph>& g) { return ConstantPropagation(g); })
@@ -439,6 +473,13 @@ void initJITBindings(PyObject* module) {
             getNumProfiledRuns() = num;
             return old_num;
           })
+      .def(
+          "_jit_set_execution_plan_cache_capacity",
+          [](size_t capacity) {
+            size_t old_capacity = getExecutionPlanCacheCapacity();
+            getExecutionPlanCacheCapacity() = capacity;
+            return old_capacity;
+          })
       .def(
           "_jit_set_bailout_depth",
           [](size_t depth) {
@@ -505,10 +546,65 @@ void initJITBindings(PyObject* module) {
             using namespace torch::jit::tensorexpr;
             return getTECudaPointwiseBlockSize() = block_size;
           })
+      .def(
+          "_jit_get_te_shape_bucketing",
+          []() -> bool {
+            using namespace torch::jit::tensorexpr;
+            return getTEShapeBucketing();
+          })
+      .def(
+          "_jit_set_te_shape_bucketing",
+          [](bool enabled) {
+            using namespace torch::jit::tensorexpr;
+            return getTEShapeBucketing() = enabled;
+          })
       .def("_jit_set_texpr_fuser_enabled", &setTensorExprFuserEnabled)
       .def("_jit_texpr_fuser_enabled", &tensorExprFuserEnabled)
+      .def(
+          "_jit_set_texpr_dynamic_shapes_enabled",
+          &setTensorExprDynamicShapesEnabled)
+      .def(
+          "_jit_texpr_dynamic_shapes_enabled",
+          &tensorExprDynamicShapesEnabled)
       .def("_jit_texpr_fallback_allowed", &tensorexpr::fallbackAllowed)
       .def("_jit_texpr_set_fallback_allowed", &tensorexpr::setFallbackAllowed)
+      .def("_jit_lazy_eager_enter", &enterLazyEagerMode)
+      .def("_jit_lazy_eager_exit", &exitLazyEagerMode)
+      .def("_jit_lazy_eager_enabled", &lazyEagerModeEnabled)
+      .def("_jit_lazy_eager_flush", &lazyEagerFlush)
+      .def("_jit_lazy_eager_kernel_cache_size", &lazyEagerKernelCacheSize)
+      .def("_jit_lazy_eager_clear_kernel_cache", &lazyEagerClearKernelCache)
+      .def(
+          "_jit_kernel_cache_set_dir",
+          [](std::string directory) {
+            KernelDiskCache::get().setDirectory(std::move(directory));
+          })
+      .def(
+          "_jit_kernel_cache_dir",
+          []() { return KernelDiskCache::get().directory(); })
+      .def(
+          "_jit_kernel_cache_enabled",
+          []() { return KernelDiskCache::get().enabled(); })
+      .def(
+          "_jit_kernel_cache_max_bytes",
+          []() { return KernelDiskCache::get().maxBytes(); })
+      .def(
+          "_jit_kernel_cache_set_max_bytes",
+          [](size_t max_bytes) { KernelDiskCache::get().setMaxBytes(max_bytes); })
+      .def(
+          "_jit_kernel_cache_stats",
+          []() {
+            auto stats = KernelDiskCache::get().stats();
+            return std::unordered_map<std::string, size_t>{
+                {"hits", stats.hits},
+                {"misses", stats.misses},
+                {"stores", stats.stores},
+                {"evictions", stats.evictions}};
+          })
+      .def(
+          "_jit_kernel_cache_reset_stats",
+          []() { KernelDiskCache::get().resetStats(); })
+      .def("_jit_kernel_cache_clear", []() { KernelDiskCache::get().clear(); })
       .def(
           "_jit_pass_fuse_tensorexprs",
           [](std::shared_ptr<Graph>& g) { return FuseTensorExprs(g); })
@@ -669,6 +765,21 @@ void initJITBindings(PyObject* module) {
       .def_property_readonly(
           "fallback", [](GraphExecutorState& s) { return s.fallback; });
 
+  py::class_<StaticRuntime, std::shared_ptr<StaticRuntime>>(m, "StaticRuntime")
+      .def(
+          "run",
+          &StaticRuntime::run,
+          py::call_guard<py::gil_scoped_release>())
+      .def_property_readonly("graph", &StaticRuntime::graph);
+  m.def(
+      "_jit_to_static_runtime",
+      [](const std::shared_ptr<Graph>& g) {
+        return std::make_shared<StaticRuntime>(g);
+      });
+  m.def("_jit_to_static_runtime", [](const Module& module) {
+    return std::make_shared<StaticRuntime>(module);
+  });
+
   py::class_<PyTorchStreamWriter>(m, "PyTorchFileWriter")
       .def(py::init<std::string>())
       .def(py::init([](const py::object& buffer) {
@@ -937,6 +937,25 @@ void initJitScriptBindings(PyObject* module) {
             throw std::runtime_error(
                 "Attempted to call get_debug_state on a Module without a compiled forward()");
           })
+      .def(
+          "_precompile",
+          [](Module& self, const std::vector<py::tuple>& inputs) {
+            auto m = self.find_method("forward");
+            if (!m) {
+              throw std::runtime_error(
+                  "Attempted to call _precompile on a Module without a compiled forward()");
+            }
+            std::vector<Stack> stacks;
+            for (const auto& args : inputs) {
+              stacks.push_back(createStackForSchema(
+                  m->function().getSchema(),
+                  args,
+                  py::kwargs(),
+                  IValue(self._ivalue())));
+            }
+            pybind11::gil_scoped_release no_gil_guard;
+            m->get_executor().precompile(stacks);
+          })
       .def(
           "_define",
           [](Module& m,
@@ -1160,6 +1179,21 @@ void initJitScriptBindings(PyObject* module) {
           [](const StrongFunctionPtr& self) {
             return self.function_->get_executor().getDebugState();
           })
+      .def(
+          "_precompile",
+          [](const StrongFunctionPtr& self,
+             const std::vector<py::tuple>& inputs) {
+            std::vector<Stack> stacks;
+            for (const auto& args : inputs) {
+              stacks.push_back(createStackForSchema(
+                  self.function_->getSchema(),
+                  args,
+                  py::kwargs(),
+                  c10::nullopt));
+            }
+            pybind11::gil_scoped_release no_gil_guard;
+            self.function_->get_executor().precompile(stacks);
+          })
       .def_property_readonly(
           "name",
           [](const StrongFunctionPtr& self) { return self.function_->name(); })
@@ -19,9 +19,12 @@
 #include <torch/csrc/jit/passes/inline_autodiff_subgraphs.h>
 #include <torch/csrc/jit/passes/inliner.h>
 #include <torch/csrc/jit/passes/inplace_check.h>
+#include <torch/csrc/jit/passes/loop_invariant_code_motion.h>
 #include <torch/csrc/jit/passes/loop_unrolling.h>
 #include <torch/csrc/jit/passes/lower_grad_of.h>
 #include <torch/csrc/jit/passes/lower_tuples.h>
+#include <torch/csrc/jit/passes/memory_planning.h>
+#include <torch/csrc/jit/passes/parallelize_independent_nodes.h>
 #include <torch/csrc/jit/passes/pass_manager.h>
 #include <torch/csrc/jit/passes/peephole.h>
 #include <torch/csrc/jit/passes/remove_expands.h>
@@ -44,6 +47,7 @@
 
 #include <cstdint>
 #include <iterator>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -71,6 +75,11 @@ bool getAutodiffSubgraphInlining() {
   return autodiff_subgraph_inlining;
 }
 
+std::atomic<size_t>& getExecutionPlanCacheCapacity() {
+  static std::atomic<size_t> capacity{64};
+  return capacity;
+}
+
 thread_local std::weak_ptr<Graph> last_executed_optimized_graph;
 std::shared_ptr<Graph> lastExecutedOptimizedGraph() {
   return last_executed_optimized_graph.lock();
@@ -213,7 +222,8 @@ struct DifferentiableGraphBackward : public autograd::Node {
         input_instructions_(input_size) {}
 
   variable_list apply(variable_list&& inputs) override {
-    Stack stack;
+    PooledStack pooled_stack;
+    Stack& stack = *pooled_stack;
     stack.reserve(captures_.size() + inputs.size());
 
     input_instructions_.unpack(std::move(inputs), stack);
@@ -538,6 +548,7 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
     if (fallback) {
       state.fallback = fallback;
     }
+    std::lock_guard<std::mutex> lock(compile_mutex);
     for (auto& entry : plan_cache) {
       state.execution_plans.emplace(entry.first, entry.second);
     }
@@ -557,24 +568,47 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
     return fallback;
   }
 
-  const ExecutionPlan& getOrCompile(const Stack& stack) {
+  // Returns a copy of the plan, since another thread may evict it from the
+  // cache once the lock is released.
+  ExecutionPlan getOrCompile(const Stack& stack) {
     // outside lock guard, to minimize the time holding the lock on the fast
     // path ArgumentSpec even computes its hashCode here.
     ArgumentSpec spec =
         arg_spec_creator_.create(autograd::GradMode::is_enabled(), stack);
     {
       std::lock_guard<std::mutex> lock(compile_mutex);
-      auto it = plan_cache.find(spec);
-      if (it != plan_cache.end()) {
+      auto it = plan_cache_index.find(spec);
+      if (it != plan_cache_index.end()) {
         logging::getLogger()->addStatValue(
             logging::runtime_counters::EXECUTION_PLAN_CACHE_HIT, 1.0);
-        return it->second;
+        plan_cache.splice(plan_cache.begin(), plan_cache, it->second);
+        return it->second->second;
       }
+      auto start = logging::timePoint();
       auto plan = compileSpec(spec);
-      auto r = plan_cache.emplace(std::move(spec), std::move(plan));
+      logging::recordDurationSince(
+          logging::runtime_counters::EXECUTION_PLAN_COMPILATION_TIME, start);
       logging::getLogger()->addStatValue(
           logging::runtime_counters::EXECUTION_PLAN_CACHE_MISS, 1.0);
-      return r.first->second;
+      plan_cache.emplace_front(spec, std::move(plan));
+      plan_cache_index.emplace(std::move(spec), plan_cache.begin());
+      evictPlans();
+      return plan_cache.front().second;
+    }
+  }
+
+  // Drops the least recently used plans over the capacity of the cache.
+  // Must be called with compile_mutex held.
+  void evictPlans() {
+    size_t capacity = getExecutionPlanCacheCapacity();
+    if (capacity == 0) {
+      return;
+    }
+    while (plan_cache.size() > capacity) {
+      plan_cache_index.erase(plan_cache.back().first);
+      plan_cache.pop_back();
+      logging::getLogger()->addStatValue(
+          logging::runtime_counters::EXECUTION_PLAN_CACHE_EVICTION, 1.0);
     }
   }
 
@@ -636,6 +670,12 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
           autodiff_subgraph_inlining ? autodiffSubgraphInlineThreshold : 1);
     } else {
       runNondiffOptimization(opt_graph);
+      if (interOpParallelizationEnabled()) {
+        ParallelizeIndependentNodes(opt_graph);
+      }
+      if (memoryPlanningEnabled()) {
+        PlanMemory(opt_graph);
+      }
     }
     // Make sure there are no leftovers from any passes.
     EliminateDeadCode(opt_graph);
@@ -649,9 +689,13 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
   // unused). The compiled version of graph.
   ExecutionPlan fallback;
 
-  // Mapping from argument configurations to optimized versions of the graph
-  // that are specialized to the spec.
-  std::unordered_map<ArgumentSpec, ExecutionPlan> plan_cache;
+  // Optimized versions of the graph that are specialized to argument
+  // configurations, from the most to the least recently used, and their
+  // index by spec. At most getExecutionPlanCacheCapacity() plans are kept.
+  using PlanCacheEntry = std::pair<ArgumentSpec, ExecutionPlan>;
+  std::list<PlanCacheEntry> plan_cache;
+  std::unordered_map<ArgumentSpec, std::list<PlanCacheEntry>::iterator>
+      plan_cache_index;
 };
 
 GraphExecutor::GraphExecutor(
@@ -684,6 +728,13 @@ ExecutionPlan GraphExecutor::getPlanFor(
   return pImpl->getPlanFor(inputs, remaining_bailout_depth);
 }
 
+void GraphExecutor::precompile(const std::vector<Stack>& inputs) {
+  for (const Stack& stack : inputs) {
+    Stack copy = stack;
+    pImpl->getPlanFor(copy, getDefaultNumBailOuts());
+  }
+}
+
 std::shared_ptr<Graph> GraphExecutor::graph() const {
   return pImpl->graph;
 }
@@ -798,6 +849,10 @@ void runOptimization(std::shared_ptr<Graph>& graph, bool unroll) {
   ConstantPropagation(graph);
   ConstantPooling(graph);
 
+  // Hoist the code that computes the same values at every iteration out of
+  // the loops, so that it isn't copied by the unrolling.
+  LoopInvariantCodeMotion(graph);
+
   // Unroll small loops, and eliminate expressions that are the same at every
   // iteration.
   if (unroll) {
@@ -61,6 +61,10 @@ struct TORCH_API GraphExecutor {
   // `GraphExecutor` will be created. This new `GraphExecutor`'s
   // remaining_bailout_depth will be reduced by 1.
   ExecutionPlan getPlanFor(Stack& inputs, size_t remaining_bailout_depth);
+  // Compiles ahead of time the plans for the given input signatures, so that
+  // the first runs with them don't pay for it. The profiling executor only
+  // builds its profiling plan, as it specializes on the runs it records.
+  void precompile(const std::vector<Stack>& inputs);
   explicit operator bool() const {
     return pImpl != nullptr;
   }
@@ -87,6 +91,9 @@ TORCH_API std::atomic<bool>& getProfilingMode();
 TORCH_API std::atomic<bool>& getExecutorMode();
 TORCH_API std::atomic<size_t>& getNumProfiledRuns();
 TORCH_API std::atomic<size_t>& getBailoutDepth();
+// The maximum number of plans that the legacy executor keeps per graph, the
+// least recently used ones being evicted first. 0 means unbounded.
+TORCH_API std::atomic<size_t>& getExecutionPlanCacheCapacity();
 TORCH_API bool IsNewExecutorEnabled();
 
 struct TORCH_API GraphOptimizerEnabledGuard {
@@ -966,6 +966,14 @@ struct CodeImpl {
   }
 };
 
+struct InterpreterStateImpl;
+
+namespace {
+// The interpreter running on the current thread, see
+// currentInterpreterSourceLocation
+thread_local InterpreterStateImpl* current_interpreter = nullptr;
+} // namespace
+
 // InterpreterState state that and used to compute a Code
 struct InterpreterStateImpl : c10::intrusive_ptr_target {
   InterpreterStateImpl(const Code& code) {
@@ -1111,6 +1119,51 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
     *af = ActiveFrame(frames.back());
   }
 
+  // Sets current_interpreter while runImpl executes instructions, restoring
+  // the interpreter it may have been called from.
+  struct CurrentInterpreterGuard {
+    CurrentInterpreterGuard(InterpreterStateImpl* state, ActiveFrame* af)
+        : state_(state),
+          prev_(current_interpreter),
+          prev_frame_(state->active_frame_) {
+      current_interpreter = state;
+      state->active_frame_ = af;
+    }
+    ~CurrentInterpreterGuard() {
+      state_->active_frame_ = prev_frame_;
+      current_interpreter = prev_;
+    }
+
+   private:
+    InterpreterStateImpl* state_;
+    InterpreterStateImpl* prev_;
+    ActiveFrame* prev_frame_;
+  };
+
+  // The frame being executed by runImpl, if it is running
+  ActiveFrame* active_frame_ = nullptr;
+
+ public:
+  std::string currentSourceLocation() const {
+    if (!active_frame_ || frames.empty()) {
+      return "";
+    }
+    const auto& function = frames.back().function;
+    const auto& source = function->instructions_source_;
+    if (active_frame_->pc >= source.size()) {
+      return "";
+    }
+    auto file_line_col = source[active_frame_->pc]->sourceRange().file_line_col();
+    if (!file_line_col) {
+      return function->function_name_;
+    }
+    std::string file;
+    size_t line, col;
+    std::tie(file, line, col) = *file_line_col;
+    return file + ":" + c10::to_string(line);
+  }
+
+ private:
   bool runImpl(Stack& stack) {
     // if we have never run before, then we might have to return the
     // stack when we suspend, record where it starts so we return the right
@@ -1125,6 +1178,7 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
     }
 
     ActiveFrame af(frames.back());
+    CurrentInterpreterGuard current_guard(this, &af);
     try {
       while (true) {
         // std::cout << "RUNNING ";
@@ -1563,6 +1617,11 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
 
 std::atomic<size_t> InterpreterStateImpl::Frame::num_frames;
 
+std::string currentInterpreterSourceLocation() {
+  return current_interpreter ? current_interpreter->currentSourceLocation()
+                             : "";
+}
+
 std::ostream& operator<<(std::ostream& out, const Code& code) {
   out << *code.pImpl->graph_ << "\n";
   code.pImpl->dump(out);
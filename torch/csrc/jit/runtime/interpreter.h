@@ -120,6 +120,12 @@ struct InterpreterContinuation {
 #endif
 };
 
+// Returns "file:line" of the node that the interpreter is running on the
+// current thread (or the name of its function when the source has no file),
+// or an empty string when no TorchScript code is running. Used to attribute
+// profiling events to TorchScript source.
+TORCH_API std::string currentInterpreterSourceLocation();
+
 // what is the tensors type, including state from the current execution context
 // that modifies how the tensor behaves. For instance if no_grad is enabled
 // this will cause the TensorType to have requires_grad=False.
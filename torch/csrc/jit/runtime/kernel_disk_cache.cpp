@@ -0,0 +1,303 @@
+#include <torch/csrc/jit/runtime/kernel_disk_cache.h>
+
+#include <c10/util/Exception.h>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+constexpr size_t kDefaultMaxBytes = size_t(1) << 30;
+const char* const kEntryPrefix = "kernel-";
+const char* const kKeyExtension = "key";
+
+// 64-bit FNV-1a, in hex.
+std::string hashKey(const std::string& key) {
+  uint64_t hash = 14695981039346656037ull;
+  for (char c : key) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ull;
+  }
+  char hex[17];
+  snprintf(hex, sizeof(hex), "%016" PRIx64, hash);
+  return hex;
+}
+
+c10::optional<std::string> readFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return c10::nullopt;
+  }
+  std::stringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+#ifndef _WIN32
+bool makeDirectories(const std::string& path) {
+  size_t end = 0;
+  while (end != std::string::npos) {
+    end = path.find('/', end + 1);
+    std::string prefix = path.substr(0, end);
+    if (mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Writes the file through a temporary one renamed over it, so that other
+// processes never read it partially written.
+bool writeFileAtomically(
+    const std::string& directory,
+    const std::string& path,
+    const std::string& content) {
+  static std::atomic<size_t> next_id{0};
+  std::string temp_path = directory + "/.tmp-" + std::to_string(getpid()) +
+      "-" + std::to_string(next_id++);
+  std::ofstream file(temp_path, std::ios::binary);
+  file.write(content.data(), content.size());
+  file.close();
+  if (!file || rename(temp_path.c_str(), path.c_str()) != 0) {
+    unlink(temp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+// Calls `fn(name, path, stat)` for each file of the cache in `directory`.
+template <typename Fn>
+void forEachCacheFile(const std::string& directory, Fn fn) {
+  DIR* dir = opendir(directory.c_str());
+  if (!dir) {
+    return;
+  }
+  while (dirent* entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name.compare(0, strlen(kEntryPrefix), kEntryPrefix) != 0) {
+      continue;
+    }
+    std::string path = directory + "/" + name;
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+      fn(name, path, st);
+    }
+  }
+  closedir(dir);
+}
+#endif
+
+} // namespace
+
+KernelDiskCache::KernelDiskCache() : max_bytes_(kDefaultMaxBytes) {
+  if (const char* directory = std::getenv("PYTORCH_KERNEL_CACHE_DIR")) {
+    directory_ = directory;
+  }
+  if (const char* max_bytes = std::getenv("PYTORCH_KERNEL_CACHE_MAX_BYTES")) {
+    max_bytes_ = std::strtoull(max_bytes, nullptr, 10);
+  }
+}
+
+KernelDiskCache& KernelDiskCache::get() {
+  static KernelDiskCache cache;
+  return cache;
+}
+
+bool KernelDiskCache::enabled() const {
+#ifdef _WIN32
+  return false;
+#else
+  std::lock_guard<std::mutex> guard(mutex_);
+  return !directory_.empty();
+#endif
+}
+
+std::string KernelDiskCache::directory() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return directory_;
+}
+
+void KernelDiskCache::setDirectory(std::string directory) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  directory_ = std::move(directory);
+}
+
+size_t KernelDiskCache::maxBytes() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return max_bytes_;
+}
+
+void KernelDiskCache::setMaxBytes(size_t max_bytes) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  max_bytes_ = max_bytes;
+  evictLocked();
+}
+
+c10::optional<std::string> KernelDiskCache::lookup(
+    const std::string& key,
+    const std::string& extension) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return lookupLocked(key, extension);
+}
+
+c10::optional<std::string> KernelDiskCache::lookupLocked(
+    const std::string& key,
+    const std::string& extension) {
+#ifdef _WIN32
+  return c10::nullopt;
+#else
+  if (directory_.empty()) {
+    return c10::nullopt;
+  }
+  std::string base = directory_ + "/" + kEntryPrefix + hashKey(key);
+  std::string path = base + "." + extension;
+  auto stored_key = readFile(base + "." + kKeyExtension);
+  if (!stored_key || *stored_key != key || access(path.c_str(), R_OK) != 0) {
+    ++stats_.misses;
+    return c10::nullopt;
+  }
+  // Marks the entry as recently used.
+  utime(path.c_str(), nullptr);
+  ++stats_.hits;
+  return path;
+#endif
+}
+
+c10::optional<std::string> KernelDiskCache::load(
+    const std::string& key,
+    const std::string& extension) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto path = lookupLocked(key, extension);
+  if (!path) {
+    return c10::nullopt;
+  }
+  return readFile(*path);
+}
+
+c10::optional<std::string> KernelDiskCache::store(
+    const std::string& key,
+    const std::string& extension,
+    const std::string& content) {
+#ifdef _WIN32
+  return c10::nullopt;
+#else
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (directory_.empty()) {
+    return c10::nullopt;
+  }
+  std::string base = directory_ + "/" + kEntryPrefix + hashKey(key);
+  std::string path = base + "." + extension;
+  // The key is written last, so that an entry is only found once complete.
+  if (!makeDirectories(directory_) ||
+      !writeFileAtomically(directory_, path, content) ||
+      !writeFileAtomically(directory_, base + "." + kKeyExtension, key)) {
+    TORCH_WARN_ONCE(
+        "Failed to write to the kernel cache in ",
+        directory_,
+        ", compiled kernels won't be cached");
+    return c10::nullopt;
+  }
+  ++stats_.stores;
+  evictLocked();
+  return path;
+#endif
+}
+
+void KernelDiskCache::evictLocked() {
+#ifndef _WIN32
+  if (directory_.empty()) {
+    return;
+  }
+  struct Entry {
+    std::vector<std::string> paths;
+    size_t bytes = 0;
+    time_t last_used = 0;
+  };
+  std::unordered_map<std::string, Entry> entries;
+  size_t total_bytes = 0;
+  forEachCacheFile(
+      directory_,
+      [&](const std::string& name,
+          const std::string& path,
+          const struct stat& st) {
+        auto dot = name.find('.');
+        auto& entry = entries[name.substr(0, dot)];
+        entry.paths.push_back(path);
+        entry.bytes += st.st_size;
+        if (name.substr(dot + 1) != kKeyExtension) {
+          entry.last_used = std::max(entry.last_used, st.st_mtime);
+        }
+        total_bytes += st.st_size;
+      });
+  if (total_bytes <= max_bytes_) {
+    return;
+  }
+
+  std::vector<const Entry*> by_last_use;
+  for (const auto& entry : entries) {
+    by_last_use.push_back(&entry.second);
+  }
+  std::sort(
+      by_last_use.begin(),
+      by_last_use.end(),
+      [](const Entry* a, const Entry* b) {
+        return a->last_used < b->last_used;
+      });
+  for (const Entry* entry : by_last_use) {
+    if (total_bytes <= max_bytes_) {
+      break;
+    }
+    for (const auto& path : entry->paths) {
+      unlink(path.c_str());
+    }
+    total_bytes -= entry->bytes;
+    ++stats_.evictions;
+  }
+#endif
+}
+
+void KernelDiskCache::clear() {
+#ifndef _WIN32
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (directory_.empty()) {
+    return;
+  }
+  forEachCacheFile(
+      directory_,
+      [](const std::string& /*name*/,
+         const std::string& path,
+         const struct stat& /*st*/) { unlink(path.c_str()); });
+#endif
+}
+
+KernelDiskCache::Stats KernelDiskCache::stats() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return stats_;
+}
+
+void KernelDiskCache::resetStats() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  stats_ = Stats();
+}
+
+} // namespace jit
+} // namespace torch
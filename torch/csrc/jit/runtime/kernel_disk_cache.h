@@ -0,0 +1,84 @@
+#pragma once
+
+#include <c10/util/Optional.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+
+namespace torch {
+namespace jit {
+
+// An on-disk cache of compiled fusion kernels, shared by the processes that
+// use the same directory so that they don't compile the kernels of a model
+// again every time they start. It is used by the legacy CPU fuser (for the
+// shared libraries it builds with the system compiler) and by the tensorexpr
+// LLVM backend (for the object code of its kernels).
+//
+// An entry is addressed by a hash of its key, which holds everything the
+// compiled code depends on: the source or IR of the kernel, the target CPU
+// and the compiler and its version. The key is stored next to the entry and
+// compared on lookup, so a hash collision is just a miss. Entries are written
+// atomically, and the least recently used ones are removed when the cache
+// grows over its maximum size.
+//
+// The cache is disabled unless a directory is set, either with the
+// PYTORCH_KERNEL_CACHE_DIR environment variable or with setDirectory. Its
+// maximum size defaults to 1 GiB, or PYTORCH_KERNEL_CACHE_MAX_BYTES. It is
+// not supported on Windows.
+class TORCH_API KernelDiskCache {
+ public:
+  struct Stats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t stores = 0;
+    size_t evictions = 0;
+  };
+
+  static KernelDiskCache& get();
+
+  bool enabled() const;
+  std::string directory() const;
+  // An empty directory disables the cache.
+  void setDirectory(std::string directory);
+  size_t maxBytes() const;
+  void setMaxBytes(size_t max_bytes);
+
+  // The path of the file cached for `key`, if any.
+  c10::optional<std::string> lookup(
+      const std::string& key,
+      const std::string& extension);
+  // The content of the file cached for `key`, if any.
+  c10::optional<std::string> load(
+      const std::string& key,
+      const std::string& extension);
+  // Caches `content` for `key`, and returns the path of the cached file, or
+  // nothing if it couldn't be written.
+  c10::optional<std::string> store(
+      const std::string& key,
+      const std::string& extension,
+      const std::string& content);
+
+  // Removes all the entries.
+  void clear();
+
+  Stats stats() const;
+  void resetStats();
+
+ private:
+  KernelDiskCache();
+
+  c10::optional<std::string> lookupLocked(
+      const std::string& key,
+      const std::string& extension);
+  void evictLocked();
+
+  mutable std::mutex mutex_;
+  std::string directory_;
+  size_t max_bytes_;
+  Stats stats_;
+};
+
+} // namespace jit
+} // namespace torch
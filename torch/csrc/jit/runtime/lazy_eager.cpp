@@ -0,0 +1,736 @@
+#include <torch/csrc/jit/runtime/lazy_eager.h>
+
+#include <ATen/ATen.h>
+#include <ATen/ExpandUtils.h>
+#include <ATen/core/grad_mode.h>
+#include <ATen/record_function.h>
+#include <c10/core/impl/LocalDispatchKeySet.h>
+#include <c10/util/intrusive_ptr.h>
+#include <torch/csrc/jit/frontend/tracer.h>
+#include <torch/csrc/jit/ir/ir.h>
+#include <torch/csrc/jit/tensorexpr/kernel.h>
+#include <torch/library.h>
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+enum class LazyOp : uint8_t {
+  Add,
+  Sub,
+  Mul,
+  Div,
+  Neg,
+  Relu,
+  Sigmoid,
+  Tanh,
+  Exp,
+  Log,
+};
+
+Symbol opSymbol(LazyOp op) {
+  switch (op) {
+    case LazyOp::Add:
+      return aten::add;
+    case LazyOp::Sub:
+      return aten::sub;
+    case LazyOp::Mul:
+      return aten::mul;
+    case LazyOp::Div:
+      return aten::div;
+    case LazyOp::Neg:
+      return aten::neg;
+    case LazyOp::Relu:
+      return aten::relu;
+    case LazyOp::Sigmoid:
+      return aten::sigmoid;
+    case LazyOp::Tanh:
+      return aten::tanh;
+    case LazyOp::Exp:
+      return aten::exp;
+    case LazyOp::Log:
+      return aten::log;
+  }
+  TORCH_INTERNAL_ASSERT(false, "unknown lazy op");
+}
+
+bool hasAlpha(LazyOp op) {
+  return op == LazyOp::Add || op == LazyOp::Sub;
+}
+
+// An operand of a pending op: a tensor (pending or not), or a number passed
+// to the kernel as a float (a Python number operand, or alpha).
+struct Operand {
+  static Operand tensor(const at::Tensor& t) {
+    Operand operand;
+    operand.value = t;
+    operand.version = t.unsafeGetTensorImpl()->version_counter().current_version();
+    return operand;
+  }
+  static Operand scalar(double s) {
+    Operand operand;
+    operand.number = s;
+    return operand;
+  }
+
+  at::Tensor value;
+  double number = 0;
+  // Version of `value` when the op was recorded
+  uint32_t version = 0;
+};
+
+// Pending chains longer than this are materialized as they are recorded, to
+// bound the size of the kernels.
+constexpr size_t kMaxPendingOps = 64;
+
+class LazyTensorImpl : public c10::TensorImpl {
+ public:
+  LazyTensorImpl(LazyOp op, std::vector<Operand> operands, at::IntArrayRef sizes)
+      : TensorImpl(
+            c10::DispatchKeySet(c10::DispatchKey::CPU),
+            caffe2::TypeMeta::Make<float>(),
+            at::Device(at::kCPU)),
+        op_(op),
+        operands_(std::move(operands)) {
+    set_sizes_contiguous(sizes);
+    for (const auto& operand : operands_) {
+      if (auto lazy = pendingImpl(operand.value)) {
+        num_pending_ops_ += lazy->num_pending_ops_;
+      }
+    }
+  }
+
+  static LazyTensorImpl* pendingImpl(const at::Tensor& t) {
+    if (!t.defined()) {
+      return nullptr;
+    }
+    auto lazy = dynamic_cast<LazyTensorImpl*>(t.unsafeGetTensorImpl());
+    return lazy && lazy->pending_ ? lazy : nullptr;
+  }
+
+  bool pending() const {
+    return pending_;
+  }
+
+  size_t numPendingOps() const {
+    return num_pending_ops_;
+  }
+
+  LazyOp op() const {
+    return op_;
+  }
+
+  const std::vector<Operand>& operands() const {
+    return operands_;
+  }
+
+  // Computes this tensor, and the other pending tensors it depends on that
+  // are still referenced from outside the chain.
+  void materialize();
+
+  // Called on the outputs of a materialized chain.
+  void adopt(const at::Tensor& result) {
+    TORCH_INTERNAL_ASSERT(result.sizes() == sizes() && result.is_contiguous());
+    set_storage_keep_dtype(result.storage());
+    pending_ = false;
+    operands_.clear();
+  }
+
+  bool has_storage() const override {
+    const_cast<LazyTensorImpl*>(this)->materialize();
+    return TensorImpl::has_storage();
+  }
+
+  const at::Storage& storage() const override {
+    const_cast<LazyTensorImpl*>(this)->materialize();
+    return TensorImpl::storage();
+  }
+
+  // The shallow copies (e.g. `t.detach()`, `t.data`) are regular tensors
+  // that share the computed storage.
+  c10::intrusive_ptr<TensorImpl> shallow_copy_and_detach(
+      const c10::VariableVersion& version_counter,
+      bool allow_tensor_metadata_change) const override {
+    const_cast<LazyTensorImpl*>(this)->materialize();
+    return TensorImpl::shallow_copy_and_detach(
+        version_counter, allow_tensor_metadata_change);
+  }
+
+  // `t.data = other` replaces the value of this tensor, which the pending
+  // tensors that read it must not see.
+  void shallow_copy_from(const c10::intrusive_ptr<TensorImpl>& impl) override;
+
+  void release_resources() override {
+    TensorImpl::release_resources();
+    operands_.clear();
+  }
+
+ private:
+  LazyOp op_;
+  std::vector<Operand> operands_;
+  size_t num_pending_ops_ = 1;
+  bool pending_ = true;
+};
+
+// A pending chain, flattened in topological order.
+struct LazyProgram {
+  struct Instr {
+    LazyOp op;
+    // >= 0: result of an earlier instruction, < 0: input -1 - arg
+    std::vector<int64_t> args;
+    std::vector<int64_t> sizes;
+  };
+
+  explicit LazyProgram(LazyTensorImpl* root) {
+    std::unordered_map<LazyTensorImpl*, size_t> internal_uses;
+    visit(root, internal_uses);
+    // The intermediate results that are referenced from outside the chain
+    // have to be computed too. The root is held by the caller.
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      auto node = nodes[i];
+      if (node == root ||
+          c10::raw::intrusive_ptr::use_count(node) > internal_uses[node]) {
+        outputs.push_back(i);
+      }
+    }
+    signature = computeSignature();
+  }
+
+  int64_t visit(
+      LazyTensorImpl* node,
+      std::unordered_map<LazyTensorImpl*, size_t>& internal_uses) {
+    auto it = node_indices.find(node);
+    if (it != node_indices.end()) {
+      return it->second;
+    }
+    Instr instr;
+    instr.op = node->op();
+    for (const auto& operand : node->operands()) {
+      if (!operand.value.defined()) {
+        instr.args.push_back(addScalar(operand.number));
+      } else if (auto lazy = LazyTensorImpl::pendingImpl(operand.value)) {
+        ++internal_uses[lazy];
+        instr.args.push_back(visit(lazy, internal_uses));
+      } else {
+        instr.args.push_back(addTensor(operand));
+      }
+    }
+    instr.sizes = node->sizes().vec();
+    instrs.push_back(std::move(instr));
+    nodes.push_back(node);
+    node_indices[node] = instrs.size() - 1;
+    return instrs.size() - 1;
+  }
+
+  int64_t addTensor(const Operand& operand) {
+    auto impl = operand.value.unsafeGetTensorImpl();
+    TORCH_CHECK(
+        impl->version_counter().current_version() == operand.version,
+        "a tensor used by an op deferred in lazy eager mode was modified by an "
+        "inplace operation before the op was computed; materialize the results "
+        "of the op (e.g. by leaving torch.jit.lazy_eager()) before modifying it");
+    auto it = input_indices.find(impl);
+    if (it != input_indices.end()) {
+      return it->second;
+    }
+    inputs.emplace_back(operand.value);
+    input_indices[impl] = -static_cast<int64_t>(inputs.size());
+    return -static_cast<int64_t>(inputs.size());
+  }
+
+  int64_t addScalar(double s) {
+    inputs.emplace_back(s);
+    return -static_cast<int64_t>(inputs.size());
+  }
+
+  std::string computeSignature() const {
+    std::ostringstream ss;
+    for (const auto& input : inputs) {
+      if (input.isTensor()) {
+        const auto& t = input.toTensor();
+        ss << t.scalar_type() << t.sizes() << t.strides();
+      } else {
+        ss << 's';
+      }
+      ss << ';';
+    }
+    for (const auto& instr : instrs) {
+      ss << static_cast<int>(instr.op) << '(';
+      for (auto arg : instr.args) {
+        ss << arg << ',';
+      }
+      ss << ')';
+    }
+    for (auto output : outputs) {
+      ss << ';' << output;
+    }
+    return ss.str();
+  }
+
+  std::shared_ptr<Graph> buildGraph() const {
+    auto graph = std::make_shared<Graph>();
+    std::vector<Value*> input_values;
+    for (const auto& input : inputs) {
+      auto value = graph->addInput();
+      if (input.isTensor()) {
+        value->setType(TensorType::create(input.toTensor()));
+      } else {
+        value->setType(FloatType::get());
+      }
+      input_values.push_back(value);
+    }
+    std::vector<Value*> values;
+    for (const auto& instr : instrs) {
+      auto arg = [&](size_t i) {
+        auto index = instr.args.at(i);
+        return index >= 0 ? values[index] : input_values[-1 - index];
+      };
+      std::vector<NamedValue> args;
+      args.emplace_back(arg(0));
+      if (instr.args.size() > 1) {
+        args.emplace_back(arg(1));
+      }
+      std::vector<NamedValue> kwargs;
+      if (hasAlpha(instr.op)) {
+        kwargs.emplace_back("alpha", arg(2));
+      }
+      auto value = graph->insert(opSymbol(instr.op), args, kwargs);
+      value->setType(
+          TensorType::createContiguous(at::kFloat, at::kCPU, instr.sizes));
+      values.push_back(value);
+    }
+    for (auto output : outputs) {
+      graph->registerOutput(values[output]);
+    }
+    return graph;
+  }
+
+  // Runs the ops one by one, for builds without a fusing backend.
+  std::vector<at::Tensor> runUnfused() const {
+    std::vector<at::Tensor> values;
+    for (const auto& instr : instrs) {
+      auto arg = [&](size_t i) -> IValue {
+        auto index = instr.args.at(i);
+        return index >= 0 ? IValue(values[index]) : inputs[-1 - index];
+      };
+      auto binary = [&](at::Tensor (*tensor_fn)(const at::Tensor&, const at::Tensor&),
+                        at::Tensor (*scalar_fn)(const at::Tensor&, at::Scalar)) {
+        auto other = arg(1);
+        return other.isTensor()
+            ? tensor_fn(arg(0).toTensor(), other.toTensor())
+            : scalar_fn(arg(0).toTensor(), other.toDouble());
+      };
+      at::Tensor result;
+      switch (instr.op) {
+        case LazyOp::Add:
+        case LazyOp::Sub: {
+          auto self = arg(0).toTensor();
+          auto other = arg(1);
+          auto alpha = arg(2).toDouble();
+          if (instr.op == LazyOp::Add) {
+            result = other.isTensor() ? at::add(self, other.toTensor(), alpha)
+                                      : at::add(self, other.toDouble(), alpha);
+          } else {
+            result = other.isTensor() ? at::sub(self, other.toTensor(), alpha)
+                                      : at::sub(self, other.toDouble(), alpha);
+          }
+          break;
+        }
+        case LazyOp::Mul:
+          result = binary(at::mul, at::mul);
+          break;
+        case LazyOp::Div:
+          result = binary(at::div, at::div);
+          break;
+        case LazyOp::Neg:
+          result = at::neg(arg(0).toTensor());
+          break;
+        case LazyOp::Relu:
+          result = at::relu(arg(0).toTensor());
+          break;
+        case LazyOp::Sigmoid:
+          result = at::sigmoid(arg(0).toTensor());
+          break;
+        case LazyOp::Tanh:
+          result = at::tanh(arg(0).toTensor());
+          break;
+        case LazyOp::Exp:
+          result = at::exp(arg(0).toTensor());
+          break;
+        case LazyOp::Log:
+          result = at::log(arg(0).toTensor());
+          break;
+      }
+      values.push_back(result.contiguous());
+    }
+    std::vector<at::Tensor> results;
+    for (auto output : outputs) {
+      results.push_back(values[output]);
+    }
+    return results;
+  }
+
+  std::vector<IValue> inputs;
+  std::vector<Instr> instrs;
+  // The pending tensor computed by each instruction
+  std::vector<LazyTensorImpl*> nodes;
+  std::vector<size_t> outputs;
+  std::string signature;
+
+ private:
+  std::unordered_map<LazyTensorImpl*, int64_t> node_indices;
+  std::unordered_map<c10::TensorImpl*, int64_t> input_indices;
+};
+
+// When full, the cache is cleared rather than evicting, so that programs
+// that keep generating new shapes don't make every lookup pay for it.
+constexpr size_t kMaxCachedKernels = 256;
+
+struct KernelCache {
+  std::mutex mutex;
+  std::unordered_map<std::string, std::shared_ptr<tensorexpr::TensorExprKernel>>
+      kernels;
+};
+
+KernelCache& kernelCache() {
+  static KernelCache cache;
+  return cache;
+}
+
+#ifdef TORCH_ENABLE_LLVM
+std::shared_ptr<tensorexpr::TensorExprKernel> getKernel(
+    const LazyProgram& program) {
+  auto& cache = kernelCache();
+  {
+    std::lock_guard<std::mutex> guard(cache.mutex);
+    auto it = cache.kernels.find(program.signature);
+    if (it != cache.kernels.end()) {
+      return it->second;
+    }
+  }
+  // Compile outside of the lock, another thread may compile the same kernel
+  // in the meantime.
+  auto kernel =
+      std::make_shared<tensorexpr::TensorExprKernel>(program.buildGraph());
+  std::lock_guard<std::mutex> guard(cache.mutex);
+  if (cache.kernels.size() >= kMaxCachedKernels) {
+    cache.kernels.clear();
+  }
+  cache.kernels.emplace(program.signature, kernel);
+  return kernel;
+}
+#endif
+
+void LazyTensorImpl::materialize() {
+  if (!pending_) {
+    return;
+  }
+  RECORD_FUNCTION("lazy_eager::materialize", std::vector<c10::IValue>());
+  c10::impl::ExcludeDispatchKeyGuard no_lazy(c10::DispatchKey::Lazy);
+  LazyProgram program(this);
+  std::vector<at::Tensor> results;
+#ifdef TORCH_ENABLE_LLVM
+  auto kernel = getKernel(program);
+  Stack stack(program.inputs.begin(), program.inputs.end());
+  kernel->run(stack);
+  for (auto& result : stack) {
+    results.push_back(std::move(result).toTensor());
+  }
+#else
+  results = program.runUnfused();
+#endif
+  TORCH_INTERNAL_ASSERT(results.size() == program.outputs.size());
+  // The other outputs are adopted first, the root holds the references that
+  // keep the rest of the chain alive.
+  for (size_t i = 0; i < results.size(); ++i) {
+    auto node = program.nodes[program.outputs[i]];
+    if (node != this) {
+      node->adopt(results[i]);
+    }
+  }
+  for (size_t i = 0; i < results.size(); ++i) {
+    if (program.nodes[program.outputs[i]] == this) {
+      adopt(results[i]);
+    }
+  }
+}
+
+void materializeIfPending(c10::TensorImpl* impl) {
+  if (auto lazy = dynamic_cast<LazyTensorImpl*>(impl)) {
+    lazy->materialize();
+  }
+}
+
+using WeakTensorImplPtr =
+    c10::weak_intrusive_ptr<c10::TensorImpl, c10::UndefinedTensorImpl>;
+
+struct LazyEagerState {
+  size_t depth = 0;
+  // The RecordFunction callback that flushes the pending tensors before
+  // inplace ops, and whether RecordFunction was enabled before it was added.
+  at::CallbackHandle mutation_callback = 0;
+  bool record_function_was_enabled = false;
+  // The pending tensors created by this thread, in creation order.
+  std::vector<WeakTensorImplPtr> pending;
+  // Size of `pending` after it was last pruned
+  size_t pruned_size = 0;
+};
+
+LazyEagerState& localState() {
+  thread_local LazyEagerState state;
+  return state;
+}
+
+bool isPending(const WeakTensorImplPtr& weak) {
+  auto impl = weak.lock();
+  return impl && static_cast<LazyTensorImpl*>(impl.get())->pending();
+}
+
+void registerPending(const at::Tensor& t) {
+  auto& state = localState();
+  auto& pending = state.pending;
+  if (pending.size() >= 2 * state.pruned_size + 64) {
+    pending.erase(
+        std::remove_if(
+            pending.begin(),
+            pending.end(),
+            [](const WeakTensorImplPtr& weak) { return !isPending(weak); }),
+        pending.end());
+    state.pruned_size = pending.size();
+  }
+  pending.emplace_back(t.getIntrusivePtr());
+}
+
+void LazyTensorImpl::shallow_copy_from(
+    const c10::intrusive_ptr<TensorImpl>& impl) {
+  lazyEagerFlush();
+  materialize();
+  materializeIfPending(impl.get());
+  TensorImpl::shallow_copy_from(impl);
+}
+
+// Whether an op of this name (the unoverloaded name RecordFunction gets, e.g.
+// "add_" or "add_out") can write to its arguments: the inplace and out= ops,
+// and set_data, which doesn't go through shallow_copy_from when the
+// destination isn't pending.
+bool isMutatingOpName(const char* name) {
+  size_t len = std::strlen(name);
+  return (len > 1 && name[len - 1] == '_') ||
+      (len > 4 && std::strcmp(name + len - 4, "_out") == 0) ||
+      std::strcmp(name, "set_data") == 0;
+}
+
+// The pending ops still read the current values of the tensors they were
+// given, so before an op that may write to one of them (or to a view of it),
+// they are all computed.
+void flushBeforeMutation(const at::RecordFunction& fn) {
+  if (localState().depth > 0 && isMutatingOpName(fn.name().str())) {
+    lazyEagerFlush();
+  }
+}
+
+// Whether `t` can be an operand of a pending op. Tensors that need autograd
+// run eagerly, so that their graph is recorded as usual.
+bool canDefer(const at::Tensor& t) {
+  return t.defined() &&
+      t.unsafeGetTensorImpl()->key_set() ==
+      c10::DispatchKeySet(c10::DispatchKey::CPU) &&
+      t.scalar_type() == at::kFloat && !t.is_wrapped_number() &&
+      !(t.requires_grad() && at::GradMode::is_enabled());
+}
+
+// A Python number operand of a binary op
+bool isNumber(const at::Tensor& t) {
+  return t.defined() && t.is_wrapped_number() &&
+      (at::isFloatingType(t.scalar_type()) ||
+       at::isIntegralType(t.scalar_type(), /*includeBool=*/false));
+}
+
+bool deferEnabled() {
+  return !tracer::isTracing();
+}
+
+at::Tensor makePending(
+    LazyOp op,
+    std::vector<Operand> operands,
+    at::IntArrayRef sizes) {
+  auto t = at::detail::make_tensor<LazyTensorImpl>(op, std::move(operands), sizes);
+  auto impl = static_cast<LazyTensorImpl*>(t.unsafeGetTensorImpl());
+  if (impl->numPendingOps() > kMaxPendingOps) {
+    impl->materialize();
+  } else {
+    registerPending(t);
+  }
+  return t;
+}
+
+c10::optional<at::Tensor> deferBinary(
+    LazyOp op,
+    const at::Tensor& self,
+    const at::Tensor& other,
+    c10::optional<at::Scalar> alpha = c10::nullopt) {
+  if (!deferEnabled() || !canDefer(self) ||
+      (alpha && alpha->isComplex())) {
+    return c10::nullopt;
+  }
+  std::vector<Operand> operands{Operand::tensor(self)};
+  std::vector<int64_t> sizes;
+  if (isNumber(other)) {
+    operands.push_back(Operand::scalar(other.item<double>()));
+    sizes = self.sizes().vec();
+  } else if (canDefer(other)) {
+    operands.push_back(Operand::tensor(other));
+    sizes = at::infer_size(self.sizes(), other.sizes());
+  } else {
+    return c10::nullopt;
+  }
+  if (alpha) {
+    operands.push_back(Operand::scalar(alpha->to<double>()));
+  }
+  return makePending(op, std::move(operands), sizes);
+}
+
+c10::optional<at::Tensor> deferUnary(LazyOp op, const at::Tensor& self) {
+  if (!deferEnabled() || !canDefer(self)) {
+    return c10::nullopt;
+  }
+  return makePending(op, {Operand::tensor(self)}, self.sizes());
+}
+
+at::Tensor lazy_add_Tensor(const at::Tensor& self, const at::Tensor& other, at::Scalar alpha) {
+  if (auto result = deferBinary(LazyOp::Add, self, other, alpha)) {
+    return *result;
+  }
+  c10::impl::ExcludeDispatchKeyGuard no_lazy(c10::DispatchKey::Lazy);
+  return at::add(self, other, alpha);
+}
+
+at::Tensor lazy_sub_Tensor(const at::Tensor& self, const at::Tensor& other, at::Scalar alpha) {
+  if (auto result = deferBinary(LazyOp::Sub, self, other, alpha)) {
+    return *result;
+  }
+  c10::impl::ExcludeDispatchKeyGuard no_lazy(c10::DispatchKey::Lazy);
+  return at::sub(self, other, alpha);
+}
+
+at::Tensor lazy_mul_Tensor(const at::Tensor& self, const at::Tensor& other) {
+  if (auto result = deferBinary(LazyOp::Mul, self, other)) {
+    return *result;
+  }
+  c10::impl::ExcludeDispatchKeyGuard no_lazy(c10::DispatchKey::Lazy);
+  return at::mul(self, other);
+}
+
+at::Tensor lazy_div_Tensor(const at::Tensor& self, const at::Tensor& other) {
+  if (auto result = deferBinary(LazyOp::Div, self, other)) {
+    return *result;
+  }
+  c10::impl::ExcludeDispatchKeyGuard no_lazy(c10::DispatchKey::Lazy);
+  return at::div(self, other);
+}
+
+#define DEFINE_LAZY_UNARY(name, lazy_op)                                \
+  at::Tensor lazy_##name(const at::Tensor& self) {                      \
+    if (auto result = deferUnary(LazyOp::lazy_op, self)) {              \
+      return *result;                                                   \
+    }                                                                   \
+    c10::impl::ExcludeDispatchKeyGuard no_lazy(c10::DispatchKey::Lazy); \
+    return at::name(self);                                              \
+  }
+
+DEFINE_LAZY_UNARY(neg, Neg)
+DEFINE_LAZY_UNARY(relu, Relu)
+DEFINE_LAZY_UNARY(sigmoid, Sigmoid)
+DEFINE_LAZY_UNARY(tanh, Tanh)
+DEFINE_LAZY_UNARY(exp, Exp)
+DEFINE_LAZY_UNARY(log, Log)
+
+#undef DEFINE_LAZY_UNARY
+
+// Ops without a Lazy kernel run eagerly, materializing the pending tensors
+// they read. This can't be a boxed fallback that materializes the arguments:
+// boxed kernels can't be called for ops that return references, like the
+// inplace ones.
+TORCH_LIBRARY_IMPL(_, Lazy, m) {
+  m.fallback(torch::CppFunction::makeFallthrough());
+}
+
+TORCH_LIBRARY_IMPL(aten, Lazy, m) {
+  m.impl("add.Tensor", lazy_add_Tensor);
+  m.impl("sub.Tensor", lazy_sub_Tensor);
+  m.impl("mul.Tensor", lazy_mul_Tensor);
+  m.impl("div.Tensor", lazy_div_Tensor);
+  m.impl("neg", lazy_neg);
+  m.impl("relu", lazy_relu);
+  m.impl("sigmoid", lazy_sigmoid);
+  m.impl("tanh", lazy_tanh);
+  m.impl("exp", lazy_exp);
+  m.impl("log", lazy_log);
+}
+
+} // namespace
+
+void enterLazyEagerMode() {
+  auto& state = localState();
+  if (state.depth++ == 0) {
+    c10::impl::tls_set_dispatch_key_included(c10::DispatchKey::Lazy, true);
+    // The ops without a Lazy kernel fall through to the Profiler key, whose
+    // kernels run the RecordFunction callbacks before the op does.
+    state.mutation_callback = at::addThreadLocalCallback(
+        at::RecordFunctionCallback(flushBeforeMutation)
+            .scopes({at::RecordScope::FUNCTION}));
+    state.record_function_was_enabled = at::isRecordFunctionEnabled();
+    at::enableRecordFunction(true);
+  }
+}
+
+void exitLazyEagerMode() {
+  auto& state = localState();
+  TORCH_CHECK(state.depth > 0, "lazy eager mode is not enabled");
+  if (--state.depth == 0) {
+    c10::impl::tls_set_dispatch_key_included(c10::DispatchKey::Lazy, false);
+    at::removeCallback(state.mutation_callback);
+    at::enableRecordFunction(state.record_function_was_enabled);
+    lazyEagerFlush();
+  }
+}
+
+bool lazyEagerModeEnabled() {
+  return localState().depth > 0;
+}
+
+void lazyEagerFlush() {
+  auto& state = localState();
+  auto pending = std::move(state.pending);
+  state.pending.clear();
+  state.pruned_size = 0;
+  // Latest first: its chain covers the most ops, and the earlier tensors
+  // still referenced are computed along with it.
+  for (auto it = pending.rbegin(); it != pending.rend(); ++it) {
+    if (auto impl = it->lock()) {
+      static_cast<LazyTensorImpl*>(impl.get())->materialize();
+    }
+  }
+}
+
+size_t lazyEagerKernelCacheSize() {
+  auto& cache = kernelCache();
+  std::lock_guard<std::mutex> guard(cache.mutex);
+  return cache.kernels.size();
+}
+
+void lazyEagerClearKernelCache() {
+  auto& cache = kernelCache();
+  std::lock_guard<std::mutex> guard(cache.mutex);
+  cache.kernels.clear();
+}
+
+} // namespace jit
+} // namespace torch
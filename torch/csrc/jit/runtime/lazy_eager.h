@@ -0,0 +1,41 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <cstddef>
+
+namespace torch {
+namespace jit {
+
+// Lazy eager mode defers the pointwise ops of eager code so that chains like
+// `(x * a + b).relu()` run as a single fused tensorexpr kernel instead of one
+// pass over memory per op.
+//
+// While the mode is enabled on a thread, the DispatchKey::Lazy kernels of
+// add, sub, mul, div, neg, relu, sigmoid, tanh, exp and log return tensors
+// whose values are not computed yet, as long as their operands are float CPU
+// tensors that don't need autograd (any other call runs eagerly). A pending
+// tensor is materialized with all the pending ops it depends on the first
+// time its data is accessed, or when the mode is exited. The kernels are
+// compiled with the tensorexpr LLVM backend and cached by the ops and the
+// dtypes, sizes and strides of their inputs; without LLVM, the recorded ops
+// are run one by one.
+//
+// The pending tensors of the thread are materialized before any inplace or
+// out= op runs, so that the ops they defer see the values their operands had
+// when they were called. Modifying an operand some other way while an op
+// that reads it is pending is an error, reported when the op is
+// materialized.
+TORCH_API void enterLazyEagerMode();
+// Materializes the pending tensors of the thread when the outermost mode is
+// exited.
+TORCH_API void exitLazyEagerMode();
+TORCH_API bool lazyEagerModeEnabled();
+// Materializes the pending tensors of the current thread.
+TORCH_API void lazyEagerFlush();
+
+TORCH_API size_t lazyEagerKernelCacheSize();
+TORCH_API void lazyEagerClearKernelCache();
+
+} // namespace jit
+} // namespace torch
@@ -72,12 +72,19 @@ constexpr const char* EXECUTION_PLAN_CACHE_HIT =
     "pytorch_runtime.execution_plan_cache_hit";
 constexpr const char* EXECUTION_PLAN_CACHE_MISS =
     "pytorch_runtime.execution_plan_cache_miss";
+constexpr const char* EXECUTION_PLAN_CACHE_EVICTION =
+    "pytorch_runtime.execution_plan_cache_eviction";
+// The time spent compiling the plans of the cache misses, in nanoseconds.
+constexpr const char* EXECUTION_PLAN_COMPILATION_TIME =
+    "pytorch_runtime.execution_plan_compilation_time";
 
 inline std::vector<const char*> allRuntimeCounters() {
   return {GRAPH_EXECUTORS_CONSTRUCTED,
           GRAPH_EXECUTOR_INVOCATIONS,
           EXECUTION_PLAN_CACHE_HIT,
-          EXECUTION_PLAN_CACHE_MISS};
+          EXECUTION_PLAN_CACHE_MISS,
+          EXECUTION_PLAN_CACHE_EVICTION,
+          EXECUTION_PLAN_COMPILATION_TIME};
 }
 
 } // namespace runtime_counters
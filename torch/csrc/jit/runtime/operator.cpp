@@ -213,6 +213,7 @@ bool printerHasSpecialCaseFor(Symbol sym) {
       prim::Load, // used in interpreter only
       prim::MMTreeReduce, // used as an optimization
       prim::MMBatchSide, // used as an optimization
+      prim::MMBatchIndependent, // used as an optimization
       prim::Store, // used in interpreter only
       prim::profile, // used in interpreter only
 
@@ -253,6 +254,7 @@ bool aliasAnalysisHasSpecialCaseFor(Symbol symbol) {
       prim::GradOf,
       prim::MMTreeReduce,
       prim::MMBatchSide,
+      prim::MMBatchIndependent,
       prim::BroadcastSizes,
       prim::ChunkSizes,
       prim::Function,
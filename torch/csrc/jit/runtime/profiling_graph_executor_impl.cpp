@@ -18,11 +18,14 @@
 #include <torch/csrc/jit/passes/loop_unrolling.h>
 #include <torch/csrc/jit/passes/lower_grad_of.h>
 #include <torch/csrc/jit/passes/lower_tuples.h>
+#include <torch/csrc/jit/passes/memory_planning.h>
+#include <torch/csrc/jit/passes/parallelize_independent_nodes.h>
 #include <torch/csrc/jit/passes/peephole.h>
 #include <torch/csrc/jit/passes/remove_expands.h>
 #include <torch/csrc/jit/passes/requires_grad_analysis.h>
 #include <torch/csrc/jit/passes/shape_analysis.h>
 #include <torch/csrc/jit/passes/specialize_autogradzero.h>
+#include <torch/csrc/jit/passes/tensorexpr_fuser.h>
 
 C10_DECLARE_bool();
 
@@ -88,6 +91,9 @@ void ProfilingGraphExecutorImpl::runProfilingOptimizations(
   }
 
   InsertGuards(copy);
+  if (tensorExprFuserEnabled() && tensorExprDynamicShapesEnabled()) {
+    MakeGuardShapesSymbolic(copy);
+  }
   LowerGradOf(*copy);
   EliminateRedundantGuards(copy);
   InsertBailOuts(copy);
@@ -117,6 +123,12 @@ void ProfilingGraphExecutorImpl::runProfilingOptimizations(
 
   } else {
     runNondiffOptimization(copy, true);
+    if (interOpParallelizationEnabled()) {
+      ParallelizeIndependentNodes(copy);
+    }
+    if (memoryPlanningEnabled()) {
+      PlanMemory(copy);
+    }
   }
   EliminateDeadCode(copy);
   GRAPH_DUMP("Optimized Graph : ", copy);
@@ -213,7 +213,7 @@ RegisterOperators reg(
      Operator(
          "prim::device(Tensor a) -> Device",
          [](Stack& stack) {
-           push(stack, pop(stack).toTensor().device());
+           push(stack, pop_tensor(stack).device());
            return 0;
          },
          aliasAnalysisFromSchema()),
@@ -254,7 +254,7 @@ RegisterOperators reg(
      Operator(
          "aten::element_size(Tensor self) -> int",
          [](Stack& stack) {
-           at::Tensor arg = pop(stack).toTensor();
+           at::Tensor arg = pop_tensor(stack);
            push(stack, arg.element_size());
            return 0;
          },
@@ -262,7 +262,7 @@ RegisterOperators reg(
      Operator(
          "aten::numel(Tensor self) -> int",
          [](Stack& stack) {
-           at::Tensor arg = pop(stack).toTensor();
+           at::Tensor arg = pop_tensor(stack);
            push(stack, arg.numel());
            return 0;
          },
@@ -270,7 +270,7 @@ RegisterOperators reg(
      Operator(
          "aten::dim(Tensor self) -> int",
          [](Stack& stack) {
-           at::Tensor arg = pop(stack).toTensor();
+           at::Tensor arg = pop_tensor(stack);
            push(stack, arg.dim());
            return 0;
          },
@@ -507,7 +507,7 @@ RegisterOperators reg(
      Operator(
          "aten::len.Tensor(Tensor t) -> int",
          [](Stack& stack) {
-           at::Tensor t = pop(stack).toTensor();
+           at::Tensor t = pop_tensor(stack);
            if (t.dim() == 0) {
              AT_ERROR("len() of a 0-d tensor");
            }
@@ -524,7 +524,7 @@ RegisterOperators reg(
          "aten::index.Tensor_hacked_twin(Tensor self, Tensor[] indices) -> Tensor",
          [](Stack& stack) {
            auto indices = pop(stack).toTensorVector();
-           auto self = pop(stack).toTensor();
+           auto self = pop_tensor(stack);
            auto result = at::index(self, indices);
            push(stack, std::move(result));
            return 0;
@@ -535,9 +535,9 @@ RegisterOperators reg(
          [](Stack& stack) {
            auto unsafe = pop(stack).toBool();
            auto accumulate = pop(stack).toBool();
-           auto values = pop(stack).toTensor();
+           auto values = pop_tensor(stack);
            auto indices = pop(stack).toTensorVector();
-           auto self = pop(stack).toTensor();
+           auto self = pop_tensor(stack);
            auto result =
                at::_index_put_impl_(self, indices, values, accumulate, unsafe);
            push(stack, std::move(result));
@@ -548,9 +548,9 @@ RegisterOperators reg(
          "aten::index_put_.hacked_twin(Tensor(a!) self, Tensor[] indices, Tensor values, bool accumulate=False) -> Tensor(a!)",
          [](Stack& stack) {
            auto accumulate = pop(stack).toBool();
-           auto values = pop(stack).toTensor();
+           auto values = pop_tensor(stack);
            auto indices = pop(stack).toTensorVector();
-           auto self = pop(stack).toTensor();
+           auto self = pop_tensor(stack);
            auto result = at::index_put_(self, indices, values, accumulate);
            push(stack, std::move(result));
            return 0;
@@ -560,9 +560,9 @@ RegisterOperators reg(
          "aten::index_put.hacked_twin(Tensor self, Tensor[] indices, Tensor values, bool accumulate=False) -> Tensor",
          [](Stack& stack) {
            auto accumulate = pop(stack).toBool();
-           auto values = pop(stack).toTensor();
+           auto values = pop_tensor(stack);
            auto indices = pop(stack).toTensorVector();
-           auto self = pop(stack).toTensor();
+           auto self = pop_tensor(stack);
            auto result = at::index_put_(self, indices, values, accumulate);
            push(stack, std::move(result));
            return 0;
@@ -579,7 +579,7 @@ RegisterOperators reg(
                pop(stack).toOptional<at::ScalarType>();
            c10::optional<c10::Device> device =
                pop(stack).toOptional<c10::Device>();
-           at::Tensor self = pop(stack).toTensor();
+           at::Tensor self = pop_tensor(stack);
            push(
                stack,
                to_dispatch(self, device, scalarType, non_blocking, copy));
@@ -595,7 +595,7 @@ RegisterOperators reg(
            c10::optional<at::ScalarType> scalarType =
                pop(stack).toOptional<at::ScalarType>();
            c10::optional<c10::Device> device = c10::nullopt;
-           at::Tensor self = pop(stack).toTensor();
+           at::Tensor self = pop_tensor(stack);
            push(
                stack,
                to_dispatch(self, device, scalarType, non_blocking, copy));
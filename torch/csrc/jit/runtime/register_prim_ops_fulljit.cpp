@@ -147,7 +147,7 @@ RegisterOperators reg(
            at::Tensor gradient = gradient_ivalue.isNone()
                ? at::Tensor()
                : gradient_ivalue.toTensor();
-           at::Tensor self = pop(stack).toTensor();
+           at::Tensor self = pop_tensor(stack);
            bool keep_graph = retain_graph ? retain_graph.value() : create_graph;
            self.backward(gradient, keep_graph, create_graph);
            return 0;
@@ -365,7 +365,7 @@ RegisterOperators reg(
          "aten::requires_grad_(Tensor(a!) self, bool requires_grad=True) -> Tensor(a!)",
          [](Stack& stack) {
            bool _requires_grad = pop(stack).toBool();
-           at::Tensor self = pop(stack).toTensor();
+           at::Tensor self = pop_tensor(stack);
            self.requires_grad_(_requires_grad);
            return 0;
          },
@@ -446,7 +446,7 @@ RegisterOperators reg(
      Operator(
          "onnx::Shape(Tensor t) -> Tensor",
          [](Stack& stack) {
-           auto t = pop(stack).toTensor();
+           auto t = pop_tensor(stack);
            at::IntArrayRef sizes = t.sizes();
            auto sizes_tensor = torch::empty(
                {static_cast<int64_t>(sizes.size())}, at::dtype(at::kLong));
@@ -335,7 +335,7 @@ RegisterOperators reg({
         [](Stack& stack) {
           auto device = pop(stack).toOptional<c10::Device>();
           auto dtype = pop(stack).toOptional<at::ScalarType>();
-          at::Tensor data = pop(stack).toTensor();
+          at::Tensor data = pop_tensor(stack);
           at::ScalarType scalar_type =
               dtype ? dtype.value() : data.scalar_type();
           c10::Device dev = device ? device.value() : data.device();
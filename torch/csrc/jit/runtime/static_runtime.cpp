@@ -0,0 +1,320 @@
+#include <torch/csrc/jit/runtime/static_runtime.h>
+
+#include <ATen/ATen.h>
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/constant_propagation.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/freeze_module.h>
+#include <torch/csrc/jit/passes/inliner.h>
+#include <torch/csrc/jit/runtime/vararg_functions.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+using Registers = std::vector<IValue>;
+
+void runAdd(ProcessedNode& n, Registers& reg) {
+  auto self = n.input(reg, 0).toTensor();
+  auto other = n.input(reg, 1).toTensor();
+  auto& out = n.output(self.options().dtype(at::result_type(self, other)));
+  at::add_out(out, self, other, n.input(reg, 2).toScalar());
+}
+
+void runSub(ProcessedNode& n, Registers& reg) {
+  auto self = n.input(reg, 0).toTensor();
+  auto other = n.input(reg, 1).toTensor();
+  auto& out = n.output(self.options().dtype(at::result_type(self, other)));
+  at::sub_out(out, self, other, n.input(reg, 2).toScalar());
+}
+
+void runMul(ProcessedNode& n, Registers& reg) {
+  auto self = n.input(reg, 0).toTensor();
+  auto other = n.input(reg, 1).toTensor();
+  auto& out = n.output(self.options().dtype(at::result_type(self, other)));
+  at::mul_out(out, self, other);
+}
+
+void runDiv(ProcessedNode& n, Registers& reg) {
+  auto self = n.input(reg, 0).toTensor();
+  auto other = n.input(reg, 1).toTensor();
+  auto& out = n.output(self.options().dtype(at::result_type(self, other)));
+  at::div_out(out, self, other);
+}
+
+void runMm(ProcessedNode& n, Registers& reg) {
+  auto self = n.input(reg, 0).toTensor();
+  at::mm_out(n.output(self.options()), self, n.input(reg, 1).toTensor());
+}
+
+void runBmm(ProcessedNode& n, Registers& reg) {
+  auto self = n.input(reg, 0).toTensor();
+  at::bmm_out(n.output(self.options()), self, n.input(reg, 1).toTensor());
+}
+
+void runAddmm(ProcessedNode& n, Registers& reg) {
+  auto mat1 = n.input(reg, 1).toTensor();
+  at::addmm_out(
+      n.output(mat1.options()),
+      n.input(reg, 0).toTensor(),
+      mat1,
+      n.input(reg, 2).toTensor(),
+      n.input(reg, 3).toScalar(),
+      n.input(reg, 4).toScalar());
+}
+
+void runRelu(ProcessedNode& n, Registers& reg) {
+  auto self = n.input(reg, 0).toTensor();
+  at::threshold_out(n.output(self.options()), self, 0, 0);
+}
+
+void runSigmoid(ProcessedNode& n, Registers& reg) {
+  auto self = n.input(reg, 0).toTensor();
+  at::sigmoid_out(n.output(self.options()), self);
+}
+
+void runTanh(ProcessedNode& n, Registers& reg) {
+  auto self = n.input(reg, 0).toTensor();
+  at::tanh_out(n.output(self.options()), self);
+}
+
+const std::vector<std::pair<const char*, ProcessedNode::OutVariant>>&
+outVariants() {
+  static const std::vector<std::pair<const char*, ProcessedNode::OutVariant>>
+      out_variants = {
+          {"aten::add.Tensor(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor",
+           runAdd},
+          {"aten::sub.Tensor(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor",
+           runSub},
+          {"aten::mul.Tensor(Tensor self, Tensor other) -> Tensor", runMul},
+          {"aten::div.Tensor(Tensor self, Tensor other) -> Tensor", runDiv},
+          {"aten::mm(Tensor self, Tensor mat2) -> Tensor", runMm},
+          {"aten::bmm(Tensor self, Tensor mat2) -> Tensor", runBmm},
+          {"aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta=1, Scalar alpha=1) -> Tensor",
+           runAddmm},
+          {"aten::relu(Tensor self) -> Tensor", runRelu},
+          {"aten::sigmoid(Tensor self) -> Tensor", runSigmoid},
+          {"aten::tanh(Tensor self) -> Tensor", runTanh},
+      };
+  return out_variants;
+}
+
+// The boxed operation of a node, including the ones the interpreter
+// implements as instructions rather than operators.
+Operation boxedOperation(Node* node) {
+  size_t num_inputs = node->inputs().size();
+  switch (node->kind()) {
+    case prim::ListConstruct: {
+      auto type = node->output()->type()->expect<ListType>();
+      return [type, num_inputs](Stack& stack) {
+        listConstruct(stack, type, num_inputs);
+        return 0;
+      };
+    }
+    case prim::ListUnpack: {
+      size_t num_outputs = node->outputs().size();
+      return [num_outputs](Stack& stack) {
+        listUnpack(stack, num_outputs);
+        return 0;
+      };
+    }
+    case prim::TupleConstruct: {
+      auto type = node->output()->type()->expect<TupleType>();
+      if (type->name()) {
+        return [type, num_inputs](Stack& stack) {
+          namedTupleConstruct(stack, type, num_inputs);
+          return 0;
+        };
+      }
+      return [num_inputs](Stack& stack) {
+        tupleConstruct(stack, num_inputs);
+        return 0;
+      };
+    }
+    case prim::DictConstruct: {
+      auto type = node->output()->type()->expect<DictType>();
+      return [type, num_inputs](Stack& stack) {
+        dictConstruct(stack, type, num_inputs);
+        return 0;
+      };
+    }
+    default:
+      break;
+  }
+  TORCH_CHECK(
+      node->maybeOperator(),
+      "StaticRuntime doesn't support ",
+      node->kind().toQualString());
+  return node->getOperation();
+}
+
+std::shared_ptr<Graph> prepareGraph(const std::shared_ptr<Graph>& graph) {
+  auto copy = graph->copy();
+  Inline(*copy);
+  ConstantPropagation(copy);
+  EliminateDeadCode(copy);
+  for (Value* input : copy->inputs()) {
+    TORCH_CHECK(
+        input->type()->isSubtypeOf(TensorType::get()),
+        "StaticRuntime only supports tensor inputs, got ",
+        input->type()->python_str());
+  }
+  for (Node* node : copy->nodes()) {
+    TORCH_CHECK(
+        node->blocks().empty(),
+        "StaticRuntime doesn't support control flow, found ",
+        node->kind().toQualString());
+  }
+  return copy;
+}
+
+std::shared_ptr<Graph> forwardGraph(const Module& module) {
+  auto frozen = freeze_module(module);
+  auto graph = frozen.get_method("forward").graph()->copy();
+  TORCH_CHECK(
+      graph->inputs().at(0)->uses().empty(),
+      "StaticRuntime needs a module whose forward doesn't use self once "
+      "frozen");
+  graph->eraseInput(0);
+  return graph;
+}
+
+} // namespace
+
+ProcessedNode::ProcessedNode(
+    Node* node,
+    std::vector<size_t> inputs,
+    std::vector<size_t> outputs,
+    bool reuse_output)
+    : node_(node),
+      inputs_(std::move(inputs)),
+      outputs_(std::move(outputs)),
+      reuse_output_(reuse_output) {
+  for (const auto& out_variant : outVariants()) {
+    if (node->matches(out_variant.first)) {
+      out_variant_ = out_variant.second;
+      return;
+    }
+  }
+  op_ = boxedOperation(node);
+}
+
+at::Tensor& ProcessedNode::output(const at::TensorOptions& options) {
+  if (!output_.defined() || output_.dtype() != options.dtype() ||
+      output_.device() != options.device()) {
+    output_ = at::empty({0}, options);
+  }
+  return output_;
+}
+
+void ProcessedNode::run(Registers& reg, Stack& stack) {
+  if (out_variant_) {
+    out_variant_(*this, reg);
+    reg[outputs_[0]] = output_;
+    if (!reuse_output_) {
+      output_.reset();
+    }
+    return;
+  }
+  for (size_t input : inputs_) {
+    stack.push_back(reg[input]);
+  }
+  op_(stack);
+  TORCH_INTERNAL_ASSERT(stack.size() == outputs_.size());
+  for (size_t i = 0; i < outputs_.size(); ++i) {
+    reg[outputs_[i]] = std::move(stack[i]);
+  }
+  stack.clear();
+}
+
+StaticRuntime::StaticRuntime(std::shared_ptr<Graph> graph)
+    : graph_(prepareGraph(graph)) {
+  std::unordered_map<Value*, size_t> registers;
+  auto reg_of = [&](Value* value) {
+    auto it = registers.find(value);
+    TORCH_INTERNAL_ASSERT(it != registers.end());
+    return it->second;
+  };
+  auto add_reg = [&](Value* value, bool transient) {
+    size_t index = reg_.size();
+    registers.emplace(value, index);
+    reg_.emplace_back();
+    if (transient) {
+      transient_regs_.push_back(index);
+    }
+    return index;
+  };
+
+  for (Value* input : graph_->inputs()) {
+    input_regs_.push_back(add_reg(input, /*transient=*/true));
+  }
+  AliasDb alias_db(graph_);
+  for (Node* node : graph_->nodes()) {
+    if (node->kind() == prim::Constant) {
+      reg_[add_reg(node->output(), /*transient=*/false)] =
+          *toIValue(node->output());
+      continue;
+    }
+    std::vector<size_t> inputs;
+    for (Value* input : node->inputs()) {
+      inputs.push_back(reg_of(input));
+    }
+    std::vector<size_t> outputs;
+    for (Value* output : node->outputs()) {
+      outputs.push_back(add_reg(output, /*transient=*/true));
+    }
+    bool reuse_output = node->outputs().size() == 1 &&
+        !alias_db.escapesScope({node->output()});
+    nodes_.emplace_back(
+        node, std::move(inputs), std::move(outputs), reuse_output);
+  }
+  for (Value* output : graph_->outputs()) {
+    output_regs_.push_back(reg_of(output));
+  }
+  GRAPH_DUMP("StaticRuntime graph: ", graph_);
+}
+
+StaticRuntime::StaticRuntime(const Module& module)
+    : StaticRuntime(forwardGraph(module)) {}
+
+std::vector<at::Tensor> StaticRuntime::run(
+    const std::vector<at::Tensor>& inputs) {
+  TORCH_CHECK(
+      inputs.size() == input_regs_.size(),
+      "StaticRuntime expected ",
+      input_regs_.size(),
+      " inputs, got ",
+      inputs.size());
+  at::AutoGradMode no_grad(false);
+  stack_.clear();
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    reg_[input_regs_[i]] = inputs[i];
+  }
+  for (auto& node : nodes_) {
+    node.run(reg_, stack_);
+  }
+
+  std::vector<at::Tensor> outputs;
+  for (size_t index : output_regs_) {
+    const IValue& output = reg_[index];
+    if (output.isTuple()) {
+      for (const IValue& element : output.toTuple()->elements()) {
+        outputs.push_back(element.toTensor());
+      }
+    } else {
+      outputs.push_back(output.toTensor());
+    }
+  }
+  // Don't keep the inputs and outputs alive, nor anything the next run won't
+  // reuse.
+  for (size_t index : transient_regs_) {
+    reg_[index] = IValue();
+  }
+  return outputs;
+}
+
+} // namespace jit
+} // namespace torch
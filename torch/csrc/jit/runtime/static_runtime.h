@@ -0,0 +1,93 @@
+#pragma once
+
+#include <ATen/core/stack.h>
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/ir/ir.h>
+#include <torch/csrc/jit/runtime/operator.h>
+
+namespace torch {
+namespace jit {
+
+// One node of a StaticRuntime, with the registers of its inputs and outputs
+// and the kernel that computes it resolved once.
+class ProcessedNode {
+ public:
+  // Computes the node into its single output, which is a tensor.
+  using OutVariant = void (*)(ProcessedNode& node, std::vector<IValue>& reg);
+
+  ProcessedNode(
+      Node* node,
+      std::vector<size_t> inputs,
+      std::vector<size_t> outputs,
+      bool reuse_output);
+
+  void run(std::vector<IValue>& reg, Stack& stack);
+
+  Node* node() const {
+    return node_;
+  }
+  bool hasOutVariant() const {
+    return out_variant_ != nullptr;
+  }
+
+  const IValue& input(const std::vector<IValue>& reg, size_t i) const {
+    return reg[inputs_[i]];
+  }
+  // The tensor an out variant writes into: the one of the previous run when
+  // it can be reused, with the given dtype and device.
+  at::Tensor& output(const at::TensorOptions& options);
+
+ private:
+  Node* node_;
+  std::vector<size_t> inputs_;
+  std::vector<size_t> outputs_;
+  OutVariant out_variant_ = nullptr;
+  // Without an out variant, the boxed operation run on a stack.
+  Operation op_;
+  // Whether the output of the out variant is kept for the next run, i.e.
+  // nothing that may alias it escapes the graph.
+  bool reuse_output_;
+  at::Tensor output_;
+};
+
+// A runtime for inference graphs without control flow that avoids the
+// overhead of the interpreter: every value of the graph gets a fixed
+// register, the constants are loaded once, and the nodes are run in order
+// straight from their registers. The common ops with an out= overload (add,
+// mul, addmm, relu, ...) call their unboxed kernels directly, and write into
+// the output tensor of the previous run when it doesn't escape the graph, so
+// that a steady stream of same-sized inputs doesn't allocate intermediates.
+// The other ops go through their boxed operation.
+//
+// The inputs and outputs of the graph must be tensors (or a tuple of tensors
+// for the outputs), and it is run with autograd disabled. A StaticRuntime
+// holds the intermediates of its last run, so it must not be used by several
+// threads at once; create one per thread instead.
+class TORCH_API StaticRuntime {
+ public:
+  explicit StaticRuntime(std::shared_ptr<Graph> graph);
+  // Freezes `module`, which must be in eval mode, and runs its forward.
+  explicit StaticRuntime(const Module& module);
+
+  std::vector<at::Tensor> run(const std::vector<at::Tensor>& inputs);
+
+  const std::shared_ptr<Graph>& graph() const {
+    return graph_;
+  }
+  const std::vector<ProcessedNode>& nodes() const {
+    return nodes_;
+  }
+
+ private:
+  std::shared_ptr<Graph> graph_;
+  std::vector<IValue> reg_;
+  std::vector<ProcessedNode> nodes_;
+  std::vector<size_t> input_regs_;
+  std::vector<size_t> output_regs_;
+  // The registers cleared after each run, i.e. all but the constants.
+  std::vector<size_t> transient_regs_;
+  Stack stack_;
+};
+
+} // namespace jit
+} // namespace torch
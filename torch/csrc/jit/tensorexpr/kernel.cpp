@@ -1,11 +1,17 @@
 #include <torch/csrc/jit/tensorexpr/kernel.h>
 
+#include <ATen/Parallel.h>
 #include <c10/util/string_utils.h>
 #include <torch/csrc/jit/jit_log.h>
 #include <torch/csrc/jit/tensorexpr/analysis.h>
+#include <torch/csrc/jit/tensorexpr/eval.h>
 #include <torch/csrc/jit/tensorexpr/ir_printer.h>
 #include <torch/csrc/jit/tensorexpr/ir_simplifier.h>
 #include <torch/csrc/jit/tensorexpr/loopnest.h>
+#include <torch/csrc/jit/tensorexpr/var_substitutor.h>
+
+#include <algorithm>
+#include <limits>
 
 using namespace torch::jit;
 using namespace torch::jit::tensorexpr;
@@ -18,6 +24,7 @@ static int te_cuda_pointwise_loop_levels = -1;
 static int te_cuda_pointwise_block_count = -1;
 static int te_cuda_pointwise_block_size = -1;
 static bool fallback_allowed = true;
+static bool te_shape_bucketing = false;
 
 bool setFallbackAllowed(bool value) {
   bool old_value = fallback_allowed;
@@ -48,6 +55,10 @@ int& getTECudaPointwiseBlockSize() {
   return te_cuda_pointwise_block_size;
 }
 
+bool& getTEShapeBucketing() {
+  return te_shape_bucketing;
+}
+
 } // namespace tensorexpr
 } // namespace jit
 } // namespace torch
@@ -58,6 +69,9 @@ static at::ScalarType tensorType(Tensor* t) {
 
 static std::vector<ExprHandle> texprSizes(
     const c10::VaryingShape<int64_t>& shape) {
+  if (!shape.concrete_sizes()) {
+    throw malformed_input("shape is not static");
+  }
   std::vector<ExprHandle> dims;
   for (size_t i = 0; i < *shape.size(); i++) {
     dims.push_back(IntImm::make(*shape[i]));
@@ -189,7 +203,7 @@ static bool isOne(ExprHandle e) {
   return n->value() == 1;
 }
 
-static std::pair<std::vector<ExprHandle>, bool> broadcastShapes(
+std::pair<std::vector<ExprHandle>, bool> TensorExprKernel::broadcastShapes(
     const std::vector<ExprHandle>& a,
     const std::vector<ExprHandle>& b) {
   bool broadcast = false;
@@ -207,15 +221,18 @@ static std::pair<std::vector<ExprHandle>, bool> broadcastShapes(
       ret.push_back(*at++);
       continue;
     }
-    // TODO: if neither *at nor *bt is 1, ensure they are identical
-    // expressions.  Nb: `==` doesn't work since that simply produces a new
-    // ExprHandle.
     ExprHandle dim = *at;
     if (isOne(*at)) {
       if (!isOne(*bt)) {
         dim = *bt;
         broadcast = true;
       }
+    } else if (
+        !isOne(*bt) && at->node() != bt->node() &&
+        (!at->AsNode<IntImm>() || !bt->AsNode<IntImm>())) {
+      // The dims of the same symbol share their variable, the others must
+      // be checked to be equal when the kernel runs.
+      shapeChecks_.emplace_back(*at, *bt);
     }
     ret.push_back(dim);
     at++;
@@ -225,16 +242,6 @@ static std::pair<std::vector<ExprHandle>, bool> broadcastShapes(
   return {ret, broadcast};
 }
 
-template <typename... Args>
-static std::pair<std::vector<ExprHandle>, bool> broadcastShapes(
-    const std::vector<ExprHandle>& a,
-    const std::vector<ExprHandle>& b,
-    Args... args) {
-  auto const& res = broadcastShapes(a, b);
-  auto const& res2 = broadcastShapes(res.first, args...);
-  return {res2.first, res.second || res2.second};
-}
-
 std::vector<ExprHandle> TensorExprKernel::valueShape(
     const torch::jit::Value* v) {
   auto it = tensors_.find(v->unique());
@@ -413,6 +420,176 @@ Tensor* TensorExprKernel::computeFourOperand(
       });
 }
 
+// Normalizes the (possibly negative) axes of a reduction over a tensor of rank
+// `rank`, and sorts them.
+static std::vector<size_t> reductionAxes(
+    const std::vector<int64_t>& dims,
+    size_t rank) {
+  std::vector<size_t> axes;
+  for (int64_t dim : dims) {
+    int64_t axis = dim < 0 ? dim + static_cast<int64_t>(rank) : dim;
+    if (axis < 0 || axis >= static_cast<int64_t>(rank)) {
+      throw malformed_input("reduction axis out of range");
+    }
+    axes.push_back(axis);
+  }
+  std::sort(axes.begin(), axes.end());
+  if (std::adjacent_find(axes.begin(), axes.end()) != axes.end()) {
+    throw malformed_input("reduction axis repeated");
+  }
+  return axes;
+}
+
+Tensor* TensorExprKernel::computeReduction(
+    const std::string& name,
+    const torch::jit::Value* v,
+    const Reducer& reducer,
+    const std::vector<size_t>& reduceAxes,
+    bool keepdim,
+    const std::function<ExprHandle(const std::vector<ExprHandle>&)>& body) {
+  auto const& shape = valueShape(v->node()->inputs()[0]);
+  std::vector<bool> reduced(shape.size(), false);
+  for (size_t axis : reduceAxes) {
+    reduced[axis] = true;
+  }
+
+  std::vector<DimArg> outputDims;
+  std::vector<DimArg> reduceDims;
+  for (size_t i = 0; i < shape.size(); i++) {
+    if (!reduced[i]) {
+      outputDims.emplace_back(shape[i], "i" + c10::to_string(i));
+      continue;
+    }
+    if (keepdim) {
+      outputDims.emplace_back(IntImm::make(1), "i" + c10::to_string(i));
+    }
+    reduceDims.emplace_back(shape[i], "r" + c10::to_string(i));
+  }
+
+  // The variables of the output axes come first, then the reduced ones.
+  std::function<ExprHandle(ParameterList&)> reduceBody =
+      [&](ParameterList& vars) {
+        std::vector<ExprHandle> indices;
+        size_t outputIdx = 0;
+        size_t reduceIdx = outputDims.size();
+        for (size_t i = 0; i < reduced.size(); i++) {
+          if (!reduced[i]) {
+            indices.push_back(vars[outputIdx++]);
+            continue;
+          }
+          indices.push_back(vars[reduceIdx++]);
+          if (keepdim) {
+            outputIdx++;
+          }
+        }
+        return body(indices);
+      };
+  Tensor* t = Reduce(name, outputDims, reducer, reduceBody, reduceDims);
+
+  hasReduction_ = true;
+  if (!reduced.empty() && reduced.back()) {
+    innerReductions_.push_back(t);
+  }
+  return t;
+}
+
+Tensor* TensorExprKernel::computeSum(const torch::jit::Value* v) {
+  auto const& n = v->node();
+  auto const& shape = valueShape(n->inputs()[0]);
+  std::vector<size_t> axes;
+  bool keepdim = false;
+  if (n->inputs().size() > 2) {
+    axes = reductionAxes(
+        *n->get<std::vector<int64_t>>(attr::dim), shape.size());
+    keepdim = *n->get<bool>(attr::keepdim);
+  } else {
+    for (size_t i = 0; i < shape.size(); i++) {
+      axes.push_back(i);
+    }
+  }
+
+  Tensor* sum = computeReduction(
+      n->kind() == aten::sum ? "aten_sum" : "aten_mean_sum",
+      v,
+      Sum(),
+      axes,
+      keepdim,
+      [this, n](const std::vector<ExprHandle>& indices) {
+        return tensorOrConstant(n->inputs()[0], indices);
+      });
+  if (n->kind() == aten::sum) {
+    return sum;
+  }
+
+  // The sizes of the reduced axes may only be known when the kernel runs.
+  ExprHandle count = IntImm::make(1);
+  for (size_t axis : axes) {
+    count = count * shape[axis];
+  }
+  count = ExprHandle(IRSimplifier::simplify(count.node()));
+  return Compute(
+      "aten_mean",
+      c10::fmap<DimArg>(ExprVectorToExprHandleVector(sum->dims())),
+      [sum, count](const std::vector<VarHandle>& axes) {
+        ExprHandle s = sum->call(axes);
+        return s / Cast::make(s.dtype(), count);
+      });
+}
+
+Tensor* TensorExprKernel::computeSoftmax(
+    const torch::jit::Value* v,
+    bool logSoftmax) {
+  // softmax(x) = exp(x - max(x)) / sum(exp(x - max(x))), with the reductions
+  // along `dim`. Subtracting the maximum keeps the exponentials from
+  // overflowing. The exponentials are recomputed rather than stored.
+  auto const& n = v->node();
+  auto const& shape = valueShape(n->inputs()[0]);
+  size_t dim = reductionAxes({*n->get<int64_t>(attr::dim)}, shape.size())[0];
+  std::string name = logSoftmax ? "aten_log_softmax" : "aten_softmax";
+
+  auto input = [this, n](const std::vector<ExprHandle>& indices) {
+    return tensorOrConstant(n->inputs()[0], indices);
+  };
+  // The indices of the reductions for the indices of the input.
+  auto reducedIndices = [dim](std::vector<ExprHandle> indices) {
+    indices.erase(indices.begin() + dim);
+    return indices;
+  };
+
+  // The reductions are in the dtype of the input, which may be double.
+  auto tt = n->inputs()[0]->type()->expect<TensorType>();
+  Dtype dtype = ToDtype(static_cast<ScalarType>(*tt->scalarType()));
+  Tensor* max = computeReduction(
+      name + "_max",
+      v,
+      Maximum(Cast::make(
+          dtype, ExprHandle(-std::numeric_limits<float>::infinity()))),
+      {dim},
+      false,
+      input);
+  Tensor* sum = computeReduction(
+      name + "_sum",
+      v,
+      Sum(),
+      {dim},
+      false,
+      [&](const std::vector<ExprHandle>& indices) {
+        return exp(input(indices) - max->call(reducedIndices(indices)));
+      });
+  return Compute(
+      name,
+      c10::fmap<DimArg>(shape),
+      [&](const std::vector<VarHandle>& axes) {
+        std::vector<ExprHandle> indices(axes.begin(), axes.end());
+        ExprHandle shifted =
+            input(indices) - max->call(reducedIndices(indices));
+        if (logSoftmax) {
+          return shifted - log(sum->call(reducedIndices(indices)));
+        }
+        return exp(shifted) / sum->call(reducedIndices(indices));
+      });
+}
+
 Tensor* TensorExprKernel::computeValue(const torch::jit::Value* v) {
   switch (v->node()->kind()) {
     case aten::add: {
@@ -949,6 +1126,19 @@ Tensor* TensorExprKernel::computeValue(const torch::jit::Value* v) {
           });
     }
 
+    case aten::sum:
+    case aten::mean: {
+      return computeSum(v);
+    }
+
+    case aten::softmax: {
+      return computeSoftmax(v, false);
+    }
+
+    case aten::log_softmax: {
+      return computeSoftmax(v, true);
+    }
+
     case aten::_sigmoid_backward: {
       return computeTwoOperand(
           "aten_sigmoid_backward",
@@ -1018,14 +1208,177 @@ void TensorExprKernel::flattenTensors(BackendType backendType) {
   }
 }
 
-Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
+static bool isReduction(Tensor* t) {
+  return dynamic_cast<const ReduceOp*>(t->body()) != nullptr;
+}
+
+// Splits the innermost axis of each reduction by the vector width, and
+// rfactors the inner loop of the split out: the reduction then accumulates
+// `kVectorWidth` partial results, in a loop that can be vectorized, and reduces
+// them in the end.
+static void rfactorInnerReductions(
+    LoopNest& l,
+    const std::vector<Tensor*>& reductions) {
+  static const int kVectorWidth = 8;
+  for (Tensor* t : reductions) {
+    if (!l.hasLoopBodyFor(t)) {
+      continue;
+    }
+    For* loop = l.getLoopStmtsFor(t).back();
+    const IntImm* start = dynamic_cast<const IntImm*>(loop->start());
+    const IntImm* stop = dynamic_cast<const IntImm*>(loop->stop());
+    // A tail loop would need to be reduced separately.
+    if (!start || !stop || (stop->value() - start->value()) % kVectorWidth) {
+      continue;
+    }
+    For* outer;
+    For* inner;
+    For* tail;
+    l.splitWithTail(loop, kVectorWidth, &outer, &inner, &tail);
+    auto reduceOps = NodeFinder<ReduceOp>::find(inner);
+    if (reduceOps.size() == 1) {
+      l.rfactor(reduceOps[0], inner->var());
+    }
+  }
+}
+
+// Whether each iteration of `f` stores to different elements, which isn't the
+// case of the loops over reduction axes.
+static bool storesDependOnLoopVar(For* f) {
+  for (Store* store : NodeFinder<Store>::find(f)) {
+    bool dependsOnLoopVar = false;
+    for (const Expr* index : store->indices()) {
+      dependsOnLoopVar |= VarFinder().findVars(index).count(f->var()) > 0;
+    }
+    if (!dependsOnLoopVar) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The number of iterations of `f`, if it is known at compile time, or for the
+// values of the symbolic dims in `hints`.
+static c10::optional<int64_t> constantExtent(
+    For* f,
+    const VarMapping& hints) {
+  const Expr* extent = new Sub(f->stop(), f->start());
+  if (!hints.empty()) {
+    extent = Substitute(extent, hints);
+  }
+  extent = IRSimplifier::simplify(extent);
+  if (const IntImm* imm = dynamic_cast<const IntImm*>(extent)) {
+    return imm->value();
+  }
+  return c10::nullopt;
+}
+
+// The number of elements `s` stores, if it is known at compile time, or for
+// the values of the symbolic dims in `hints`.
+static c10::optional<int64_t> estimateWork(Stmt* s, const VarMapping& hints) {
+  if (For* f = dynamic_cast<For*>(s)) {
+    auto extent = constantExtent(f, hints);
+    auto body = estimateWork(f->body(), hints);
+    if (!extent || !body) {
+      return c10::nullopt;
+    }
+    return *extent * *body;
+  }
+  if (Block* b = dynamic_cast<Block*>(s)) {
+    int64_t work = 0;
+    for (Stmt* s2 : *b) {
+      auto work2 = estimateWork(s2, hints);
+      if (!work2) {
+        return c10::nullopt;
+      }
+      work += *work2;
+    }
+    return work;
+  }
+  if (Store* store = dynamic_cast<Store*>(s)) {
+    return store->value()->dtype().lanes();
+  }
+  return static_cast<int64_t>(NodeFinder<Store>::find(s).size());
+}
+
+// The outermost loops of `root`.
+static std::vector<For*> findOuterLoops(Stmt* root) {
+  std::vector<For*> loops;
+  if (For* rootF = dynamic_cast<For*>(root)) {
+    loops.push_back(rootF);
+  } else if (Block* body = dynamic_cast<Block*>(root)) {
+    std::vector<Block*> blocks = {body};
+    while (blocks.size()) {
+      Block* b = blocks.back();
+      blocks.pop_back();
+
+      for (Stmt* s : *b) {
+        if (For* f = dynamic_cast<For*>(s)) {
+          loops.push_back(f);
+        } else if (Block* b2 = dynamic_cast<Block*>(s)) {
+          blocks.push_back(b2);
+        }
+      }
+    }
+  }
+  return loops;
+}
+
+// The number of lanes to vectorize the innermost loop `f` with: as many
+// elements of the widest type it stores as fit in a 256-bit register, and at
+// most 8.
+static int vectorWidth(For* f) {
+  static const int kVectorBytes = 32;
+  static const int kMaxVectorWidth = 8;
+  int elementBytes = 1;
+  for (Store* store : NodeFinder<Store>::find(f)) {
+    elementBytes = std::max(elementBytes, store->value()->dtype().byte_size());
+  }
+  return std::max(1, std::min(kMaxVectorWidth, kVectorBytes / elementBytes));
+}
+
+// Runs the loop nests that store enough elements to amortize the cost of
+// at::parallel_for (its grain size) in parallel. The parallel loop of a nest
+// is the outermost one with at least as many iterations as there are threads,
+// looking through perfectly nested loops, and each of its iterations must
+// store to different elements.
+static void parallelizeOuterLoops(LoopNest& l, const VarMapping& hints) {
+  const int64_t kGrainSize = at::internal::GRAIN_SIZE;
+  int64_t numThreads = at::get_num_threads();
+  if (numThreads < 2) {
+    return;
+  }
+  for (For* loop : findOuterLoops(l.root_stmt())) {
+    auto work = estimateWork(loop, hints);
+    if (!work || *work < kGrainSize) {
+      continue;
+    }
+    while (*constantExtent(loop, hints) < numThreads) {
+      Block* body = loop->body();
+      For* inner =
+          body->nstmts() == 1 ? dynamic_cast<For*>(body->front()) : nullptr;
+      if (!inner || *estimateWork(inner, hints) < kGrainSize) {
+        break;
+      }
+      loop = inner;
+    }
+    if (*constantExtent(loop, hints) > 1 && storesDependOnLoopVar(loop)) {
+      l.parallelize(loop);
+    }
+  }
+}
+
+Stmt* TensorExprKernel::generateStmt(
+    BackendType backendType,
+    const VarMapping& hints) {
   flattenTensors(backendType);
 
   torch::jit::tensorexpr::LoopNest l(flatTensorOutputs_);
 
-  // Compute non-output tensors_ inline
+  // Compute non-output tensors_ inline, except for the reductions, which are
+  // computed once into their buffers.
   for (auto& p : tensors_) {
-    if (!l.hasLoopBodyFor(p.second)) {
+    if (!l.hasLoopBodyFor(p.second) || isReduction(p.second)) {
       continue;
     }
     Stmt* loop = l.getLoopBodyFor(p.second);
@@ -1082,30 +1435,15 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
     }
   }
 
+  if (backendType == kLLVMCodeGen) {
+    rfactorInnerReductions(l, innerReductions_);
+  }
+
   l.prepareForCodegen();
 
   if (backendType == kLLVMCodeGen) {
     std::vector<For*> innerLoops;
-    std::vector<For*> worklist;
-
-    // Find outer-most For loops
-    if (For* rootF = dynamic_cast<For*>(l.root_stmt())) {
-      worklist.push_back(rootF);
-    } else if (Block* body = dynamic_cast<Block*>(l.root_stmt())) {
-      std::vector<Block*> blocks = {body};
-      while (blocks.size()) {
-        Block* b = blocks.back();
-        blocks.pop_back();
-
-        for (Stmt* s : *b) {
-          if (For* f = dynamic_cast<For*>(s)) {
-            worklist.push_back(f);
-          } else if (Block* b2 = dynamic_cast<Block*>(s)) {
-            blocks.push_back(b2);
-          }
-        }
-      }
-    }
+    std::vector<For*> worklist = findOuterLoops(l.root_stmt());
 
     // Traverse the For loop nest find inner-most loops, which are
     // vectorization candidates.
@@ -1123,30 +1461,35 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
         }
       }
 
-      if (!containsSubLoops) {
+      if (!containsSubLoops && storesDependOnLoopVar(f)) {
         innerLoops.push_back(f);
       }
     }
 
     // vectorize inner loops.
     for (For* loop : innerLoops) {
+      int bodyVectorWidth = vectorWidth(loop);
+      if (bodyVectorWidth < 2) {
+        continue;
+      }
       For* outer1;
       For* split1;
       For* tail1;
-
-      static const int kBodyVectorWidth = 8;
-      l.splitWithTail(loop, kBodyVectorWidth, &outer1, &split1, &tail1);
+      l.splitWithTail(loop, bodyVectorWidth, &outer1, &split1, &tail1);
       l.vectorize(split1);
 
-      if (tail1) {
+      int tailVectorWidth = bodyVectorWidth / 2;
+      if (tail1 && tailVectorWidth > 1) {
         For* outer2;
         For* split2;
         For* tail2;
-        static const int kTailVectorWidth = 4;
-        l.splitWithTail(tail1, kTailVectorWidth, &outer2, &split2, &tail2);
+        l.splitWithTail(tail1, tailVectorWidth, &outer2, &split2, &tail2);
         l.vectorize(split2);
       }
     }
+
+    // Splitting loops drops their options, so this comes last.
+    parallelizeOuterLoops(l, hints);
   }
 
   Stmt* stmt = l.root_stmt();
@@ -1305,13 +1648,54 @@ void TensorExprKernel::bindInput(const torch::jit::Value* input) {
           "t" + input->debugName(),
           ToDtype(static_cast<ScalarType>(*tt->scalarType())),
           {0});
+      auto const& symbolicSizes = tt->symbolic_sizes().sizes();
+      if (!symbolicSizes) {
+        throw malformed_input("rank of an input is not known");
+      }
+      // The symbolic dims are passed to the kernel, once per symbol.
+      std::vector<ExprHandle> sizes;
+      std::vector<ShapeArg> sizeArgs;
+      bool isSymbolic = false;
+      for (size_t i = 0; i < symbolicSizes->size(); i++) {
+        auto const& symbol = (*symbolicSizes)[i];
+        if (symbol.is_static()) {
+          sizes.push_back(IntImm::make(symbol.static_size()));
+          continue;
+        }
+        isSymbolic = true;
+        auto it = shapeVars_.find(symbol);
+        if (it == shapeVars_.end()) {
+          VarHandle var(
+              "s" + input->debugName() + "_" + c10::to_string(i), kInt);
+          it = shapeVars_.emplace(symbol, var).first;
+          sizeArgs.emplace_back(i, var);
+        }
+        sizes.push_back(it->second);
+      }
+      inputShapes_.emplace(input->offset(), sizes);
+
+      // Inputs whose strides aren't known are assumed to be contiguous,
+      // which is checked when the kernel runs.
+      std::vector<ExprHandle> strides(sizes.size());
+      auto const& staticStrides = tt->strides().concrete_sizes();
+      if (!staticStrides || isSymbolic) {
+        contiguousInputs_.push_back(input->offset());
+      }
+      for (size_t i = sizes.size(); i-- > 0;) {
+        if (staticStrides && !isSymbolic) {
+          strides[i] = IntImm::make((*staticStrides)[i]);
+        } else if (i + 1 == sizes.size()) {
+          strides[i] = IntImm::make(1);
+        } else {
+          strides[i] = strides[i + 1] * sizes[i + 1];
+        }
+      }
+
       std::vector<DimArg> inputTensorDims;
-      for (size_t i = 0; i < *tt->sizes().size(); i++) {
-        auto const size = *tt->sizes()[i];
+      for (size_t i = 0; i < sizes.size(); i++) {
         inputTensorDims.emplace_back(
-            DimArg(IntImm::make(size), "i" + c10::to_string(i)));
+            DimArg(sizes[i], "i" + c10::to_string(i)));
       }
-      auto const strides = tt->strides();
       tensors_.emplace(
           input->unique(),
           Compute(
@@ -1320,12 +1704,11 @@ void TensorExprKernel::bindInput(const torch::jit::Value* input) {
               [&](const std::vector<VarHandle>& axes) {
                 ExprHandle idx = 0;
                 for (size_t i = 0; i < axes.size(); i++) {
-                  idx = idx + axes[i] * IntImm::make(*strides[i]);
+                  idx = idx + axes[i] * strides[i];
                 }
                 return inBuffer(idx);
               }));
-      kernelArgs_.emplace_back(
-          inBuffer, std::vector<ShapeArg>(), std::vector<ShapeArg>());
+      kernelArgs_.emplace_back(inBuffer, sizeArgs, std::vector<ShapeArg>());
       break;
     }
     case TypeKind::FloatType: {
@@ -1390,14 +1773,17 @@ void TensorExprKernel::compile() {
   }
 
   device_ = pickDeviceType(graph_->inputs());
-  BackendType backendType = inferBackendTypeFromDevice(device_);
-  Stmt* stmt = generateStmt(backendType);
+  backendType_ = inferBackendTypeFromDevice(device_);
+  if (hasReduction_ && backendType_ == kCudaCodeGen) {
+    throw std::runtime_error("Reductions are only supported on CPU");
+  }
+  Stmt* stmt = generateStmt(backendType_);
 
   // Set up formal params (inputs, then outputs) for kernel.
   std::vector<CodeGen::BufferArg> params = prepareBufferArgs();
 
   // Generate code.
-  codegen_ = CreateCodeGen(getCodeGenName(backendType), stmt, params, device_);
+  codegen_ = CreateCodeGen(getCodeGenName(backendType_), stmt, params, device_);
 }
 
 TensorExprKernel::TensorExprKernel(const std::shared_ptr<Graph>& subgraph)
@@ -1485,17 +1871,108 @@ Stmt* TensorExprKernel::getCodeGenStmt() {
   return codegen_->stmt();
 }
 
+bool TensorExprKernel::shapesMatch(const at::ArrayRef<IValue>& inputs) const {
+  if (shapeVars_.empty() && contiguousInputs_.empty()) {
+    return true;
+  }
+  for (size_t i : contiguousInputs_) {
+    if (!inputs[i].toTensor().is_contiguous()) {
+      return false;
+    }
+  }
+
+  std::unordered_map<const Expr*, int64_t> symbolSizes;
+  for (auto const& p : inputShapes_) {
+    auto const& tensor = inputs[p.first].toTensor();
+    auto const& sizes = tensor.sizes();
+    auto const& dims = p.second;
+    if (sizes.size() != dims.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < dims.size(); i++) {
+      if (const IntImm* dim = dims[i].AsNode<IntImm>()) {
+        if (dim->value() != sizes[i]) {
+          return false;
+        }
+        continue;
+      }
+      // The kernel doesn't broadcast along symbolic dims.
+      if (sizes[i] == 1) {
+        return false;
+      }
+      auto it = symbolSizes.emplace(dims[i].node(), sizes[i]).first;
+      if (it->second != sizes[i]) {
+        return false;
+      }
+    }
+  }
+
+  auto dimSize = [&](const ExprHandle& dim) {
+    const IntImm* imm = dim.AsNode<IntImm>();
+    return imm ? imm->value() : symbolSizes.at(dim.node());
+  };
+  for (auto const& check : shapeChecks_) {
+    if (dimSize(check.first) != dimSize(check.second)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+CodeGen* TensorExprKernel::bucketCodeGen(const at::ArrayRef<IValue>& inputs) {
+  std::vector<std::pair<const Var*, int64_t>> buckets;
+  for (size_t i = 0; i < inputs.size(); i++) {
+    for (auto const& size : kernelArgs_[i].sizes()) {
+      int64_t s = inputs[i].toTensor().sizes()[size.idx];
+      int64_t bucket = 1;
+      while (bucket * 2 <= s) {
+        bucket *= 2;
+      }
+      buckets.emplace_back(size.var.node(), bucket);
+    }
+  }
+  std::vector<int64_t> key;
+  for (auto const& b : buckets) {
+    key.push_back(b.second);
+  }
+
+  std::lock_guard<std::mutex> guard(bucketMutex_);
+  auto& codegen = bucketCodegens_[key];
+  if (!codegen) {
+    VarMapping hints;
+    for (auto const& b : buckets) {
+      hints.emplace_back(b.first, new IntImm(static_cast<int>(b.second)));
+    }
+    Stmt* stmt = generateStmt(backendType_, hints);
+    codegen = CreateCodeGen(
+        getCodeGenName(backendType_), stmt, prepareBufferArgs(), device_);
+  }
+  return codegen.get();
+}
+
 void TensorExprKernel::runKernel(Stack& stack) {
+  auto inputs = last(stack, nInputs_);
+  if (!shapesMatch(inputs)) {
+    // The inputs break an assumption the kernel made on their shapes, e.g.
+    // they are broadcast along a symbolic dim. Later calls may still use it.
+    fallback(stack);
+    return;
+  }
+
   KernelScope kernelScope(&kernelArena_);
 
   // Set up arguments (inputs, then outputs) for kernel call.
-  auto inputs = last(stack, nInputs_);
   std::vector<at::Tensor> outputs;
 
   std::vector<CodeGen::CallArg> runArgs = prepareRunArgs(inputs, outputs);
 
   // Call the kernel.
-  codegen_->call(runArgs);
+  CodeGen* codegen = codegen_.get();
+  if (getTEShapeBucketing() && !shapeVars_.empty() &&
+      backendType_ == kLLVMCodeGen) {
+    codegen = bucketCodeGen(inputs);
+  }
+  codegen->call(runArgs);
 
   // Update the stack.
   drop(stack, nInputs_);
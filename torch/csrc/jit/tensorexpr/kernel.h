@@ -4,6 +4,10 @@
 #include <torch/csrc/jit/runtime/interpreter.h>
 #include <torch/csrc/jit/tensorexpr/codegen.h>
 #include <torch/csrc/jit/tensorexpr/tensor.h>
+#include <torch/csrc/jit/tensorexpr/var_substitutor.h>
+
+#include <map>
+#include <mutex>
 
 namespace torch {
 namespace jit {
@@ -66,6 +70,14 @@ class TORCH_API TensorExprKernel {
 
   void runKernel(Stack& stack);
 
+  // Whether the kernel compiled for symbolic shapes can run on `inputs`,
+  // i.e. they match the static dims and the assumptions the kernel made on
+  // the symbolic ones.
+  bool shapesMatch(const at::ArrayRef<IValue>& inputs) const;
+
+  // The kernel specialized for the bucket of the sizes of `inputs`.
+  CodeGen* bucketCodeGen(const at::ArrayRef<IValue>& inputs);
+
   ExprHandle constant(const torch::jit::Value* v);
 
   template <typename T, typename T1>
@@ -102,6 +114,20 @@ class TORCH_API TensorExprKernel {
 
   ExprHandle demoteOutput(const ExprHandle& e, const torch::jit::Value* v);
 
+  std::pair<std::vector<ExprHandle>, bool> broadcastShapes(
+      const std::vector<ExprHandle>& a,
+      const std::vector<ExprHandle>& b);
+
+  template <typename... Args>
+  std::pair<std::vector<ExprHandle>, bool> broadcastShapes(
+      const std::vector<ExprHandle>& a,
+      const std::vector<ExprHandle>& b,
+      Args... args) {
+    auto const& res = broadcastShapes(a, b);
+    auto const& res2 = broadcastShapes(res.first, args...);
+    return {res2.first, res.second || res2.second};
+  }
+
   template <typename T>
   ExprHandle tensorOrConstant(
       const torch::jit::Value* v,
@@ -153,10 +179,26 @@ class TORCH_API TensorExprKernel {
           const ExprHandle&,
           const ExprHandle&)>& innerExpr);
 
+  // Reduces the first input of `v`'s node over `reduceAxes` (sorted), with
+  // `body` giving the value to reduce at the indices of that input.
+  Tensor* computeReduction(
+      const std::string& name,
+      const torch::jit::Value* v,
+      const Reducer& reducer,
+      const std::vector<size_t>& reduceAxes,
+      bool keepdim,
+      const std::function<ExprHandle(const std::vector<ExprHandle>&)>& body);
+
+  Tensor* computeSum(const torch::jit::Value* v);
+
+  Tensor* computeSoftmax(const torch::jit::Value* v, bool logSoftmax);
+
   Tensor* computeValue(const torch::jit::Value* v);
 
   void flattenTensors(BackendType backendType);
-  Stmt* generateStmt(BackendType backendType);
+  // `hints` gives typical values of the symbolic dims, used to schedule the
+  // loops whose extents depend on them.
+  Stmt* generateStmt(BackendType backendType, const VarMapping& hints = {});
   std::vector<CodeGen::BufferArg> prepareBufferArgs();
 
   std::string getCodeGenName(BackendType backendType);
@@ -208,10 +250,26 @@ class TORCH_API TensorExprKernel {
   std::vector<KernelArg> kernelArgs_;
   std::vector<Tensor*> tensorOutputs_;
   std::vector<Tensor*> flatTensorOutputs_;
+  // The reductions over the innermost axis of their input.
+  std::vector<Tensor*> innerReductions_;
   std::unordered_map<int64_t, Tensor*> tensors_;
   std::unordered_map<int64_t, VarHandle> scalars_;
   std::unique_ptr<CodeGen> codegen_;
   at::Device device_ = at::kCPU;
+  BackendType backendType_ = kUninitialized;
+  // The dims of the tensor inputs (by input index), as constants or as the
+  // variables of their symbols, and the variables of the symbols.
+  std::unordered_map<size_t, std::vector<ExprHandle>> inputShapes_;
+  std::map<c10::ShapeSymbol, VarHandle> shapeVars_;
+  // The tensor inputs that the kernel assumes to be contiguous.
+  std::vector<size_t> contiguousInputs_;
+  // The dims that the kernel assumes to be equal, because it broadcasts them
+  // together.
+  std::vector<std::pair<ExprHandle, ExprHandle>> shapeChecks_;
+  // The kernels specialized for the buckets of the symbolic dims (their
+  // powers of two lower bounds), see getTEShapeBucketing.
+  std::map<std::vector<int64_t>, std::unique_ptr<CodeGen>> bucketCodegens_;
+  std::mutex bucketMutex_;
   KernelArena kernelArena_;
   std::vector<TypePtr> inputTypes_;
   std::shared_ptr<Graph> graph_;
@@ -219,11 +277,16 @@ class TORCH_API TensorExprKernel {
   bool fallback_{false};
   bool hasRandom_{false};
   bool hasBroadcast_{false};
+  bool hasReduction_{false};
 };
 
 TORCH_API int& getTECudaPointwiseLoopLevels();
 TORCH_API int& getTECudaPointwiseBlockCount();
 TORCH_API int& getTECudaPointwiseBlockSize();
+// Whether the kernels compiled for symbolic shapes are also compiled for each
+// bucket of the sizes they run on (the powers of two below them), so that
+// their loops can be scheduled for those sizes, e.g. run in parallel.
+TORCH_API bool& getTEShapeBucketing();
 TORCH_API bool fallbackAllowed();
 TORCH_API bool setFallbackAllowed(bool value);
 
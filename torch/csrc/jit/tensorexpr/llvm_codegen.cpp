@@ -4,8 +4,10 @@
 #include <torch/csrc/jit/tensorexpr/llvm_jit.h>
 
 #include <memory>
+#include <unordered_set>
 
 #include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/Config/llvm-config.h>
 #include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
 #include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
 #include <llvm/IR/IRBuilder.h>
@@ -15,6 +17,7 @@
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
 
+#include <torch/csrc/jit/runtime/kernel_disk_cache.h>
 #include <torch/csrc/jit/tensorexpr/buffer.h>
 #include <torch/csrc/jit/tensorexpr/execution_counter.h>
 #include <torch/csrc/jit/tensorexpr/ir.h>
@@ -57,6 +60,8 @@ class LLVMCodeGenImpl : public IRVisitor {
   llvm::Type* dtypeToLLVMPtr(Dtype dtype);
   void emitWrapper(const std::vector<llvm::Type*>& params);
   void emitKernel(Stmt* stmt, const std::vector<llvm::Type*>& params);
+  void emitLoop(const For* v, llvm::Value* start, llvm::Value* stop);
+  void emitParallelFor(const For* v);
 
  public:
   LLVMCodeGenImpl(
@@ -116,6 +121,7 @@ class LLVMCodeGenImpl : public IRVisitor {
       llvm::Value* val);
 
   void optimize(llvm::Module& M);
+  std::string emitObject(llvm::Module& M);
 };
 } // namespace tensorexpr
 } // namespace jit
@@ -263,8 +269,32 @@ LLVMCodeGenImpl::LLVMCodeGenImpl(
   emitWrapper(params);
   emitKernel(stmt, params);
 
-  cantFail(jit_->addModule(
-      llvm::orc::ThreadSafeModule(std::move(module_), context_)));
+  auto& cache = KernelDiskCache::get();
+  if (cache.enabled()) {
+    // What the object code depends on: the unoptimized IR, the target and
+    // the LLVM version.
+    std::string key;
+    llvm::raw_string_ostream key_stream(key);
+    key_stream << "tensorexpr-llvm\n"
+               << LLVM_VERSION_STRING << "\n"
+               << JTMB.getTargetTriple().str() << "\n"
+               << JTMB.getCPU() << "\n"
+               << JTMB.getFeatures().getString() << "\n"
+               << *module_;
+    key_stream.flush();
+    auto object = cache.load(key, "o");
+    if (!object) {
+      optimize(*module_);
+      object = emitObject(*module_);
+      cache.store(key, "o", *object);
+    }
+    cantFail(
+        jit_->addObjectFile(llvm::MemoryBuffer::getMemBufferCopy(*object)));
+  } else {
+    optimize(*module_);
+    cantFail(jit_->addModule(
+        llvm::orc::ThreadSafeModule(std::move(module_), context_)));
+  }
   auto sym = jit_->findSymbol("wrapper");
   kernelAddress_ = cantFail(sym.getAddress());
   argv_ = std::make_unique<void*[]>(params.size());
@@ -438,21 +468,6 @@ void LLVMCodeGenImpl::emitKernel(
   if (llvm::verifyFunction(*fn_, &llvm::outs())) {
     throw std::runtime_error("Function verification failed");
   }
-  optimize(*module_);
-
-#if DEBUG_PRINT
-  llvm::errs() << *module_;
-  llvm::SmallVector<char, 0> asmBuffer;
-  llvm::raw_svector_ostream asmStream(asmBuffer);
-  llvm::legacy::PassManager PM;
-  TM_->addPassesToEmitFile(
-      PM,
-      asmStream,
-      nullptr,
-      llvm::TargetMachine::CodeGenFileType::CGFT_AssemblyFile);
-  PM.run(*module_);
-  llvm::errs() << asmStream.str();
-#endif
 }
 
 // TODO: The binary ops are copypasta.
@@ -961,12 +976,123 @@ void LLVMCodeGenImpl::visit(const Load* v) {
 }
 
 void LLVMCodeGenImpl::visit(const For* v) {
+  if (v->loop_options().is_parallel()) {
+    emitParallelFor(v);
+    return;
+  }
+
   // Create "start" and "stop" values.
   v->start()->accept(this);
   auto start = this->value_;
   v->stop()->accept(this);
   auto stop = this->value_;
+  emitLoop(v, start, stop);
+}
+
+// The Vars used in a statement, in the order they first appear, so that the
+// generated code is deterministic.
+class UsedVarsFinder : public IRVisitor {
+ public:
+  const std::vector<const Var*>& find(Stmt* s) {
+    s->accept(this);
+    return vars_;
+  }
+
+  void visit(const Var* v) override {
+    if (seen_.insert(v).second) {
+      vars_.push_back(v);
+    }
+  }
+
+ private:
+  std::unordered_set<const Var*> seen_;
+  std::vector<const Var*> vars_;
+};
+
+// Outlines the body of the loop into a function that runs the iterations in
+// [begin, end), and calls it through at::parallel_for. The values the body
+// uses are passed to it in a struct.
+void LLVMCodeGenImpl::emitParallelFor(const For* v) {
+  v->start()->accept(this);
+  auto start = irb_.CreateSExt(value_, LongTy_);
+  v->stop()->accept(this);
+  auto stop = irb_.CreateSExt(value_, LongTy_);
+
+  std::vector<const Var*> captures;
+  std::vector<llvm::Value*> captureVals;
+  std::vector<llvm::Type*> captureTys;
+  for (const Var* var : UsedVarsFinder().find(v->body())) {
+    if (varToArg_.count(var) || varToVal_.count(var)) {
+      var->accept(this);
+      captures.push_back(var);
+      captureVals.push_back(value_);
+      captureTys.push_back(value_->getType());
+    }
+  }
+  auto envTy = llvm::StructType::get(getContext(), captureTys);
+  auto voidTy = llvm::Type::getVoidTy(getContext());
+  auto voidPtrTy = llvm::Type::getInt8PtrTy(getContext());
+
+  // Store the captured values, in a struct allocated once in the entry block
+  // in case the loop is nested in another one.
+  llvm::IRBuilder<> entry(
+      &fn_->getEntryBlock(), fn_->getEntryBlock().getFirstInsertionPt());
+  auto env = entry.CreateAlloca(envTy);
+  for (size_t i = 0; i < captureVals.size(); i++) {
+    irb_.CreateStore(captureVals[i], irb_.CreateStructGEP(envTy, env, i));
+  }
+
+  auto bodyFn = llvm::Function::Create(
+      llvm::FunctionType::get(voidTy, {LongTy_, LongTy_, voidPtrTy}, false),
+      llvm::Function::PrivateLinkage,
+      "parallel_body",
+      module_.get());
+
+  // Generate the body in its function, where the captured values replace the
+  // arguments and values of the kernel.
+  auto kernelFn = fn_;
+  auto kernelBlock = irb_.GetInsertBlock();
+  auto kernelVarToArg = std::move(varToArg_);
+  auto kernelVarToVal = std::move(varToVal_);
+  varToArg_.clear();
+  varToVal_.clear();
+  fn_ = bodyFn;
+  irb_.SetInsertPoint(llvm::BasicBlock::Create(getContext(), "entry", fn_));
+  auto bodyArgs = fn_->arg_begin();
+  auto begin = irb_.CreateTrunc(bodyArgs, IntTy_);
+  auto end = irb_.CreateTrunc(bodyArgs + 1, IntTy_);
+  auto bodyEnv = irb_.CreatePointerCast(bodyArgs + 2, envTy->getPointerTo());
+  for (size_t i = 0; i < captures.size(); i++) {
+    varToVal_.emplace(
+        captures[i], irb_.CreateLoad(irb_.CreateStructGEP(envTy, bodyEnv, i)));
+  }
+  emitLoop(v, begin, end);
+  irb_.CreateRetVoid();
+  if (llvm::verifyFunction(*fn_, &llvm::outs())) {
+    throw std::runtime_error("Function verification failed");
+  }
+
+  fn_ = kernelFn;
+  varToArg_ = std::move(kernelVarToArg);
+  varToVal_ = std::move(kernelVarToVal);
+  irb_.SetInsertPoint(kernelBlock);
+
+  auto parallelFor = module_->getOrInsertFunction(
+      "nnc_parallel_for",
+      llvm::FunctionType::get(
+          voidTy,
+          {bodyFn->getType(), LongTy_, LongTy_, voidPtrTy},
+          false));
+  irb_.CreateCall(
+      parallelFor,
+      {bodyFn, start, stop, irb_.CreatePointerCast(env, voidPtrTy)});
+  value_ = llvm::ConstantInt::get(IntTy_, 0);
+}
 
+void LLVMCodeGenImpl::emitLoop(
+    const For* v,
+    llvm::Value* start,
+    llvm::Value* stop) {
   // Create block for loop condition test.
   auto preheader = irb_.GetInsertBlock();
   auto condBlock = llvm::BasicBlock::Create(getContext(), "cond", fn_);
@@ -1571,6 +1697,8 @@ void LLVMCodeGenImpl::visit(const Free* v) {
   if (!llvm::isa<llvm::AllocaInst>(ptr)) {
     irb_.Insert(llvm::CallInst::CreateFree(ptr, irb_.GetInsertBlock()));
   }
+  // The buffer may not be used past this point, e.g. by a parallel loop.
+  varToVal_.erase(v->buffer_var());
 }
 
 void LLVMCodeGenImpl::visit(const Cond* v) {
@@ -1602,6 +1730,35 @@ void LLVMCodeGenImpl::optimize(llvm::Module& M) {
   }
   FPM.doFinalization();
   PM.run(M);
+
+#if DEBUG_PRINT
+  llvm::errs() << M;
+  llvm::SmallVector<char, 0> asmBuffer;
+  llvm::raw_svector_ostream asmStream(asmBuffer);
+  llvm::legacy::PassManager asmPM;
+  TM_->addPassesToEmitFile(
+      asmPM,
+      asmStream,
+      nullptr,
+      llvm::TargetMachine::CodeGenFileType::CGFT_AssemblyFile);
+  asmPM.run(M);
+  llvm::errs() << asmStream.str();
+#endif
+}
+
+std::string LLVMCodeGenImpl::emitObject(llvm::Module& M) {
+  llvm::SmallVector<char, 0> objBuffer;
+  llvm::raw_svector_ostream objStream(objBuffer);
+  llvm::legacy::PassManager PM;
+  if (TM_->addPassesToEmitFile(
+          PM,
+          objStream,
+          nullptr,
+          llvm::TargetMachine::CodeGenFileType::CGFT_ObjectFile)) {
+    throw std::runtime_error("Failed to emit object code");
+  }
+  PM.run(M);
+  return std::string(objBuffer.begin(), objBuffer.end());
 }
 
 RegisterCodeGen<LLVMCodeGen> llvm_codegen_reg("llvm_codegen");
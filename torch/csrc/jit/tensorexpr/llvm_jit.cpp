@@ -2,6 +2,7 @@
 
 #include <torch/csrc/jit/tensorexpr/llvm_jit.h>
 
+#include <ATen/Parallel.h>
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
 #include <sleef.h>
 #include <algorithm>
@@ -9,6 +10,25 @@
 #include <string>
 #include <vector>
 
+namespace {
+
+// Runs the parallel loops of the kernels: `body` is the outlined body of the
+// loop, which runs the iterations in [begin, end), and `env` holds the values
+// it uses. The loops are only parallelized when they are worth it, so their
+// iterations are evenly split among the threads.
+void nnc_parallel_for(
+    void (*body)(int64_t begin, int64_t end, void* env),
+    int64_t start,
+    int64_t stop,
+    void* env) {
+  at::parallel_for(
+      start, stop, /*grain_size=*/1, [&](int64_t begin, int64_t end) {
+        body(begin, end, env);
+      });
+}
+
+} // namespace
+
 namespace llvm {
 namespace orc {
 
@@ -416,6 +436,10 @@ class TORCH_API PytorchLLVMJITImpl {
         *Mangle("Sleef_fmodd4"),
         {llvm::pointerToJITTargetAddress(&Sleef_fmodd4), {}}));
 #endif
+
+    cantFail(LLJ->defineAbsolute(
+        *Mangle("nnc_parallel_for"),
+        {llvm::pointerToJITTargetAddress(&nnc_parallel_for), {}}));
   }
 
   Error addModule(ThreadSafeModule M) {
@@ -425,6 +449,10 @@ class TORCH_API PytorchLLVMJITImpl {
     return Error::success();
   }
 
+  Error addObjectFile(std::unique_ptr<MemoryBuffer> Obj) {
+    return LLJ->addObjectFile(std::move(Obj));
+  }
+
   JITSymbol findSymbol(const std::string Name) {
     return cantFail(LLJ->lookup(Name));
   }
@@ -443,6 +471,10 @@ Error PytorchLLVMJIT::addModule(ThreadSafeModule M) {
   return impl_->addModule(std::move(M));
 }
 
+Error PytorchLLVMJIT::addObjectFile(std::unique_ptr<MemoryBuffer> Obj) {
+  return impl_->addObjectFile(std::move(Obj));
+}
+
 JITSymbol PytorchLLVMJIT::findSymbol(const std::string Name) {
   return impl_->findSymbol(std::move(Name));
 }
@@ -842,7 +842,8 @@ Block* findLowestContainingBlock(const std::vector<BufUse>& uses) {
 Stmt* LoopNest::insertAllocFree(Stmt* stmt) {
   // Add allocs and frees for intermediate buffers at the global level.
   // TODO: move allocs and frees to the imemediate areas to reuse buffers.
-  if (intermediate_tensors_.size() == 0ULL && temp_bufs_.size() == 0ULL) {
+  if (intermediate_tensors_.size() == 0ULL && temp_bufs_.size() == 0ULL &&
+      rfactor_bufs_.size() == 0ULL) {
     return stmt;
   }
 
@@ -869,6 +870,12 @@ Stmt* LoopNest::insertAllocFree(Stmt* stmt) {
     b->append_stmt(free);
   }
 
+  for (const Buf* buf : rfactor_bufs_) {
+    b->prepend_stmt(
+        new Allocate(buf->base_handle(), buf->dtype(), buf->dims()));
+    b->append_stmt(new Free(buf->base_handle()));
+  }
+
   // Now insert allocations and frees for temporary buffers. Do that in the
   // innermost possible scope.
   std::unordered_map<const Buf*, std::vector<BufUse>> uses = findUses(stmt);
@@ -1186,6 +1193,10 @@ void LoopNest::setGPUThreadIndex(For* f, int thread_index) {
   f->set_gpu_thread_index(thread_index);
 }
 
+void LoopNest::parallelize(For* f) {
+  f->set_parallel();
+}
+
 Stmt* LoopNest::getLoopBodyFor(Tensor* t) const {
   return tensor_to_stmt_.at(t);
 }
@@ -1708,7 +1719,7 @@ void LoopNest::rfactor(
         "Hit undefined behavior in rfactor -- couldn't infer bounds.");
   }
 
-  temp_bufs_.emplace_back(tmp_buf);
+  rfactor_bufs_.emplace_back(tmp_buf);
 }
 
 } // namespace tensorexpr
@@ -42,6 +42,9 @@ class TORCH_API LoopNest {
 
   void setGPUBlockIndex(For* f, int idx);
   void setGPUThreadIndex(For* f, int idx);
+  // Runs the iterations of `f` concurrently on the intra-op thread pool. They
+  // must be independent of each other.
+  void parallelize(For* f);
 
   // Insert a temporary computation of statement S in the scope of loop AT.
   // S is assumed to be a Store or a Block containing a Store. Along with the
@@ -68,6 +71,10 @@ class TORCH_API LoopNest {
   std::unordered_set<Tensor*> output_tensors_;
   std::unordered_set<Tensor*> intermediate_tensors_;
   std::vector<const Buf*> temp_bufs_;
+  // The buffers of the partial results of rfactor'ed reductions. They are
+  // indexed by all the output axes of their reduction, so they are allocated
+  // once, at the global level, rather than in the loops that use them.
+  std::vector<const Buf*> rfactor_bufs_;
   // Holds the initializer Expr of buffers that have been initialized.
   std::unordered_map<const Buf*, const Expr*> buf_initializers_;
 };
@@ -129,6 +129,90 @@ def fuser(name):
         torch._C._jit_set_texpr_fuser_enabled(old_texpr_fuser_state)
         torch._C._jit_set_nvfuser_enabled(old_nvfuser_state)
 
+@contextlib.contextmanager
+def lazy_eager():
+    """
+    A context manager that defers the pointwise ops (``add``, ``sub``, ``mul``,
+    ``div``, ``neg``, ``relu``, ``sigmoid``, ``tanh``, ``exp`` and ``log``) of
+    eager code on float CPU tensors that don't require grad, so that each chain
+    of them runs as a single fused kernel, compiled once per shape and dtype.
+
+    The deferred results are computed the first time their data is read, or
+    when leaving the context manager. Modifying a tensor in place while a
+    deferred op still needs its value raises an error.
+
+    Example::
+
+        with torch.jit.lazy_eager():
+            y = (x * a + b).relu()  # one pass over memory
+    """
+    torch._C._jit_lazy_eager_enter()
+    try:
+        yield
+    finally:
+        torch._C._jit_lazy_eager_exit()
+
+def warm_up_kernel_cache(f, example_inputs, map_location=None):
+    r"""
+    Compiles the fusion kernels that running the model saved in ``f`` on
+    ``example_inputs`` needs, so that they are stored in the on-disk kernel
+    cache and the processes that use the same cache directory don't have to
+    compile them again.
+
+    The cache directory is set with the ``PYTORCH_KERNEL_CACHE_DIR``
+    environment variable, or with ``torch._C._jit_kernel_cache_set_dir``.
+    Kernels are specialized on the shapes of their inputs, so call this once
+    per input shape the model is served with.
+
+    Arguments:
+        f: a file-like object or a string containing a file name, as taken by
+           :func:`torch.jit.load`.
+        example_inputs (tuple): the inputs of the model's ``forward``.
+        map_location: as taken by :func:`torch.jit.load`.
+
+    Returns:
+        The number of kernels compiled and stored in the cache.
+    """
+    if not torch._C._jit_kernel_cache_enabled():
+        raise RuntimeError("The kernel cache is disabled, set PYTORCH_KERNEL_CACHE_DIR "
+                           "to the directory to cache the kernels in")
+    model = load(f, map_location=map_location)
+    if not isinstance(example_inputs, tuple):
+        example_inputs = (example_inputs,)
+    stores = torch._C._jit_kernel_cache_stats()["stores"]
+    # the profiling executor only compiles the graph once it has been profiled
+    num_profiled_runs = torch._C._jit_set_num_profiled_runs(1)
+    torch._C._jit_set_num_profiled_runs(num_profiled_runs)
+    with torch.no_grad():
+        for _ in range(num_profiled_runs + 1):
+            model(*example_inputs)
+    return torch._C._jit_kernel_cache_stats()["stores"] - stores
+
+def precompile(fn, example_inputs):
+    r"""
+    Compiles the execution plans of a scripted function or module for a list of
+    input signatures ahead of time, so that the first calls with them don't
+    pay for the optimization of the graph.
+
+    The plans are specialized on the types, shapes and ``requires_grad`` of the
+    inputs, and on whether grad mode is enabled, so call this in the same grad
+    mode as the calls it prepares for. Only the legacy executor compiles its
+    plans here; the profiling executor only builds its profiling plan, as it
+    specializes on the runs it records.
+
+    Arguments:
+        fn: a :class:`ScriptModule` (whose ``forward`` is compiled) or a
+            scripted function.
+        example_inputs (list of tuples): the inputs of each signature.
+    """
+    if isinstance(fn, ScriptModule):
+        fn = fn._c
+    elif not isinstance(fn, torch._C.ScriptFunction):
+        raise RuntimeError("precompile expects a ScriptModule or a scripted function, "
+                           "got {}".format(type(fn)))
+    fn._precompile([inputs if isinstance(inputs, tuple) else (inputs,)
+                    for inputs in example_inputs])
+
 DEFAULT_EXTRA_FILES_MAP = torch._C.ExtraFilesMap()
 
 
@@ -53,6 +53,50 @@ def vector_to_parameters(vec, parameters):
         pointer += num_param
 
 
+def allocate_grad_arena(parameters):
+    r"""Preallocates the gradients of parameters in contiguous buffers
+
+    Allocates one zero-initialized buffer per device and dtype, and sets the
+    ``.grad`` of each parameter that requires grad to a view of it, keeping
+    the value of gradients that are already defined. Backward then accumulates
+    gradients in place into these views rather than allocating them, and the
+    buffers can be used to operate on all gradients at once (e.g. to all-reduce
+    them).
+
+    .. note::
+        Accumulation happens in place only when the backward is not
+        differentiated (``create_graph=False``). Optimizers' ``zero_grad``
+        keeps the views, but assigning to ``.grad`` replaces them.
+
+    Arguments:
+        parameters (Iterable[Tensor]): an iterator of Tensors that are the
+            parameters of a model. Parameters with sparse gradients are
+            skipped.
+
+    Returns:
+        The list of buffers, one per device and dtype
+    """
+    groups = {}
+    for param in parameters:
+        if not param.requires_grad or (param.grad is not None and param.grad.is_sparse):
+            continue
+        groups.setdefault((param.device, param.dtype), []).append(param)
+
+    arenas = []
+    for (device, dtype), params in groups.items():
+        arena = torch.zeros(sum(p.numel() for p in params), dtype=dtype, device=device)
+        # Pointer for slicing the arena for each parameter
+        pointer = 0
+        for param in params:
+            grad = arena[pointer:pointer + param.numel()].view_as(param)
+            if param.grad is not None:
+                grad.copy_(param.grad)
+            param.grad = grad
+            pointer += param.numel()
+        arenas.append(arena)
+    return arenas
+
+
 def _check_param_device(param, old_param_device):
     r"""This helper function is to check if the parameters are located
     in the same device. Currently, the conversion between model parameters